@@ -0,0 +1,115 @@
+/********************************************************************************************
+ * File: analytic.hpp                                                                       *
+ *                                                                                          *
+ * Description:                                                                             *
+ *  Contains the analytic fast-path estimator of the Helium-3 Mining Simulator. Instead of  *
+ *  running the tick loop, the fleet is modeled as a closed queueing network and the        *
+ *  fraction of time spent in each category is predicted directly.                          *
+ *                                                                                          *
+ * Changes:                                                                                 *
+ *  10/16/2026 - Created                                                                    *
+ *                                                                                          *
+ ********************************************************************************************/
+#ifndef ANALYTIC_HPP
+#define ANALYTIC_HPP
+
+/********************************************************************************************
+ * Includes                                                                                 *
+ ********************************************************************************************/
+#ifndef MAIN_HPP
+#include "../include/main.hpp"
+#endif
+
+/********************************************************************************************
+ * Enumerations/Classes                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * ApproximationError                                                                       *
+ * @brief Result of comparing the analytic estimate against a full simulation of the same   *
+ *        configuration.                                                                    *
+ ********************************************************************************************/
+struct ApproximationError {
+
+    /* Predicted and simulated fraction of time spent in each category                      */
+    StateFractions estimate;
+    StateFractions simulated;
+
+    /* Largest absolute difference between the two across the four categories               */
+    double max_error;
+
+    /* Wall clock time taken by the estimate and by the simulation in microseconds          */
+    double estimate_us;
+    double simulation_us;
+};
+
+/********************************************************************************************
+ * Analytic Functions                                                                       *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * estimate_state_fractions                                                                 *
+ * @brief Predicts the fraction of time the fleet spends in each category without running   *
+ *        the simulation.                                                                   *
+ *                                                                                          *
+ * The site is modeled as a closed queueing network with `num_trucks` customers and two     *
+ * kinds of nodes:                                                                          *
+ * - A delay node covering mining and both legs of travel. Every truck spends               *
+ *   `mean_mining_time + 2 * site.travel_time` ticks there per cycle, with no queueing.     *
+ * - `num_stations` identical single server queues with a service time of one tick (the     *
+ *   unloading step). Round-robin assignment gives each station a visit ratio of            *
+ *   1 / `num_stations`.                                                                    *
+ *                                                                                          *
+ * The network is solved with Mean Value Analysis, which adds trucks one at a time and      *
+ * uses the arrival theorem: a truck arriving at a station sees the queue the network       *
+ * would have with one truck fewer. Since unloading takes exactly one tick rather than an   *
+ * exponential time, the truck being unloaded only contributes half a tick of residual      *
+ * service on average, which is subtracted from the queue seen on arrival. Each step is     *
+ * O(1) since all stations are identical, so the whole estimate is O(num_trucks) with no    *
+ * allocation: microseconds for typical fleets, about a millisecond at 65535 trucks.        *
+ *                                                                                          *
+ * Round-robin assignment spreads arrivals more evenly than the model assumes, so the       *
+ * waiting fraction is an upper estimate that is least accurate near the point where the    *
+ * stations saturate. Use `compare_estimate_to_simulation` to measure the error for a       *
+ * given configuration.                                                                     *
+ *                                                                                          *
+ * @param num_trucks: The number of trucks in the fleet.                                    *
+ * @param num_stations: The number of unloading stations.                                   *
+ * @param mean_mining_time: The expected mining time in ticks.                              *
+ * @param site: Optional site the fleet works at, defaults to the standard site.            *
+ * @return: StateFractions - The predicted fraction of time spent in each category.         *
+ ********************************************************************************************/
+StateFractions estimate_state_fractions(uint32_t num_trucks,
+                                        uint32_t num_stations,
+                                        double mean_mining_time,
+                                        const SiteConfig& site = STANDARD_SITE);
+
+/********************************************************************************************
+ * compare_estimate_to_simulation                                                           *
+ * @brief Runs both the analytic estimate and a full simulation of one configuration and    *
+ *        reports the approximation error.                                                  *
+ *                                                                                          *
+ * @param num_trucks: The number of trucks in the fleet.                                    *
+ * @param num_stations: The number of unloading stations.                                   *
+ * @param mining_time: The mining time distribution shared by both models.                  *
+ * @param seed: The seed of the simulation's random number generator.                       *
+ * @param site: Optional site both models run at, defaults to the standard site.            *
+ * @return: ApproximationError - Both sets of fractions, their largest absolute             *
+ *          difference and the time each model took.                                        *
+ ********************************************************************************************/
+ApproximationError compare_estimate_to_simulation(uint16_t num_trucks,
+                                                  uint16_t num_stations,
+                                                  MiningTimeDistribution mining_time,
+                                                  uint32_t seed,
+                                                  const SiteConfig& site = STANDARD_SITE);
+
+/********************************************************************************************
+ * log_approximation_error                                                                  *
+ * @brief Outputs the result of `compare_estimate_to_simulation` to the console.            *
+ *                                                                                          *
+ * @param error: The comparison to print.                                                   *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+void log_approximation_error(const ApproximationError& error);
+
+#endif // ANALYTIC_HPP
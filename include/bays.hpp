@@ -0,0 +1,605 @@
+/********************************************************************************************
+ * File: bays.hpp                                                                           *
+ *                                                                                          *
+ * Description:                                                                             *
+ *  Contains the multi-bay stations of the Helium-3 Mining Simulator. A station of the      *
+ *  single-bay model unloads one truck per tick, so a truck's wait is the queue it finds.   *
+ *  Here every station has its own number of bays and a range of unload times, and the      *
+ *  trucks that find every bay taken wait in a first-in first-out queue of truck indices    *
+ *  until a bay frees up. Joining and leaving a station are O(1), and the queues are        *
+ *  chained through one link per truck, so the tick loop allocates nothing.                 *
+ *                                                                                          *
+ * Changes:                                                                                 *
+ *  10/17/2026 - Created                                                                    *
+ *                                                                                          *
+ ********************************************************************************************/
+#ifndef BAYS_HPP
+#define BAYS_HPP
+
+/********************************************************************************************
+ * Includes                                                                                 *
+ ********************************************************************************************/
+#include <bit>
+#include <vector>
+
+#ifndef MAIN_HPP
+#include "../include/main.hpp"
+#endif
+
+/********************************************************************************************
+ * Enumerations/Classes                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * BayConfig                                                                                *
+ * @brief Bays of one station and the range its unload times are drawn from, in ticks.      *
+ ********************************************************************************************/
+struct BayConfig {
+    uint16_t bays;
+    uint16_t min_unload;
+    uint16_t max_unload;
+};
+
+/********************************************************************************************
+ * TruckQueue                                                                               *
+ * @brief First-in first-out queue of truck indices, linked through an array shared by      *
+ *        every station.                                                                    *
+ *                                                                                          *
+ * A truck waits at one station at a time, so one link per truck, the truck queued behind   *
+ * it, chains every station's queue and the queue itself only keeps its front, its back     *
+ * and its length. Joining and leaving are O(1), all the queues of a simulation take        *
+ * O(trucks + stations) memory however long any one line gets, and nothing is allocated     *
+ * once the links are.                                                                      *
+ ********************************************************************************************/
+class TruckQueue {
+public:
+    /****************************************************************************************
+     * TruckQueue Constructor                                                               *
+     * @brief Initializes an empty queue.                                                   *
+     *                                                                                      *
+     * @param links: The links of every truck, one per truck of the simulation, which has   *
+     *               to outlive the queue.                                                  *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    explicit TruckQueue(uint16_t* links);
+
+    /****************************************************************************************
+     * push                                                                                 *
+     * @brief Adds a truck to the back of the queue.                                        *
+     *                                                                                      *
+     * @param truck_idx: The index of the truck, not queued anywhere else.                  *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void push(uint16_t truck_idx);
+
+    /****************************************************************************************
+     * pop                                                                                  *
+     * @brief Removes the truck at the front of the queue.                                  *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: uint16_t - The index of the truck, the queue must not be empty.             *
+     ****************************************************************************************/
+    uint16_t pop();
+
+    /****************************************************************************************
+     * size                                                                                 *
+     * @brief Retrieves the number of trucks in the queue.                                  *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: size_t - The number of trucks.                                              *
+     ****************************************************************************************/
+    size_t size() const;
+
+private:
+    /* Truck queued behind each truck, shared by every queue of the simulation              */
+    uint16_t* links;
+
+    /* Trucks at the front and at the back, only meaningful while the queue is not empty    */
+    uint16_t head;
+    uint16_t tail;
+
+    /* Number of trucks queued                                                              */
+    uint32_t count;
+};
+
+/********************************************************************************************
+ * BayStation                                                                               *
+ * @brief A station with several bays, each unloading one truck at a time, and a queue of   *
+ *        the trucks waiting for one.                                                       *
+ ********************************************************************************************/
+class BayStation {
+public:
+    /****************************************************************************************
+     * BayStation Constructor                                                               *
+     * @brief Initializes a station with every bay free and nobody waiting.                 *
+     *                                                                                      *
+     * @param config: The bays and the unload times of the station.                         *
+     * @param links: The links the station's queue is chained through, see `TruckQueue`.    *
+     * @return: None                                                                        *
+     * @throws: std::invalid_argument if there are no bays or the unload times are empty    *
+     *          or contain zero.                                                            *
+     ****************************************************************************************/
+    BayStation(const BayConfig& config, uint16_t* links);
+
+    /****************************************************************************************
+     * arrive                                                                               *
+     * @brief Takes a free bay for an arriving truck, or queues it if there is none.        *
+     *                                                                                      *
+     * @param truck_idx: The index of the truck.                                            *
+     * @return: bool - Whether the truck got a bay.                                         *
+     ****************************************************************************************/
+    bool arrive(uint16_t truck_idx);
+
+    /****************************************************************************************
+     * release                                                                              *
+     * @brief Frees the bay of a truck that has finished unloading, and hands it straight   *
+     *        to the truck at the front of the queue, if any.                               *
+     *                                                                                      *
+     * @param next: Receives the truck that got the bay.                                    *
+     * @return: bool - Whether a waiting truck got the bay.                                 *
+     ****************************************************************************************/
+    bool release(uint16_t& next);
+
+    /****************************************************************************************
+     * hold                                                                                 *
+     * @brief Queues an arriving truck without giving it a bay, even if one is free.        *
+     *                                                                                      *
+     * @param truck_idx: The index of the truck.                                            *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void hold(uint16_t truck_idx);
+
+    /****************************************************************************************
+     * free_bay                                                                             *
+     * @brief Frees the bay of a truck that has finished unloading, leaving the queue as    *
+     *        it is.                                                                        *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void free_bay();
+
+    /****************************************************************************************
+     * admit                                                                                *
+     * @brief Gives a free bay to the truck at the front of the queue.                      *
+     *                                                                                      *
+     * @param next: Receives the truck that got the bay.                                    *
+     * @return: bool - Whether there was both a free bay and a truck waiting for it.        *
+     ****************************************************************************************/
+    bool admit(uint16_t& next);
+
+    /****************************************************************************************
+     * evict                                                                                *
+     * @brief Removes the truck at the front of the queue without giving it a bay.          *
+     *                                                                                      *
+     * @param truck_idx: Receives the truck removed.                                        *
+     * @return: bool - Whether there was a truck waiting.                                   *
+     ****************************************************************************************/
+    bool evict(uint16_t& truck_idx);
+
+    /****************************************************************************************
+     * draw_unload_time                                                                     *
+     * @brief Draws the ticks a truck takes to unload at the station.                       *
+     *                                                                                      *
+     * A station with a single unload time draws nothing from the generator.                *
+     *                                                                                      *
+     * @param gen: The random number generator owned by the simulation.                     *
+     * @return: uint16_t - The unload time, between the station's shortest and longest.     *
+     ****************************************************************************************/
+    uint16_t draw_unload_time(std::mt19937& gen);
+
+    /****************************************************************************************
+     * get_queue                                                                            *
+     * @brief Retrieves the number of trucks waiting for a bay.                             *
+     *                                                                                      *
+     * Takes the tick like `Station::get_queue`, so the selection policies that look at     *
+     * the queues work on either kind of station.                                           *
+     *                                                                                      *
+     * @param tick: The number of ticks the simulation has run, unused.                     *
+     * @return: uint16_t - The number of trucks waiting.                                    *
+     ****************************************************************************************/
+    uint16_t get_queue(uint32_t tick);
+
+    /****************************************************************************************
+     * get_busy_bays                                                                        *
+     * @brief Retrieves the number of bays unloading a truck.                               *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: uint16_t - The number of busy bays.                                         *
+     ****************************************************************************************/
+    uint16_t get_busy_bays();
+
+    /****************************************************************************************
+     * increment_trucks_unloaded                                                            *
+     * @brief Counts another truck unloaded at the station.                                 *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void increment_trucks_unloaded();
+
+    /****************************************************************************************
+     * get_trucks_unloaded                                                                  *
+     * @brief Retrieves the count of trucks that have been unloaded at the station.         *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: uint16_t - The number of trucks unloaded.                                   *
+     ****************************************************************************************/
+    uint16_t get_trucks_unloaded();
+
+    /****************************************************************************************
+     * logging                                                                              *
+     * @brief Outputs the number of trucks unloaded at the station to the console.          *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void logging();
+
+private:
+    /* Trucks waiting for a bay, in the order they arrived                                  */
+    TruckQueue queue;
+
+    /* Number of bays, and how many of them are unloading a truck                           */
+    uint16_t bays;
+    uint16_t busy;
+
+    /* Range of the unload times, in ticks                                                  */
+    uint16_t min_unload;
+    uint16_t max_unload;
+
+    uint16_t num_trucks_unloaded;
+};
+
+/********************************************************************************************
+ * NoOutages                                                                                *
+ * @brief Outage policy of the bay tick loop, every station is always up.                   *
+ *                                                                                          *
+ * The tick loop of `BaySimulation` takes the outages as a policy, like the checks, so      *
+ * `OutageSimulation` runs the same loop and a simulation without outages compiles its      *
+ * availability checks to nothing.                                                          *
+ ********************************************************************************************/
+struct NoOutages {
+
+    /****************************************************************************************
+     * apply_outages                                                                        *
+     * @brief Skips starting and ending outages, there are none.                            *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void apply_outages();
+
+    /****************************************************************************************
+     * choose_station                                                                       *
+     * @brief Picks the station an arriving truck goes to with the selection policy alone.  *
+     *                                                                                      *
+     * @param selector: The active station selection policy.                                *
+     * @param stations: The stations of the simulation.                                     *
+     * @param tick: The number of ticks the simulation has run.                             *
+     * @return: size_t - The index of the station.                                          *
+     ****************************************************************************************/
+    template<typename Selector>
+    size_t choose_station(Selector& selector, std::pmr::vector<BayStation>& stations,
+                          uint32_t tick);
+
+    /****************************************************************************************
+     * is_up                                                                                *
+     * @brief Checks whether a station is up, which every station always is.                *
+     *                                                                                      *
+     * @param station_idx: The index of the station.                                        *
+     * @return: bool - Always true.                                                         *
+     ****************************************************************************************/
+    bool is_up(size_t station_idx) const;
+};
+
+/********************************************************************************************
+ * BaySimulation                                                                            *
+ * @brief Runs a fleet at a single site whose stations have several bays and variable       *
+ *        unload times.                                                                     *
+ *                                                                                          *
+ * A truck arriving at a station takes a free bay, or joins the back of the station's       *
+ * queue and waits, without a timer, for one. A truck that finishes unloading frees its     *
+ * bay at the end of the tick, and the truck at the front of the queue starts unloading in  *
+ * the next one, so the trucks are served first come first served whatever their index.     *
+ * With a single bay and a one tick unload at every station this is exactly the station     *
+ * of `Simulation`.                                                                         *
+ *                                                                                          *
+ * The stations are picked with the round robin or the power of two choices policy. The     *
+ * shortest queue and wait policies mirror single-bay queues and are not supported.         *
+ ********************************************************************************************/
+class BaySimulation {
+public:
+    /****************************************************************************************
+     * BaySimulation Constructor                                                            *
+     * @brief Initializes a simulation of the given fleet and stations, with every truck    *
+     *        mining.                                                                       *
+     *                                                                                      *
+     * The queues of every station are chained through one link per truck, allocated        *
+     * here, so no line is ever too long and the queues never allocate.                     *
+     *                                                                                      *
+     * @param num_trucks: The number of trucks to be simulated.                             *
+     * @param configs: The bays and unload times of every station.                          *
+     * @param debug: Optional parameter that enables debug mode if set to true.             *
+     * @param mining_time: Optional distribution of mining times, defaults to the uniform   *
+     *                     distribution between the site's mining time bounds.              *
+     * @param seed: Optional seed of the simulation's random number generator.              *
+     * @param memory: Optional resource the trucks, stations and queues are stored in.      *
+     * @param site: Optional site the simulation runs at, defaults to the standard site.    *
+     * @param selection: Optional station selection policy, defaults to round robin.        *
+     * @return: None                                                                        *
+     * @throws: std::invalid_argument if there are no stations, a station is invalid or     *
+     *          the selection policy mirrors the queues.                                    *
+     ****************************************************************************************/
+    BaySimulation(uint16_t num_trucks,
+                  const std::vector<BayConfig>& configs,
+                  bool debug = false,
+                  std::optional<MiningTimeDistribution> mining_time = std::nullopt,
+                  uint32_t seed = std::random_device{}(),
+                  std::pmr::memory_resource* memory = std::pmr::get_default_resource(),
+                  const SiteConfig& site = STANDARD_SITE,
+                  SelectionPolicy selection = SelectionPolicy::RoundRobin);
+
+    /* The stations' queues point into the links of this simulation                        */
+    BaySimulation(const BaySimulation&) = delete;
+    BaySimulation& operator=(const BaySimulation&) = delete;
+
+    /****************************************************************************************
+     * simulate                                                                             *
+     * @brief Runs the tick loop for `total_time` ticks.                                    *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void simulate();
+
+    /****************************************************************************************
+     * simulate                                                                             *
+     * @brief Runs the tick loop until the observer stops it.                               *
+     *                                                                                      *
+     * @param observer: The tick loop observer, see `Simulation::simulate`.                 *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename Observer>
+    void simulate(Observer& observer);
+
+    /****************************************************************************************
+     * logging                                                                              *
+     * @brief Outputs the statistics of every truck and station to the console.             *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void logging();
+
+    /****************************************************************************************
+     * get_state_fractions                                                                  *
+     * @brief Computes the fraction of time the fleet spent in each category.               *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: StateFractions - The fleet-wide fraction of time spent in each category.    *
+     ****************************************************************************************/
+    StateFractions get_state_fractions();
+
+    /* Store the total execution time of the simulation                                     */
+    uint16_t total_time;
+
+    /* Flag to determine whether to run additional consistency checks during the simulation */
+    bool debug;
+
+    /* list of stations                                                                     */
+    std::pmr::vector<BayStation> stations;
+
+    /* list of trucks                                                                       */
+    std::pmr::vector<Truck> trucks;
+
+    /* Policy that sends the arriving trucks to the stations                                */
+    StationSelector selector;
+
+    /* Distribution the trucks draw their mining times from                                 */
+    MiningTimeDistribution mining_time;
+
+    /* Mersenne Twister pseudorandom number generator used for every draw                   */
+    std::mt19937 gen;
+
+    /* Site the simulation runs at, and the truck state machine built from it               */
+    SiteConfig site;
+    TruckTransitionTable transitions;
+
+    /* Number of ticks run since the simulation was set up                                  */
+    uint32_t tick;
+
+protected:
+    /****************************************************************************************
+     * run_engine                                                                           *
+     * @brief Runs the tick loop with the mining time distribution, the selection policy,   *
+     *        the observer and the outages fixed at compile time.                           *
+     *                                                                                      *
+     * @param mining_time: The active mining time distribution policy.                      *
+     * @param selector: The active station selection policy.                                *
+     * @param observer: The tick loop observer.                                             *
+     * @param outages: The outage policy, `NoOutages` or an `OutageSimulation`.             *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename MiningTime, typename Selector, typename Observer, typename Outages>
+    void run_engine(MiningTime& mining_time, Selector& selector, Observer& observer,
+                    Outages& outages);
+
+    /* Stations a truck finished unloading at this tick, one entry per freed bay            */
+    std::pmr::vector<uint16_t> released;
+
+    /* Truck queued behind each waiting truck, the links of every station's queue          */
+    std::pmr::vector<uint16_t> links;
+};
+
+/********************************************************************************************
+ * Bay Functions                                                                            *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * make_bay_transitions                                                                     *
+ * @brief Builds the truck state machine of a site with multi-bay stations.                 *
+ *                                                                                          *
+ * A waiting truck does not count down, the station starts it unloading once a bay is       *
+ * free, and unloading counts down the unload time the station drew.                        *
+ *                                                                                          *
+ * @param site: The site whose travel time the trucks take.                                 *
+ * @return: TruckTransitionTable - The transition of each state.                            *
+ ********************************************************************************************/
+constexpr TruckTransitionTable make_bay_transitions(const SiteConfig& site) {
+
+    TruckTransitionTable table = make_truck_transitions(site);
+
+    table[static_cast<size_t>(TruckState::Waiting)] =
+        {WAITING_INC, 0, 0, TruckState::Waiting, TruckEvent::None};
+
+    table[static_cast<size_t>(TruckState::Unloading)] =
+        {UNLOADING_INC, 1, site.travel_time, TruckState::TravelMining, TruckEvent::Unload};
+
+    return table;
+}
+
+/********************************************************************************************
+ * Template (and Inline) Definitions                                                        *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * NoOutages::apply_outages                                                                 *
+ * @brief Skips starting and ending outages, there are none.                                *
+ *                                                                                          *
+ * @param: None                                                                             *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+inline void NoOutages::apply_outages() {}
+
+/********************************************************************************************
+ * NoOutages::choose_station                                                                *
+ * @brief Picks the station an arriving truck goes to with the selection policy alone.      *
+ *                                                                                          *
+ * @param selector: The active station selection policy.                                    *
+ * @param stations: The stations of the simulation.                                         *
+ * @param tick: The number of ticks the simulation has run.                                 *
+ * @return: size_t - The index of the station.                                              *
+ ********************************************************************************************/
+template<typename Selector>
+size_t NoOutages::choose_station(Selector& selector, std::pmr::vector<BayStation>& stations,
+                                 uint32_t tick) {
+    return selector.select(stations, tick);
+}
+
+/********************************************************************************************
+ * NoOutages::is_up                                                                         *
+ * @brief Checks whether a station is up, which every station always is.                    *
+ *                                                                                          *
+ * @param station_idx: The index of the station.                                            *
+ * @return: bool - Always true.                                                             *
+ ********************************************************************************************/
+inline bool NoOutages::is_up(size_t) const {
+    return true;
+}
+
+/********************************************************************************************
+ * BaySimulation::simulate                                                                  *
+ * @brief Runs the tick loop until the observer stops it.                                   *
+ *                                                                                          *
+ * @param observer: The tick loop observer, see `Simulation::simulate`.                     *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename Observer>
+void BaySimulation::simulate(Observer& observer) {
+
+    NoOutages outages;
+
+    /* Select the distribution and the selection policy once, outside of the tick loop      */
+    std::visit([this, &observer, &outages](auto& dist, auto& selector) {
+        this->run_engine(dist, selector, observer, outages);
+    }, this->mining_time, this->selector);
+}
+
+/********************************************************************************************
+ * BaySimulation::run_engine                                                                *
+ * @brief Runs the tick loop with the mining time distribution, the selection policy, the   *
+ *        observer and the outages fixed at compile time.                                   *
+ *                                                                                          *
+ * Each truck runs its own part of the tick through the multi-bay state machine and the     *
+ * event it raised is applied to the stations here. The bays freed during the tick are      *
+ * handed on once every truck has run, so a truck further down the fleet does not start     *
+ * unloading in the tick the bay was still in use.                                          *
+ *                                                                                          *
+ * The outages due at a tick are applied before the trucks run. A station that is down      *
+ * takes no arriving truck and hands no freed bay on.                                       *
+ *                                                                                          *
+ * @param mining_time: The active mining time distribution policy.                          *
+ * @param selector: The active station selection policy.                                    *
+ * @param observer: The tick loop observer.                                                 *
+ * @param outages: The outage policy, `NoOutages` or an `OutageSimulation`.                 *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename MiningTime, typename Selector, typename Observer, typename Outages>
+void BaySimulation::run_engine(MiningTime& mining_time, Selector& selector,
+                               Observer& observer, Outages& outages) {
+
+    /* Each iteration is one tick, the observer decides when the simulation ends            */
+    while(observer.next_tick()) {
+
+        outages.apply_outages();
+
+        for(size_t i = 0; i < this->trucks.size(); i++) {
+
+            Truck& truck = this->trucks[i];
+
+            observer.observe(truck);
+
+            TruckEvent event = truck.run_local(this->transitions);
+
+            if(TruckEvent::Arrive == event) {
+
+                size_t station_idx = outages.choose_station(selector, this->stations,
+                                                            this->tick);
+                BayStation& station = this->stations[station_idx];
+
+                /* Only happens with every station down, wait for this one to come up       */
+                if(!outages.is_up(station_idx)) {
+                    station.hold(static_cast<uint16_t>(i));
+                    truck.wait_for_bay(station_idx);
+                }
+                else if(station.arrive(static_cast<uint16_t>(i))) {
+                    truck.start_unloading(station_idx, station.draw_unload_time(this->gen));
+                }
+                else {
+                    truck.wait_for_bay(station_idx);
+                }
+            }
+            else if(TruckEvent::Unload == event) {
+
+                size_t station_idx = truck.get_station_idx();
+
+                this->stations[station_idx].increment_trucks_unloaded();
+                this->released.push_back(static_cast<uint16_t>(station_idx));
+            }
+            else if(TruckEvent::Draw == event) {
+                truck.start_mining(mining_time(this->gen));
+            }
+        }
+
+        /* Hand the freed bays to the front of their queues, unless the station is down     */
+        for(uint16_t station_idx : this->released) {
+
+            BayStation& station = this->stations[station_idx];
+            uint16_t next;
+
+            if(!outages.is_up(station_idx)) {
+                station.free_bay();
+            }
+            else if(station.release(next)) {
+                this->trucks[next].start_unloading(station_idx,
+                                                   station.draw_unload_time(this->gen));
+            }
+        }
+        this->released.clear();
+
+        this->tick++;
+    }
+}
+
+#endif // BAYS_HPP
@@ -0,0 +1,401 @@
+/********************************************************************************************
+ * File: blocking.hpp                                                                       *
+ *                                                                                          *
+ * Description:                                                                             *
+ *  Contains the temporally blocked tick loop of the Helium-3 Mining Simulator. Instead of  *
+ *  running every truck for one tick before moving on to the next tick, the loop takes      *
+ *  each truck through a window of ticks at once, up to the tick the truck next needs       *
+ *  something it shares with the other trucks. A truck is then loaded into the cache once   *
+ *  per window rather than once per tick, and the results are identical to the serial       *
+ *  tick loop.                                                                              *
+ *                                                                                          *
+ *  Building with HAVE_PERF_EVENTS defined (Linux only) lets the benchmark count the cache  *
+ *  misses of both tick loops with the hardware counters. Without it, or when the counters  *
+ *  cannot be opened, only the throughput is reported.                                      *
+ *                                                                                          *
+ * Changes:                                                                                 *
+ *  10/17/2026 - Created                                                                    *
+ *                                                                                          *
+ ********************************************************************************************/
+#ifndef BLOCKING_HPP
+#define BLOCKING_HPP
+
+/********************************************************************************************
+ * Includes                                                                                 *
+ ********************************************************************************************/
+#include <vector>
+
+#ifndef MAIN_HPP
+#include "../include/main.hpp"
+#endif
+
+/********************************************************************************************
+ * Defines/Macros                                                                           *
+ ********************************************************************************************/
+#define BLOCK_TICKS             64u     /*Most ticks one window of the blocked loop covers  */
+
+/********************************************************************************************
+ * Enumerations/Classes                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * PendingEvent                                                                             *
+ * @brief A truck that raised an event in a tick of the current window, and the event.      *
+ ********************************************************************************************/
+struct PendingEvent {
+    uint32_t truck_idx;
+    TruckEvent event;
+};
+
+/********************************************************************************************
+ * CacheMisses                                                                              *
+ * @brief Cache misses counted over a stretch of code.                                      *
+ *                                                                                          *
+ * The generic hardware events have no L2 miss counter, so misses that leave L2 are counted *
+ * as references to the last level cache, which is the cache behind L2 on current CPUs.     *
+ ********************************************************************************************/
+struct CacheMisses {
+
+    /* Loads that missed the L1 data cache                                                  */
+    uint64_t l1;
+
+    /* Loads that missed L2, counted as references to the last level cache                  */
+    uint64_t l2;
+};
+
+/********************************************************************************************
+ * CacheMissCounter                                                                         *
+ * @brief Counts the cache misses of the calling thread between `start` and `stop`.         *
+ *                                                                                          *
+ * Opens the hardware counters with perf_event_open when built with HAVE_PERF_EVENTS.       *
+ * Virtual machines and restricted kernels often do not expose them, in which case, like    *
+ * without HAVE_PERF_EVENTS, the counter reports that it is unavailable and counts nothing. *
+ ********************************************************************************************/
+class CacheMissCounter {
+public:
+    /****************************************************************************************
+     * CacheMissCounter Constructor                                                         *
+     * @brief Opens the counters of the calling thread, stopped.                            *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    CacheMissCounter();
+
+    /****************************************************************************************
+     * CacheMissCounter Destructor                                                          *
+     * @brief Closes the counters.                                                          *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    ~CacheMissCounter();
+
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    /****************************************************************************************
+     * is_available                                                                         *
+     * @brief Retrieves whether the hardware counters could be opened.                      *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: bool - True if `stop` reports real counts.                                  *
+     ****************************************************************************************/
+    bool is_available() const;
+
+    /****************************************************************************************
+     * start                                                                                *
+     * @brief Clears the counters and starts counting.                                      *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void start();
+
+    /****************************************************************************************
+     * stop                                                                                 *
+     * @brief Stops counting and reads the counters.                                        *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: CacheMisses - The misses since `start`, all zero if unavailable.            *
+     ****************************************************************************************/
+    CacheMisses stop();
+
+private:
+    /* File descriptors of the L1 and L2 miss counters, -1 if not open                      */
+    int l1_fd;
+    int l2_fd;
+};
+
+/********************************************************************************************
+ * EngineMetrics                                                                            *
+ * @brief Cost of one tick loop, as measured by `benchmark_blocking`.                       *
+ ********************************************************************************************/
+struct EngineMetrics {
+
+    /* Truck updates (trucks times ticks) per second                                        */
+    double update_rate;
+
+    /* Cache misses per truck update, zero if the counters are unavailable                  */
+    double l1_misses;
+    double l2_misses;
+};
+
+/********************************************************************************************
+ * BlockingReport                                                                           *
+ * @brief Result of `benchmark_blocking`, the serial and blocked tick loops side by side.   *
+ ********************************************************************************************/
+struct BlockingReport {
+
+    /* Size of the simulations run                                                          */
+    uint16_t num_trucks;
+    uint16_t num_stations;
+
+    /* Whether the cache misses were counted, see `CacheMissCounter`                        */
+    bool counted;
+
+    EngineMetrics serial;
+    EngineMetrics blocked;
+};
+
+/********************************************************************************************
+ * Blocking Functions                                                                       *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * simulate_blocked                                                                         *
+ * @brief Runs the tick loop of a simulation for its fixed horizon in windows of ticks.     *
+ *                                                                                          *
+ * This is the blocked counterpart of `Simulation::simulate`, including the warm-up, and    *
+ * produces exactly the same results for the same seed.                                     *
+ *                                                                                          *
+ * @param sim: The simulation to run.                                                       *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if a debug check fails.                                      *
+ ********************************************************************************************/
+void simulate_blocked(Simulation& sim);
+
+/********************************************************************************************
+ * simulate_blocked                                                                         *
+ * @brief Runs the tick loop of a simulation in windows of ticks until the observer ends    *
+ *        it.                                                                               *
+ *                                                                                          *
+ * Each window is granted by the observer's `leap`, since the observer does not see the     *
+ * trucks of the ticks inside it. An observer that has to see every tick gets the ticks     *
+ * run one at a time, as `Simulation::simulate` does.                                       *
+ *                                                                                          *
+ * @param sim: The simulation to run.                                                       *
+ * @param observer: The tick loop observer, see `Simulation::simulate`.                     *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if a debug check fails.                                      *
+ ********************************************************************************************/
+template<typename Observer>
+void simulate_blocked(Simulation& sim, Observer& observer);
+
+/********************************************************************************************
+ * benchmark_blocking                                                                       *
+ * @brief Measures the throughput and the cache misses of the serial and the blocked tick   *
+ *        loop on the same simulation.                                                      *
+ *                                                                                          *
+ * Both loops run a simulation of the same size and seed for its fixed horizon, so they do  *
+ * exactly the same work, and the trucks are compared afterwards so a blocked loop that     *
+ * diverges from the serial one is reported as an error.                                    *
+ *                                                                                          *
+ * @param num_trucks: The number of trucks in the simulation.                               *
+ * @param num_stations: The number of stations in the simulation.                           *
+ * @return: BlockingReport - The metrics of both tick loops.                                *
+ * @throws: std::runtime_error if the two tick loops do not produce the same trucks.        *
+ ********************************************************************************************/
+BlockingReport benchmark_blocking(uint16_t num_trucks, uint16_t num_stations);
+
+/********************************************************************************************
+ * log_blocking_report                                                                      *
+ * @brief Outputs the result of `benchmark_blocking` to the console.                        *
+ *                                                                                          *
+ * @param report: The benchmark result to print.                                            *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+void log_blocking_report(const BlockingReport& report);
+
+/********************************************************************************************
+ * Template and Inline Definitions                                                          *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * advance_to_event                                                                         *
+ * @brief Runs a truck through the window until it raises an event or the window ends.      *
+ *                                                                                          *
+ * The ticks before the truck's timer expires only record time, so they are taken in one    *
+ * `Truck::leap`, and only the ticks that expire the timer are run with `run_local`.        *
+ *                                                                                          *
+ * @param truck: The truck to advance.                                                      *
+ * @param offset: The tick of the window the truck is at, left at the tick of the event.    *
+ * @param window: The number of ticks in the window.                                        *
+ * @param transitions: The state machine of the site, see `make_truck_transitions`.         *
+ * @return: TruckEvent - The event raised, TruckEvent::None if the window ended first.      *
+ ********************************************************************************************/
+inline TruckEvent advance_to_event(Truck& truck, uint32_t& offset, uint32_t window,
+                                   const TruckTransitionTable& transitions) {
+
+    while(offset < window) {
+
+        uint32_t quiet = std::min<uint32_t>(truck.get_ticks_left() - 1u, window - offset);
+
+        if(quiet) {
+            truck.leap(static_cast<uint16_t>(quiet), transitions);
+            offset += quiet;
+        }
+        if(offset == window) {
+            break;
+        }
+
+        TruckEvent event = truck.run_local(transitions);
+
+        if(TruckEvent::None != event) {
+            return event;
+        }
+        offset++;
+    }
+    return TruckEvent::None;
+}
+
+/********************************************************************************************
+ * run_blocked_engine                                                                       *
+ * @brief Runs the blocked tick loop with the mining time distribution, the selection       *
+ *        policy, the observer, the consistency checks and the site fixed at compile time.  *
+ *                                                                                          *
+ * Every window is split into two phases:                                                   *
+ * 1. Blocked: each truck in turn is advanced through the window until its first event,     *
+ *    which only touches the truck itself, so it stays in L1 for all those ticks. The       *
+ *    event is filed under the tick of the window it was raised in.                         *
+ * 2. Ordered: the ticks of the window are gone through in order, resolving their events    *
+ *    in truck index order with `Truck::resolve`, exactly as the serial tick loop would.    *
+ *    A resolved truck is advanced again until its next event, which is always in a later   *
+ *    tick of the window, so it is filed before that tick is reached.                       *
+ *                                                                                          *
+ * A truck is loaded once per window plus once per event instead of once per tick. Since    *
+ * events are resolved per tick, in truck index order and with the tick of the serial       *
+ * loop, the station queues, selections and random draws are exactly those of the serial    *
+ * tick loop.                                                                               *
+ *                                                                                          *
+ * @param sim: The simulation to run.                                                       *
+ * @param mining_time: The active mining time distribution policy.                          *
+ * @param selector: The active station selection policy.                                    *
+ * @param observer: The tick loop observer.                                                 *
+ * @param checks: The consistency check policy, see `select_checks`.                        *
+ * @param site: The site policy, see `select_site`.                                         *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename MiningTime, typename Selector, typename Observer, typename Checks,
+         typename Site>
+void run_blocked_engine(Simulation& sim,
+                        MiningTime& mining_time,
+                        Selector& selector,
+                        Observer& observer,
+                        Checks checks,
+                        Site site) {
+
+    std::pmr::vector<Truck>& trucks = sim.trucks;
+    std::pmr::vector<Station>& stations = sim.stations;
+
+    /* Events of each tick of the window, kept across windows to reuse their storage        */
+    std::vector<std::vector<PendingEvent>> pending(BLOCK_TICKS);
+
+    while(true) {
+
+        uint32_t window = static_cast<uint32_t>(observer.leap(BLOCK_TICKS));
+
+        /* The observer has to see this tick, run it like the serial tick loop              */
+        if(window == 0) {
+
+            if(!observer.next_tick()) {
+                break;
+            }
+
+            for(auto& truck : trucks) {
+
+                observer.observe(truck);
+
+                truck.run(stations, sim.tick, selector, mining_time, sim.gen,
+                          site.transitions);
+
+                checks.check_selection(stations, sim.tick, selector);
+            }
+
+            sim.tick++;
+            continue;
+        }
+
+        /* Blocked phase, take every truck through the window up to its first event         */
+        for(uint32_t idx = 0; idx < trucks.size(); idx++) {
+
+            uint32_t offset = 0;
+            TruckEvent event = advance_to_event(trucks[idx], offset, window,
+                                                site.transitions);
+
+            if(TruckEvent::None != event) {
+                pending[offset].push_back(PendingEvent{idx, event});
+            }
+        }
+
+        /* Ordered phase, resolve the events tick by tick in truck index order              */
+        for(uint32_t offset = 0; offset < window; offset++) {
+
+            std::vector<PendingEvent>& events = pending[offset];
+            uint32_t tick = sim.tick + offset;
+
+            /* Trucks refiled by an earlier tick come after the ones of the blocked phase   */
+            std::sort(events.begin(), events.end(),
+                      [](const PendingEvent& lhs, const PendingEvent& rhs) {
+                return lhs.truck_idx < rhs.truck_idx;
+            });
+
+            for(const PendingEvent& entry : events) {
+
+                Truck& truck = trucks[entry.truck_idx];
+
+                truck.resolve(entry.event, stations, tick, selector, mining_time, sim.gen);
+
+                checks.check_selection(stations, tick, selector);
+
+                /* Carry on from the next tick, the next event is in a later tick           */
+                uint32_t next = offset + 1;
+                TruckEvent event = advance_to_event(truck, next, window, site.transitions);
+
+                if(TruckEvent::None != event) {
+                    pending[next].push_back(PendingEvent{entry.truck_idx, event});
+                }
+            }
+            events.clear();
+        }
+
+        /* Every station unloaded a truck per tick, which moves all the queues on at once   */
+        sim.tick += window;
+    }
+}
+
+/********************************************************************************************
+ * simulate_blocked                                                                         *
+ * @brief Runs the tick loop of a simulation in windows of ticks until the observer ends    *
+ *        it.                                                                               *
+ *                                                                                          *
+ * @param sim: The simulation to run.                                                       *
+ * @param observer: The tick loop observer, see `Simulation::simulate`.                     *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if a debug check fails.                                      *
+ ********************************************************************************************/
+template<typename Observer>
+void simulate_blocked(Simulation& sim, Observer& observer) {
+
+    /* Resolve the distribution, the selection policy, the checks and the site once, so the  *
+     * tick loop is specialized for them                                                    */
+    std::visit([&](auto& dist, auto& selector) {
+        select_checks(sim.debug, [&](auto checks) {
+            select_site(sim.site, sim.transitions, [&](auto site) {
+                run_blocked_engine(sim, dist, selector, observer, checks, site);
+            });
+        });
+    }, sim.mining_time, sim.selector);
+}
+
+#endif // BLOCKING_HPP
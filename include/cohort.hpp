@@ -0,0 +1,437 @@
+/********************************************************************************************
+ * File: cohort.hpp                                                                         *
+ *                                                                                          *
+ * Description:                                                                             *
+ *  Contains the cohort engine of the Helium-3 Mining Simulator. Trucks that share their    *
+ *  state and timer behave identically until they draw a new mining time, so instead of     *
+ *  one object per truck the engine stores how many trucks share each state and timer,      *
+ *  and advances those counts. This lets fleets of millions of trucks run in less time      *
+ *  than the per truck engine needs for 65535.                                              *
+ *                                                                                          *
+ * Changes:                                                                                 *
+ *  10/16/2026 - Created                                                                    *
+ *                                                                                          *
+ ********************************************************************************************/
+#ifndef COHORT_HPP
+#define COHORT_HPP
+
+/********************************************************************************************
+ * Includes                                                                                 *
+ ********************************************************************************************/
+#include <array>
+#include <deque>
+#include <memory_resource>
+#include <vector>
+
+#ifndef MAIN_HPP
+#include "../include/main.hpp"
+#endif
+
+/********************************************************************************************
+ * Defines/Macros                                                                           *
+ ********************************************************************************************/
+#define COHORT_WAIT_BINS        4096u   /*Waits this long or longer share the last bin     */
+
+/********************************************************************************************
+ * Enumerations/Classes                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * StationRun                                                                               *
+ * @brief Consecutive stations, in round robin order, whose queues run empty at the same    *
+ *        tick and that were sent the same number of trucks.                                *
+ ********************************************************************************************/
+struct StationRun {
+    uint32_t num_stations;
+
+    /* Wide enough for a queue of the whole fleet, and every arrival of the run             */
+    uint64_t empty_tick;
+    uint64_t assigned;
+};
+
+/********************************************************************************************
+ * CohortSimulation                                                                         *
+ * @brief Simulates a fleet at a single site by the number of trucks in each state, rather  *
+ *        than truck by truck.                                                              *
+ *                                                                                          *
+ * A cohort is the set of trucks that share a state and the tick their timer expires at.    *
+ * Every timed state (Mining and both travel states) keeps its cohorts in a ring indexed    *
+ * by that tick, so a tick only looks at the cohorts expiring in it, and cohorts that       *
+ * meet on the same tick merge by construction. A cohort only splits when its trucks        *
+ * draw new mining times, where it is dealt out over the mining time distribution with      *
+ * one binomial draw per mining time, or when it arrives at the stations.                   *
+ *                                                                                          *
+ * Queued trucks are not kept as cohorts at all. A station unloads one truck per tick, so   *
+ * trucks joining it together leave it on consecutive ticks, and all the engine needs is    *
+ * the tick each station runs empty and how many stations start or stop unloading on        *
+ * every tick. Arrivals are dealt out round robin, which keeps stations that run empty      *
+ * together next to each other, so the stations are stored as runs of such neighbours.      *
+ * A tick costs O(runs touched), a handful once every station is busy, however large the    *
+ * fleet and however many stations there are.                                               *
+ *                                                                                          *
+ * Trucks lose their identity, so rather than logging every truck the engine reports the    *
+ * fleet's state fractions, which match those of `Simulation`, and the distributions of     *
+ * the wait per station visit and of the trucks unloaded per station.                       *
+ ********************************************************************************************/
+class CohortSimulation {
+public:
+    /****************************************************************************************
+     * CohortSimulation Constructor                                                         *
+     * @brief Initializes a simulation of the given fleet, with every truck mining.         *
+     *                                                                                      *
+     * The first mining times are dealt out over the distribution like any later draw.      *
+     *                                                                                      *
+     * @param num_trucks: The number of trucks to be simulated.                             *
+     * @param num_stations: The number of stations available in the simulation.             *
+     * @param debug: Optional parameter that enables debug mode if set to true.             *
+     * @param mining_time: Optional distribution of mining times, defaults to the uniform   *
+     *                     distribution between the site's mining time bounds.              *
+     * @param seed: Optional seed of the simulation's random number generator.              *
+     * @param memory: Optional resource the cohorts and stations are stored in.             *
+     * @param site: Optional site the simulation runs at, defaults to the standard site.    *
+     * @return: None                                                                        *
+     * @throws: std::invalid_argument if there are no trucks or no stations.                *
+     ****************************************************************************************/
+    CohortSimulation(uint32_t num_trucks,
+                     uint16_t num_stations,
+                     bool debug = false,
+                     std::optional<MiningTimeDistribution> mining_time = std::nullopt,
+                     uint32_t seed = std::random_device{}(),
+                     std::pmr::memory_resource* memory = std::pmr::get_default_resource(),
+                     const SiteConfig& site = STANDARD_SITE);
+
+    /****************************************************************************************
+     * simulate                                                                             *
+     * @brief Runs the tick loop for `total_time` ticks.                                    *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void simulate();
+
+    /****************************************************************************************
+     * simulate                                                                             *
+     * @brief Runs the tick loop until the observer stops it.                               *
+     *                                                                                      *
+     * Only the observer's `next_tick` is called, there are no trucks to observe.           *
+     *                                                                                      *
+     * @param observer: The tick loop observer, see `Simulation::simulate`.                 *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename Observer>
+    void simulate(Observer& observer);
+
+    /****************************************************************************************
+     * logging                                                                              *
+     * @brief Outputs the fleet's state fractions and the wait and unload distributions to  *
+     *        the console.                                                                  *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void logging();
+
+    /****************************************************************************************
+     * get_state_fractions                                                                  *
+     * @brief Computes the fraction of time the fleet spent in each category.               *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: StateFractions - The fleet-wide fraction of time spent in each category.    *
+     ****************************************************************************************/
+    StateFractions get_state_fractions();
+
+    /****************************************************************************************
+     * get_wait_percentile                                                                  *
+     * @brief Computes a percentile of the wait of every truck that joined a queue.         *
+     *                                                                                      *
+     * @param fraction: The percentile as a fraction, between 0.0 and 1.0.                  *
+     * @return: uint32_t - The wait in ticks, at most COHORT_WAIT_BINS - 1.                 *
+     ****************************************************************************************/
+    uint32_t get_wait_percentile(double fraction);
+
+    /* Number of trucks in the fleet                                                        */
+    uint32_t num_trucks;
+
+    /* Store the total execution time of the simulation                                     */
+    uint16_t total_time;
+
+    /* Flag to determine whether to run additional consistency checks during the simulation */
+    bool debug;
+
+    /* Distribution the trucks draw their mining times from                                 */
+    MiningTimeDistribution mining_time;
+
+    /* Mersenne Twister pseudorandom number generator used for every draw                   */
+    std::mt19937 gen;
+
+    /* Site the simulation runs at, and the truck state machine built from it               */
+    SiteConfig site;
+    TruckTransitionTable transitions;
+
+    /* Number of ticks run since the simulation was set up, see `Station`                   */
+    uint32_t tick;
+
+private:
+    /****************************************************************************************
+     * run_engine                                                                           *
+     * @brief Runs the tick loop with the mining time distribution, the observer and the    *
+     *        consistency checks fixed at compile time.                                     *
+     *                                                                                      *
+     * @param mining_time: The active mining time distribution policy.                      *
+     * @param observer: The tick loop observer.                                             *
+     * @param checks: The consistency check policy, see `select_checks`.                    *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename MiningTime, typename Observer, typename Checks>
+    void run_engine(MiningTime& mining_time, Observer& observer, Checks checks);
+
+    /****************************************************************************************
+     * schedule                                                                             *
+     * @brief Adds trucks to the cohort of a state whose timer expires at the given tick.   *
+     *                                                                                      *
+     * @param state: The state the trucks are in.                                           *
+     * @param expiry: The tick their timer expires at, less than a ring ahead.              *
+     * @param count: The number of trucks.                                                  *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void schedule(TruckState state, uint32_t expiry, uint32_t count);
+
+    /****************************************************************************************
+     * expire                                                                               *
+     * @brief Removes the cohort of a state whose timer expires this tick.                  *
+     *                                                                                      *
+     * @param state: The state of the cohort.                                               *
+     * @return: uint32_t - The number of trucks in the cohort.                              *
+     ****************************************************************************************/
+    uint32_t expire(TruckState state);
+
+    /****************************************************************************************
+     * draw                                                                                 *
+     * @brief Starts a cohort mining, splitting it over the mining times it draws.          *
+     *                                                                                      *
+     * Small cohorts draw truck by truck. Larger ones draw how many trucks take each        *
+     * mining time from a binomial distribution conditioned on the trucks left, which       *
+     * is an exact multinomial split in O(mining times).                                    *
+     *                                                                                      *
+     * @param mining_time: The active mining time distribution policy.                      *
+     * @param start: The first tick the trucks spend mining.                                *
+     * @param count: The number of trucks in the cohort.                                    *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename MiningTime>
+    void draw(MiningTime& mining_time, uint32_t start, uint32_t count);
+
+    /****************************************************************************************
+     * arrive                                                                               *
+     * @brief Deals a cohort arriving at the stations out round robin and queues it.        *
+     *                                                                                      *
+     * Every station gets the same share and the next `count % S` stations one more, so     *
+     * only the run holding that boundary is split. The runs given the extra truck move to  *
+     * the back, so the front run always holds the station the next truck is sent to.       *
+     *                                                                                      *
+     * @param count: The number of trucks in the cohort.                                    *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void arrive(uint32_t count);
+
+    /****************************************************************************************
+     * join_queue                                                                           *
+     * @brief Queues trucks at every station of a run behind the trucks already there.      *
+     *                                                                                      *
+     * @param run: The run of stations.                                                     *
+     * @param count: The number of trucks joining each station, they unload on consecutive  *
+     *               ticks.                                                                 *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void join_queue(StationRun& run, uint32_t count);
+
+    /****************************************************************************************
+     * merge_runs                                                                           *
+     * @brief Merges neighbouring runs that run empty at the same tick and were sent the    *
+     *        same number of trucks.                                                        *
+     *                                                                                      *
+     * @param first: The index of the first run that may be merged with the one after it.   *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void merge_runs(size_t first);
+
+    /****************************************************************************************
+     * record_waits                                                                         *
+     * @brief Adds the waits first, first + 1, ..., first + count - 1 of every station of a *
+     *        run to the distribution.                                                      *
+     *                                                                                      *
+     * @param first: The wait of the first truck in ticks.                                  *
+     * @param count: The number of trucks joining each station.                             *
+     * @param num_stations: The number of stations in the run.                              *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void record_waits(uint64_t first, uint32_t count, uint32_t num_stations);
+
+    /* Trucks of each state by the tick their timer expires at, one ring per state          */
+    std::pmr::vector<uint32_t> cohorts;
+    uint32_t cohort_mask;
+
+    /* Trucks currently in each state, and the truck ticks recorded in each state           */
+    std::array<uint64_t, 5> population;
+    std::array<uint64_t, 5> state_ticks;
+
+    /* Stations in round robin order from the one the next truck is sent to, see `arrive`   */
+    std::pmr::deque<StationRun> station_runs;
+    uint16_t num_stations;
+
+    /* Stations that start (+1) or stop (-1) unloading on each tick, a ring that grows with  *
+     * the longest queue                                                                    */
+    std::pmr::vector<int32_t> unload_changes;
+
+    /* Stations unloading this tick, and trucks queued or unloading at any station          */
+    uint32_t unloading;
+    uint64_t queued;
+
+    /* Chance of each mining time given that no shorter one was drawn, see `draw`           */
+    std::pmr::vector<double> split_odds;
+    uint16_t min_mining_time;
+
+    /* Waits of every truck that joined a queue, as the change in count from the bin before */
+    std::pmr::vector<int64_t> wait_changes;
+    uint64_t num_waits;
+    double total_wait;
+    uint64_t max_wait;
+};
+
+/********************************************************************************************
+ * Template Definitions                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * CohortSimulation::simulate                                                               *
+ * @brief Runs the tick loop until the observer stops it.                                   *
+ *                                                                                          *
+ * @param observer: The tick loop observer, see `Simulation::simulate`.                     *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename Observer>
+void CohortSimulation::simulate(Observer& observer) {
+
+    /* Select the distribution and the checks once, outside of the tick loop                */
+    std::visit([this, &observer](auto& dist) {
+        select_checks(this->debug, [&](auto checks) {
+            this->run_engine(dist, observer, checks);
+        });
+    }, this->mining_time);
+}
+
+/********************************************************************************************
+ * CohortSimulation::run_engine                                                             *
+ * @brief Runs the tick loop with the mining time distribution, the observer and the        *
+ *        consistency checks fixed at compile time.                                         *
+ *                                                                                          *
+ * Every tick first records the time of every truck from the state counts, then the         *
+ * stations unload, then the cohorts of the timed states whose timers expire move on        *
+ * through the site's state machine, like `Truck::run_local` does for a single truck.       *
+ *                                                                                          *
+ * @param mining_time: The active mining time distribution policy.                          *
+ * @param observer: The tick loop observer.                                                 *
+ * @param checks: The consistency check policy, see `select_checks`.                        *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename MiningTime, typename Observer, typename Checks>
+void CohortSimulation::run_engine(MiningTime& mining_time, Observer& observer,
+                                  Checks checks) {
+
+    const TruckTransition& unload =
+        this->transitions[static_cast<size_t>(TruckState::Unloading)];
+
+    /* Each iteration is one tick, the observer decides when the simulation ends            */
+    while(observer.next_tick()) {
+
+        /* Stations whose queue starts or runs out this tick, the ring may have grown       */
+        size_t mask = this->unload_changes.size() - 1;
+        int32_t& changes = this->unload_changes[this->tick & mask];
+
+        this->unloading += changes;
+        changes = 0;
+
+        /* Every truck spends the tick in the state it started it in                        */
+        uint64_t fleet_size = this->queued;
+
+        for(size_t state = 0; state < this->population.size(); state++) {
+            this->state_ticks[state] += this->population[state];
+            fleet_size += this->population[state];
+        }
+        this->state_ticks[static_cast<size_t>(TruckState::Unloading)] += this->unloading;
+        this->state_ticks[static_cast<size_t>(TruckState::Waiting)] +=
+            this->queued - this->unloading;
+
+        checks.check_fleet_size(fleet_size, this->num_trucks);
+
+        /* Every unloading station sends one truck home                                     */
+        this->queued -= this->unloading;
+        this->schedule(unload.next, this->tick + unload.reload, this->unloading);
+
+        /* Move the cohorts whose timer expires this tick on                                */
+        for(TruckState state : {TruckState::Mining, TruckState::TravelStation,
+                                TruckState::TravelMining}) {
+
+            const TruckTransition& transition = this->transitions[static_cast<size_t>(state)];
+            uint32_t count = this->expire(state);
+
+            if(count == 0) {
+                continue;
+            }
+
+            if(TruckEvent::Arrive == transition.event) {
+                this->arrive(count);
+            }
+            else if(TruckEvent::Draw == transition.event) {
+                this->draw(mining_time, this->tick + 1, count);
+            }
+            else {
+                this->schedule(transition.next, this->tick + transition.reload, count);
+            }
+        }
+
+        this->tick++;
+    }
+}
+
+/********************************************************************************************
+ * CohortSimulation::draw                                                                   *
+ * @brief Starts a cohort mining, splitting it over the mining times it draws.              *
+ *                                                                                          *
+ * @param mining_time: The active mining time distribution policy.                          *
+ * @param start: The first tick the trucks spend mining.                                    *
+ * @param count: The number of trucks in the cohort.                                        *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename MiningTime>
+void CohortSimulation::draw(MiningTime& mining_time, uint32_t start, uint32_t count) {
+
+    /* A truck mining for t ticks from `start` expires on its last one, the tick before the  *
+     * first wraps around and is masked like any other                                      */
+    uint32_t last = start - 1;
+
+    /* Fewer trucks than mining times, drawing each truck is cheaper                        */
+    if(count <= this->split_odds.size()) {
+
+        for(uint32_t i = 0; i < count; i++) {
+            this->schedule(TruckState::Mining, last + mining_time(this->gen), 1);
+        }
+        return;
+    }
+
+    /* Deal the trucks out over the mining times, shortest first                            */
+    uint32_t left = count;
+
+    for(size_t i = 0; (i < this->split_odds.size()) && (left > 0); i++) {
+
+        std::binomial_distribution<uint32_t> split(left, this->split_odds[i]);
+        uint32_t drawn = split(this->gen);
+
+        if(drawn) {
+            this->schedule(TruckState::Mining, last + this->min_mining_time + i, drawn);
+            left -= drawn;
+        }
+    }
+}
+
+#endif // COHORT_HPP
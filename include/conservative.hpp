@@ -0,0 +1,383 @@
+/********************************************************************************************
+ * File: conservative.hpp                                                                   *
+ *                                                                                          *
+ * Description:                                                                             *
+ *  Contains the conservative parallel discrete-event mode of the Helium-3 Mining           *
+ *  Simulator. A truck that leaves the mines only reaches the stations a travel time        *
+ *  later, so every arrival at the stations within the next travel time is already on its   *
+ *  way. The trucks are split into partitions that threads advance on their own through a   *
+ *  window of that many ticks, and the threads only synchronize at the end of the window,   *
+ *  where the arrivals the partitions raised are exchanged and resolved in order. The       *
+ *  partitions resolve the rest on their own, drawing from their own generators. The        *
+ *  partitions are fixed blocks of trucks, so the results only depend on the seed.          *
+ *                                                                                          *
+ * Changes:                                                                                 *
+ *  10/17/2026 - Created                                                                    *
+ *                                                                                          *
+ ********************************************************************************************/
+#ifndef CONSERVATIVE_HPP
+#define CONSERVATIVE_HPP
+
+/********************************************************************************************
+ * Includes                                                                                 *
+ ********************************************************************************************/
+#ifndef MAIN_HPP
+#include "../include/main.hpp"
+#endif
+
+#ifndef THREAD_POOL_HPP
+#include "../include/thread_pool.hpp"
+#endif
+
+#ifndef BLOCKING_HPP
+#include "../include/blocking.hpp"
+#endif
+
+/********************************************************************************************
+ * Defines/Macros                                                                           *
+ ********************************************************************************************/
+#define CONSERVATIVE_PARTITION  1024u   /*Trucks per partition, the same for any pool size  */
+
+/********************************************************************************************
+ * Enumerations/Classes                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * SyncMetrics                                                                              *
+ * @brief Cost of one parallel tick loop, as measured by `benchmark_conservative`.          *
+ ********************************************************************************************/
+struct SyncMetrics {
+
+    /* Truck updates (trucks times ticks) per second                                        */
+    double update_rate;
+
+    /* Number of times the threads waited for each other                                    */
+    size_t barriers;
+};
+
+/********************************************************************************************
+ * ConservativeReport                                                                       *
+ * @brief Result of `benchmark_conservative`, the per-tick and the windowed parallel tick   *
+ *        loops side by side.                                                               *
+ ********************************************************************************************/
+struct ConservativeReport {
+
+    /* Size of the simulations run and the threads running them                             */
+    uint16_t num_trucks;
+    uint16_t num_stations;
+    size_t num_threads;
+
+    SyncMetrics per_tick;
+    SyncMetrics windowed;
+};
+
+/********************************************************************************************
+ * Conservative Functions                                                                   *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * simulate_conservative                                                                    *
+ * @brief Runs the tick loop of a simulation for its fixed horizon on several threads,      *
+ *        synchronizing them once per travel time.                                          *
+ *                                                                                          *
+ * This is the windowed counterpart of `simulate_parallel`, including the warm-up. It       *
+ * produces the same results for the same seed on any pool, see `run_conservative_engine`.  *
+ *                                                                                          *
+ * @param sim: The simulation to run.                                                       *
+ * @param pool: The pool advancing the trucks, every truck on a fixed worker.               *
+ * @return: size_t - The number of times the threads synchronized.                          *
+ * @throws: std::runtime_error if a debug check fails.                                      *
+ ********************************************************************************************/
+size_t simulate_conservative(Simulation& sim, ThreadPool& pool);
+
+/********************************************************************************************
+ * simulate_conservative                                                                    *
+ * @brief Runs the tick loop of a simulation on several threads until the observer ends     *
+ *        it, synchronizing them once per travel time.                                      *
+ *                                                                                          *
+ * Each window is granted by the observer's `leap`, since the observer does not see the     *
+ * trucks of the ticks inside it. An observer that has to see every tick gets the ticks     *
+ * run one at a time on the calling thread.                                                 *
+ *                                                                                          *
+ * @param sim: The simulation to run.                                                       *
+ * @param observer: The tick loop observer, see `Simulation::simulate`.                     *
+ * @param pool: The pool advancing the trucks, every truck on a fixed worker.               *
+ * @return: size_t - The number of times the threads synchronized.                          *
+ * @throws: std::runtime_error if a debug check fails.                                      *
+ ********************************************************************************************/
+template<typename Observer>
+size_t simulate_conservative(Simulation& sim, Observer& observer, ThreadPool& pool);
+
+/********************************************************************************************
+ * benchmark_conservative                                                                   *
+ * @brief Measures the throughput and the synchronizations of the per-tick and the          *
+ *        windowed parallel tick loop on the same simulation.                               *
+ *                                                                                          *
+ * Both loops run a simulation of the same size and seed for its fixed horizon. The         *
+ * windowed loop is then run again from the same seed on a single worker and the runs       *
+ * compared, so a windowed loop whose results depend on the thread count is an error.       *
+ *                                                                                          *
+ * @param num_trucks: The number of trucks in the simulation.                               *
+ * @param num_stations: The number of stations in the simulation.                           *
+ * @param pool: The pool running both simulations.                                          *
+ * @return: ConservativeReport - The metrics of both tick loops.                            *
+ * @throws: std::runtime_error if the two windowed runs do not produce the same trucks.     *
+ ********************************************************************************************/
+ConservativeReport benchmark_conservative(uint16_t num_trucks, uint16_t num_stations,
+                                          ThreadPool& pool);
+
+/********************************************************************************************
+ * log_conservative_report                                                                  *
+ * @brief Outputs the result of `benchmark_conservative` to the console.                    *
+ *                                                                                          *
+ * @param report: The benchmark result to print.                                            *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+void log_conservative_report(const ConservativeReport& report);
+
+/********************************************************************************************
+ * Template Definitions                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * run_conservative_engine                                                                  *
+ * @brief Runs the windowed parallel tick loop with the mining time distribution, the       *
+ *        selection policy, the observer, the consistency checks and the site fixed at      *
+ *        compile time.                                                                     *
+ *                                                                                          *
+ * Every window of up to a travel time of ticks is split into two phases:                   *
+ * 1. Parallel: each partition of CONSERVATIVE_PARTITION consecutive trucks advances its    *
+ *    trucks through the window on its own, always on the same worker (see                  *
+ *    `ThreadPool::parallel_for_static`), every truck up to its arrival at the stations     *
+ *    (see `advance_to_event`), which is filed in the partition's outbox under the tick it  *
+ *    was raised in. Unloads and mining time draws are resolved on the way: the partition   *
+ *    notes the station of each unload, and draws from its own copy of the distribution     *
+ *    with its own generator. Nothing shared is touched.                                    *
+ * 2. Exchange: after the barrier the outboxes are merged tick by tick and the arrivals     *
+ *    resolved in truck index order with `Truck::resolve`, as the serial tick loop would.   *
+ *    A resolved truck is advanced on by its partition's state to the end of the window,    *
+ *    and an arrival it raises on the way is carried to a later tick of the window. The     *
+ *    unloads the partitions noted are then counted at their stations.                      *
+ *                                                                                          *
+ * The window is what keeps the exchange small. A truck arriving at the stations needs a    *
+ * travel time to get there, so within a travel time a truck arrives at most once, and      *
+ * the arrivals are the only events that read the queues the other trucks join.             *
+ * Partitions cover consecutive trucks in order, so their outboxes concatenate into truck   *
+ * index order without sorting.                                                             *
+ *                                                                                          *
+ * The generators of the partitions are seeded from the simulation's at the start of the    *
+ * run, and the partitions do not depend on the pool, so a run is deterministic for a seed  *
+ * whatever the number of threads. Its draws are not those of the serial tick loop, which   *
+ * takes them all from the simulation's generator in truck index order, so the two agree    *
+ * in distribution rather than truck by truck.                                              *
+ *                                                                                          *
+ * @param sim: The simulation to run.                                                       *
+ * @param mining_time: The active mining time distribution policy.                          *
+ * @param selector: The active station selection policy.                                    *
+ * @param observer: The tick loop observer.                                                 *
+ * @param pool: The pool advancing the trucks.                                              *
+ * @param checks: The consistency check policy, see `select_checks`.                        *
+ * @param site: The site policy, see `select_site`.                                         *
+ * @return: size_t - The number of times the threads synchronized.                          *
+ ********************************************************************************************/
+template<typename MiningTime, typename Selector, typename Observer, typename Checks,
+         typename Site>
+size_t run_conservative_engine(Simulation& sim,
+                               MiningTime& mining_time,
+                               Selector& selector,
+                               Observer& observer,
+                               ThreadPool& pool,
+                               Checks checks,
+                               Site site) {
+
+    std::pmr::vector<Truck>& trucks = sim.trucks;
+    std::pmr::vector<Station>& stations = sim.stations;
+    std::pmr::memory_resource* memory = trucks.get_allocator().resource();
+
+    uint32_t lookahead = std::max<uint32_t>(sim.site.travel_time, 1);
+    size_t grain = CONSERVATIVE_PARTITION;
+    size_t num_partitions = (trucks.size() + grain - 1) / grain;
+    size_t barriers = 0;
+
+    /* Trucks each partition saw arrive in each tick of the window                          */
+    std::pmr::vector<std::pmr::vector<std::pmr::vector<uint32_t>>> outboxes(memory);
+
+    /* Stations each partition saw unload a truck during the window                         */
+    std::pmr::vector<std::pmr::vector<uint16_t>> unloaded(memory);
+
+    /* Distribution and generator each partition draws its mining times from                */
+    std::pmr::vector<MiningTime> mining_times(num_partitions, mining_time, memory);
+    std::pmr::vector<std::mt19937> gens(memory);
+
+    outboxes.resize(num_partitions);
+    unloaded.resize(num_partitions);
+    gens.reserve(num_partitions);
+
+    for(size_t partition = 0; partition < num_partitions; partition++) {
+        outboxes[partition].resize(lookahead);
+        unloaded[partition].reserve(grain);
+        gens.emplace_back(sim.gen());
+    }
+
+    /* Arrivals raised by trucks advanced after their arrival was resolved                  */
+    std::pmr::vector<std::pmr::vector<uint32_t>> carried(memory);
+    carried.resize(lookahead);
+
+    /* Arrivals of the tick being resolved                                                  */
+    std::pmr::vector<uint32_t> arrivals(memory);
+
+    uint32_t window = 0;
+
+    /* Advances a truck to its next arrival in the window, resolving what it does on the    *
+     * way with the state of its partition, which only ever runs on one thread at a time    */
+    auto advance = [&](size_t idx, uint32_t& offset) {
+
+        Truck& truck = trucks[idx];
+        size_t partition = idx / grain;
+
+        while(true) {
+
+            TruckEvent event = advance_to_event(truck, offset, window, site.transitions);
+
+            if(TruckEvent::Unload == event) {
+                unloaded[partition].push_back(static_cast<uint16_t>(truck.get_station_idx()));
+            }
+            else if(TruckEvent::Draw == event) {
+                truck.resolve(event, stations, sim.tick + offset, selector,
+                              mining_times[partition], gens[partition]);
+            }
+            else {
+                return event;
+            }
+            offset++;
+        }
+    };
+
+    while(true) {
+
+        window = static_cast<uint32_t>(observer.leap(lookahead));
+
+        /* The observer has to see this tick, run it like the serial tick loop              */
+        if(window == 0) {
+
+            if(!observer.next_tick()) {
+                break;
+            }
+
+            for(auto& truck : trucks) {
+
+                observer.observe(truck);
+
+                truck.run(stations, sim.tick, selector, mining_time, sim.gen,
+                          site.transitions);
+
+                checks.check_selection(stations, sim.tick, selector);
+            }
+
+            sim.tick++;
+            continue;
+        }
+
+        /* Parallel phase, every partition advances its trucks through the window           */
+        pool.parallel_for_static(0, trucks.size(), grain, [&](size_t first, size_t last) {
+
+            std::pmr::vector<std::pmr::vector<uint32_t>>& outbox = outboxes[first / grain];
+
+            for(size_t idx = first; idx < last; idx++) {
+
+                uint32_t offset = 0;
+
+                if(TruckEvent::Arrive == advance(idx, offset)) {
+                    outbox[offset].push_back(static_cast<uint32_t>(idx));
+                }
+            }
+        });
+        barriers++;
+
+        /* Exchange phase, resolve the arrivals tick by tick in truck index order           */
+        for(uint32_t offset = 0; offset < window; offset++) {
+
+            uint32_t tick = sim.tick + offset;
+
+            arrivals.clear();
+
+            for(auto& outbox : outboxes) {
+                arrivals.insert(arrivals.end(), outbox[offset].begin(), outbox[offset].end());
+                outbox[offset].clear();
+            }
+
+            /* Carried arrivals are few and come from several earlier ticks                 */
+            if(!carried[offset].empty()) {
+
+                size_t raised = arrivals.size();
+
+                std::sort(carried[offset].begin(), carried[offset].end());
+                arrivals.insert(arrivals.end(), carried[offset].begin(),
+                                carried[offset].end());
+                std::inplace_merge(arrivals.begin(), arrivals.begin() + raised,
+                                   arrivals.end());
+                carried[offset].clear();
+            }
+
+            for(uint32_t idx : arrivals) {
+
+                trucks[idx].resolve(TruckEvent::Arrive, stations, tick, selector,
+                                    mining_time, sim.gen);
+
+                checks.check_selection(stations, tick, selector);
+
+                /* Carry on from the next tick, the next arrival is in a later tick         */
+                uint32_t next = offset + 1;
+
+                if(TruckEvent::Arrive == advance(idx, next)) {
+                    carried[next].push_back(idx);
+                }
+            }
+        }
+
+        /* Count the unloads, a station's count does not depend on their order              */
+        for(auto& stations_unloaded : unloaded) {
+            for(uint16_t station : stations_unloaded) {
+                stations[station].increment_trucks_unloaded();
+            }
+            stations_unloaded.clear();
+        }
+
+        /* Every station unloaded a truck per tick, which moves all the queues on at once   */
+        sim.tick += window;
+    }
+
+    return barriers;
+}
+
+/********************************************************************************************
+ * simulate_conservative                                                                    *
+ * @brief Runs the tick loop of a simulation on several threads until the observer ends     *
+ *        it, synchronizing them once per travel time.                                      *
+ *                                                                                          *
+ * @param sim: The simulation to run.                                                       *
+ * @param observer: The tick loop observer, see `Simulation::simulate`.                     *
+ * @param pool: The pool advancing the trucks, every truck on a fixed worker.               *
+ * @return: size_t - The number of times the threads synchronized.                          *
+ * @throws: std::runtime_error if a debug check fails.                                      *
+ ********************************************************************************************/
+template<typename Observer>
+size_t simulate_conservative(Simulation& sim, Observer& observer, ThreadPool& pool) {
+
+    size_t barriers = 0;
+
+    /* Resolve the distribution, the selection policy, the checks and the site once, so the  *
+     * tick loop is specialized for them                                                    */
+    std::visit([&](auto& dist, auto& selector) {
+        select_checks(sim.debug, [&](auto checks) {
+            select_site(sim.site, sim.transitions, [&](auto site) {
+                barriers = run_conservative_engine(sim, dist, selector, observer, pool,
+                                                   checks, site);
+            });
+        });
+    }, sim.mining_time, sim.selector);
+
+    return barriers;
+}
+
+#endif // CONSERVATIVE_HPP
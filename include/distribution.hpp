@@ -0,0 +1,413 @@
+/********************************************************************************************
+ * File: distribution.hpp                                                                   *
+ *                                                                                          *
+ * Description:                                                                             *
+ *  Contains the mining time distribution policies used by the Helium-3 Mining Simulator.   *
+ *  Each policy is a small value type with a templated call operator, so the simulation     *
+ *  engine can be instantiated once per policy and the draw is inlined into the tick loop   *
+ *  without any virtual dispatch.                                                           *
+ *                                                                                          *
+ * Changes:                                                                                 *
+ *  10/16/2026 - Created                                                                    *
+ *                                                                                          *
+ ********************************************************************************************/
+#ifndef DISTRIBUTION_HPP
+#define DISTRIBUTION_HPP
+
+/********************************************************************************************
+ * Includes                                                                                 *
+ ********************************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory_resource>
+#include <random>
+#include <variant>
+#include <vector>
+#include <stdexcept>
+
+/********************************************************************************************
+ * Enumerations/Classes                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * UniformMiningTime                                                                        *
+ * @brief Draws mining times uniformly between a minimum and maximum number of ticks.       *
+ *                                                                                          *
+ * This is the original behavior of the simulator, where every mining time is drawn         *
+ * uniformly between 1 and 5 hours (ONE_HOUR and FIVE_HOUR ticks).                          *
+ ********************************************************************************************/
+class UniformMiningTime {
+public:
+    /****************************************************************************************
+     * UniformMiningTime Constructor                                                        *
+     * @brief Initializes the distribution with an inclusive range of mining times.         *
+     *                                                                                      *
+     * @param min_time: The shortest mining time in ticks, must be at least 1.              *
+     * @param max_time: The longest mining time in ticks, must be at least `min_time`.      *
+     * @return: None                                                                        *
+     * @throws: std::invalid_argument if the range is empty or contains zero.               *
+     ****************************************************************************************/
+    UniformMiningTime(uint16_t min_time, uint16_t max_time);
+
+    /****************************************************************************************
+     * operator()                                                                           *
+     * @brief Draws a mining time in ticks.                                                 *
+     *                                                                                      *
+     * @param gen: The random number generator owned by the simulation.                     *
+     * @return: uint16_t - A mining time between `min_time` and `max_time` inclusive.       *
+     ****************************************************************************************/
+    template<typename URBG>
+    uint16_t operator()(URBG& gen);
+
+    /****************************************************************************************
+     * reset                                                                                *
+     * @brief Discards any state the distribution carries over from one draw to the next.   *
+     *                                                                                      *
+     * Called whenever the simulation's generator is reseeded, so the draws that follow     *
+     * depend on the seed alone.                                                            *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void reset();
+
+    /****************************************************************************************
+     * mean                                                                                 *
+     * @brief Retrieves the expected mining time in ticks of this distribution.             *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: double - The mean of the distribution after rounding and clamping.          *
+     ****************************************************************************************/
+    double mean() const;
+
+    /****************************************************************************************
+     * get_min_time                                                                         *
+     * @brief Retrieves the shortest mining time the distribution can draw.                 *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: uint16_t - The shortest mining time in ticks.                               *
+     ****************************************************************************************/
+    uint16_t get_min_time() const;
+
+    /****************************************************************************************
+     * get_max_time                                                                         *
+     * @brief Retrieves the longest mining time the distribution can draw.                  *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: uint16_t - The longest mining time in ticks.                                *
+     ****************************************************************************************/
+    uint16_t get_max_time() const;
+
+    /****************************************************************************************
+     * probability                                                                          *
+     * @brief Computes the probability of drawing a mining time.                            *
+     *                                                                                      *
+     * @param time: The mining time in ticks.                                               *
+     * @return: double - The probability of a draw of exactly `time` ticks.                 *
+     ****************************************************************************************/
+    double probability(uint16_t time) const;
+
+private:
+    /* Uniform distribution over the inclusive range of mining times                        */
+    std::uniform_int_distribution<uint32_t> dist;
+
+    /* Expected mining time in ticks, computed once at construction                         */
+    double expected;
+};
+
+/********************************************************************************************
+ * LognormalMiningTime                                                                      *
+ * @brief Draws mining times from a lognormal distribution, clamped to a range of ticks.    *
+ *                                                                                          *
+ * Real mining sites have a long right tail, which the lognormal captures well. The draw    *
+ * is rounded to the nearest tick and clamped so that a truck never mines for zero ticks    *
+ * and the 16 bit timer can never overflow.                                                 *
+ ********************************************************************************************/
+class LognormalMiningTime {
+public:
+    /****************************************************************************************
+     * LognormalMiningTime Constructor                                                      *
+     * @brief Initializes the distribution with its log-space parameters and a clamp range. *
+     *                                                                                      *
+     * @param m: The mean of the underlying normal distribution (log of ticks).             *
+     * @param s: The standard deviation of the underlying normal distribution.              *
+     * @param min_time: The shortest mining time in ticks, must be at least 1.              *
+     * @param max_time: The longest mining time in ticks, must be at least `min_time`.      *
+     * @return: None                                                                        *
+     * @throws: std::invalid_argument if the clamp range is empty or contains zero.         *
+     ****************************************************************************************/
+    LognormalMiningTime(double m, double s, uint16_t min_time, uint16_t max_time);
+
+    /****************************************************************************************
+     * operator()                                                                           *
+     * @brief Draws a mining time in ticks.                                                 *
+     *                                                                                      *
+     * @param gen: The random number generator owned by the simulation.                     *
+     * @return: uint16_t - A rounded lognormal draw clamped to `min_time` and `max_time`.   *
+     ****************************************************************************************/
+    template<typename URBG>
+    uint16_t operator()(URBG& gen);
+
+    /****************************************************************************************
+     * reset                                                                                *
+     * @brief Discards any state the distribution carries over from one draw to the next.   *
+     *                                                                                      *
+     * Called whenever the simulation's generator is reseeded, so the draws that follow     *
+     * depend on the seed alone.                                                            *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void reset();
+
+    /****************************************************************************************
+     * mean                                                                                 *
+     * @brief Retrieves the expected mining time in ticks of this distribution.             *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: double - The mean of the distribution after rounding and clamping.          *
+     ****************************************************************************************/
+    double mean() const;
+
+    /****************************************************************************************
+     * get_min_time                                                                         *
+     * @brief Retrieves the shortest mining time the distribution can draw.                 *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: uint16_t - The shortest mining time in ticks.                               *
+     ****************************************************************************************/
+    uint16_t get_min_time() const;
+
+    /****************************************************************************************
+     * get_max_time                                                                         *
+     * @brief Retrieves the longest mining time the distribution can draw.                  *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: uint16_t - The longest mining time in ticks.                                *
+     ****************************************************************************************/
+    uint16_t get_max_time() const;
+
+    /****************************************************************************************
+     * probability                                                                          *
+     * @brief Computes the probability of drawing a mining time.                            *
+     *                                                                                      *
+     * @param time: The mining time in ticks.                                               *
+     * @return: double - The probability of a draw of exactly `time` ticks.                 *
+     ****************************************************************************************/
+    double probability(uint16_t time) const;
+
+private:
+    /* Lognormal distribution in units of ticks                                             */
+    std::lognormal_distribution<double> dist;
+
+    /* Clamp range applied to every draw                                                    */
+    double min_time;
+    double max_time;
+
+    /* Expected mining time in ticks, computed once at construction                         */
+    double expected;
+};
+
+/********************************************************************************************
+ * EmpiricalMiningTime                                                                      *
+ * @brief Draws mining times from an empirical histogram using Vose's alias method.         *
+ *                                                                                          *
+ * The histogram is given as a list of weights, where bin `i` is the weight of a mining     *
+ * time of `min_time + i` ticks. The constructor builds an alias table in O(n), after       *
+ * which every draw is O(1) regardless of how large the histogram is: one uniform bin       *
+ * index and one uniform coin flip decide between the bin and its alias.                    *
+ ********************************************************************************************/
+class EmpiricalMiningTime {
+public:
+    /****************************************************************************************
+     * EmpiricalMiningTime Constructor                                                      *
+     * @brief Builds the alias table for the given histogram.                               *
+     *                                                                                      *
+     * @param histogram: Non-negative weights, one per tick starting at `min_time`. The     *
+     *                   weights do not need to be normalized.                              *
+     * @param min_time: The mining time in ticks of the first bin, must be at least 1.      *
+     * @return: None                                                                        *
+     * @throws: std::invalid_argument if the histogram is empty, has negative weights,      *
+     *          sums to zero, or does not fit in the 16 bit timer.                          *
+     ****************************************************************************************/
+    EmpiricalMiningTime(const std::vector<double>& histogram, uint16_t min_time);
+
+    /****************************************************************************************
+     * EmpiricalMiningTime Constructor                                                      *
+     * @brief Copies a distribution, allocating the tables of the copy from `memory`.       *
+     *                                                                                      *
+     * @param other: The distribution to copy.                                              *
+     * @param memory: The resource the alias table and the weights are stored in.           *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    EmpiricalMiningTime(const EmpiricalMiningTime& other, std::pmr::memory_resource* memory);
+
+    /****************************************************************************************
+     * operator()                                                                           *
+     * @brief Draws a mining time in ticks.                                                 *
+     *                                                                                      *
+     * @param gen: The random number generator owned by the simulation.                     *
+     * @return: uint16_t - The mining time of the drawn histogram bin.                      *
+     ****************************************************************************************/
+    template<typename URBG>
+    uint16_t operator()(URBG& gen);
+
+    /****************************************************************************************
+     * reset                                                                                *
+     * @brief Discards any state the distribution carries over from one draw to the next.   *
+     *                                                                                      *
+     * Called whenever the simulation's generator is reseeded, so the draws that follow     *
+     * depend on the seed alone.                                                            *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void reset();
+
+    /****************************************************************************************
+     * mean                                                                                 *
+     * @brief Retrieves the expected mining time in ticks of this distribution.             *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: double - The mean of the distribution after rounding and clamping.          *
+     ****************************************************************************************/
+    double mean() const;
+
+    /****************************************************************************************
+     * get_min_time                                                                         *
+     * @brief Retrieves the shortest mining time the distribution can draw.                 *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: uint16_t - The shortest mining time in ticks.                               *
+     ****************************************************************************************/
+    uint16_t get_min_time() const;
+
+    /****************************************************************************************
+     * get_max_time                                                                         *
+     * @brief Retrieves the longest mining time the distribution can draw.                  *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: uint16_t - The longest mining time in ticks.                                *
+     ****************************************************************************************/
+    uint16_t get_max_time() const;
+
+    /****************************************************************************************
+     * probability                                                                          *
+     * @brief Computes the probability of drawing a mining time.                            *
+     *                                                                                      *
+     * @param time: The mining time in ticks.                                               *
+     * @return: double - The probability of a draw of exactly `time` ticks.                 *
+     ****************************************************************************************/
+    double probability(uint16_t time) const;
+
+    /****************************************************************************************
+     * storage_bytes                                                                        *
+     * @brief Computes the memory a copy of the distribution allocates from its resource.   *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: size_t - The bytes needed, including the worst case alignment padding.      *
+     ****************************************************************************************/
+    size_t storage_bytes() const;
+
+private:
+    /* Probability of keeping the drawn bin instead of taking its alias                     */
+    std::pmr::vector<double> prob;
+
+    /* Alias bin for each bin of the histogram                                              */
+    std::pmr::vector<uint16_t> alias;
+
+    /* Selects a bin uniformly and flips the biased coin                                    */
+    std::uniform_int_distribution<size_t> bin;
+    std::uniform_real_distribution<double> coin;
+
+    /* Normalized histogram, the probability of each bin                                    */
+    std::pmr::vector<double> weights;
+
+    /* Mining time in ticks of the first bin                                                */
+    uint16_t min_time;
+
+    /* Expected mining time in ticks, computed once at construction                         */
+    double expected;
+};
+
+/* Set of mining time distributions a Simulation can be configured with                     */
+using MiningTimeDistribution = std::variant<UniformMiningTime,
+                                            LognormalMiningTime,
+                                            EmpiricalMiningTime>;
+
+/********************************************************************************************
+ * Distribution Functions                                                                   *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * copy_distribution                                                                        *
+ * @brief Copies a mining time distribution, allocating any table it has from `memory`.     *
+ *                                                                                          *
+ * The uniform and lognormal distributions are copied as they are, they do not allocate.    *
+ *                                                                                          *
+ * @param dist: The distribution to copy.                                                   *
+ * @param memory: The resource the tables of the copy are stored in.                        *
+ * @return: MiningTimeDistribution - The copy.                                              *
+ ********************************************************************************************/
+MiningTimeDistribution copy_distribution(const MiningTimeDistribution& dist,
+                                         std::pmr::memory_resource* memory);
+
+/********************************************************************************************
+ * distribution_storage_bytes                                                               *
+ * @brief Computes the memory `copy_distribution` allocates from its resource.              *
+ *                                                                                          *
+ * @param dist: The distribution to be copied.                                              *
+ * @return: size_t - The bytes needed, zero for the uniform and lognormal distributions.    *
+ ********************************************************************************************/
+size_t distribution_storage_bytes(const MiningTimeDistribution& dist);
+
+/********************************************************************************************
+ * Template Definitions                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * UniformMiningTime::operator()                                                            *
+ * @brief Draws a mining time in ticks.                                                     *
+ *                                                                                          *
+ * @param gen: The random number generator owned by the simulation.                         *
+ * @return: uint16_t - A mining time between `min_time` and `max_time` inclusive.           *
+ ********************************************************************************************/
+template<typename URBG>
+uint16_t UniformMiningTime::operator()(URBG& gen) {
+    return static_cast<uint16_t>(this->dist(gen));
+}
+
+/********************************************************************************************
+ * LognormalMiningTime::operator()                                                          *
+ * @brief Draws a mining time in ticks.                                                     *
+ *                                                                                          *
+ * @param gen: The random number generator owned by the simulation.                         *
+ * @return: uint16_t - A rounded lognormal draw clamped to `min_time` and `max_time`.       *
+ ********************************************************************************************/
+template<typename URBG>
+uint16_t LognormalMiningTime::operator()(URBG& gen) {
+
+    /* Round to the closest tick and keep the draw inside the clamp range                   */
+    double time = std::nearbyint(this->dist(gen));
+    return static_cast<uint16_t>(std::clamp(time, this->min_time, this->max_time));
+}
+
+/********************************************************************************************
+ * EmpiricalMiningTime::operator()                                                          *
+ * @brief Draws a mining time in ticks.                                                     *
+ *                                                                                          *
+ * @param gen: The random number generator owned by the simulation.                         *
+ * @return: uint16_t - The mining time of the drawn histogram bin.                          *
+ ********************************************************************************************/
+template<typename URBG>
+uint16_t EmpiricalMiningTime::operator()(URBG& gen) {
+
+    /* Pick a bin uniformly, then keep it or take its alias based on a biased coin          */
+    size_t idx = this->bin(gen);
+    size_t drawn = (this->coin(gen) < this->prob[idx]) ? idx : this->alias[idx];
+
+    return static_cast<uint16_t>(this->min_time + drawn);
+}
+
+#endif // DISTRIBUTION_HPP
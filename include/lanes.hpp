@@ -0,0 +1,373 @@
+/********************************************************************************************
+ * File: lanes.hpp                                                                          *
+ *                                                                                          *
+ * Description:                                                                             *
+ *  Contains the replication-vectorized engine of the Helium-3 Mining Simulator. Monte      *
+ *  Carlo studies run the same configuration under thousands of seeds, and every            *
+ *  replication takes the same branches through the tick loop most of the time. The engine  *
+ *  interleaves several replications so that each truck is stored once per replication side *
+ *  by side, and advances the same truck of every replication in one pass the compiler can  *
+ *  turn into SIMD instructions. Only the trucks whose timer expired, which are few in any  *
+ *  tick, leave that pass to resolve their events one replication at a time. Every          *
+ *  replication produces exactly the results of `Simulation` with the same seed.            *
+ *                                                                                          *
+ * Changes:                                                                                 *
+ *  10/17/2026 - Created                                                                    *
+ *                                                                                          *
+ ********************************************************************************************/
+#ifndef LANES_HPP
+#define LANES_HPP
+
+/********************************************************************************************
+ * Includes                                                                                 *
+ ********************************************************************************************/
+#include <span>
+#include <vector>
+
+#ifndef MAIN_HPP
+#include "../include/main.hpp"
+#endif
+
+/********************************************************************************************
+ * Defines/Macros                                                                           *
+ ********************************************************************************************/
+#define REPLICATION_LANES       8u      /*Replications advanced together by LaneSimulation  */
+#define LANE_REPLICATIONS       64u     /*Replications run by each engine in the benchmark  */
+
+/********************************************************************************************
+ * Enumerations/Classes                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * TruckLanes                                                                               *
+ * @brief One truck of the simulation in every lane of `LaneSimulation`, see `Truck`.       *
+ *                                                                                          *
+ * The fields are arrays over the lanes, so the lane loop reads each of them with one       *
+ * vector load, and arrays of one object cannot overlap, which lets the compiler vectorize  *
+ * the loop without checking for aliasing first. The increment and countdown of the         *
+ * current state are kept next to the state, so the lane loop does not look them up.        *
+ ********************************************************************************************/
+struct TruckLanes {
+
+    /* Packed time recorded in each state, see `Truck::get_total_time`                      */
+    uint64_t total_times[REPLICATION_LANES];
+
+    /* Increment of the current state, see `TruckTransition`                                */
+    uint64_t increments[REPLICATION_LANES];
+
+    /* Ticks left in the current state, and the state as a `TruckState`                     */
+    uint16_t timers[REPLICATION_LANES];
+    uint16_t states[REPLICATION_LANES];
+
+    /* Countdown of the current state, see `TruckTransition`                                */
+    uint16_t countdowns[REPLICATION_LANES];
+
+    /* Station the truck is heading to, queued at or last unloaded at                       */
+    uint16_t station_idxs[REPLICATION_LANES];
+};
+
+/********************************************************************************************
+ * LaneSimulation                                                                           *
+ * @brief Runs REPLICATION_LANES replications of one configuration side by side, one per    *
+ *        lane, seeded `first_seed`, `first_seed + 1`, ...                                  *
+ *                                                                                          *
+ * Each truck is stored once for all the lanes (see `TruckLanes`), with the timer of lane   *
+ * l at `timers[l]` and likewise for the state and the recorded time. A tick walks the      *
+ * trucks in index order, and for every truck                                               *
+ * 1. counts down the timers and records the time of all the lanes at once, with the        *
+ *    increment and countdown the truck entered its state with. The loop over the lanes     *
+ *    has no control flow and vectorizes.                                                   *
+ * 2. runs the transition and resolves the event of every lane whose timer expired, with    *
+ *    the stations, selector, generator and distribution of that lane.                      *
+ *                                                                                          *
+ * Within a lane the events are still resolved in truck index order, and each lane draws    *
+ * from its own generator in the same order `Simulation` does, so the lanes are unaffected  *
+ * by each other and reproduce the scalar engine exactly.                                   *
+ ********************************************************************************************/
+class LaneSimulation {
+public:
+    /****************************************************************************************
+     * LaneSimulation Constructor                                                           *
+     * @brief Initializes every lane the way `Simulation` with the lane's seed would.       *
+     *                                                                                      *
+     * @param num_trucks: The number of trucks in every replication.                        *
+     * @param num_stations: The number of stations in every replication.                    *
+     * @param first_seed: The seed of the first lane, the others follow consecutively.      *
+     * @param mining_time: Optional distribution of mining times, copied into every lane,   *
+     *                     defaults to the uniform distribution between the site's mining   *
+     *                     time bounds.                                                     *
+     * @param memory: Optional resource the trucks, stations and selectors are stored in.   *
+     * @param site: Optional site the replications run at, defaults to the standard site.   *
+     * @param selection: Optional station selection policy, defaults to round robin.        *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    LaneSimulation(uint16_t num_trucks,
+                   uint16_t num_stations,
+                   uint32_t first_seed,
+                   std::optional<MiningTimeDistribution> mining_time = std::nullopt,
+                   std::pmr::memory_resource* memory = std::pmr::get_default_resource(),
+                   const SiteConfig& site = STANDARD_SITE,
+                   SelectionPolicy selection = SelectionPolicy::RoundRobin);
+
+    /****************************************************************************************
+     * simulate                                                                             *
+     * @brief Runs the tick loop of every lane for `total_time` ticks.                      *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void simulate();
+
+    /****************************************************************************************
+     * get_state_fractions                                                                  *
+     * @brief Computes the fraction of time the fleet of one lane spent in each category.   *
+     *                                                                                      *
+     * Sums the trucks in the same order as `fleet_state_fractions`, so the result is       *
+     * bitwise identical to that of the lane's scalar simulation.                           *
+     *                                                                                      *
+     * @param lane: The lane, less than REPLICATION_LANES.                                  *
+     * @return: StateFractions - The fleet-wide fraction of time spent in each category.    *
+     ****************************************************************************************/
+    StateFractions get_state_fractions(size_t lane);
+
+    /****************************************************************************************
+     * get_total_time                                                                       *
+     * @brief Retrieves the packed time a truck of one lane recorded, see                   *
+     *        `Truck::get_total_time`.                                                      *
+     *                                                                                      *
+     * @param truck_idx: The index of the truck.                                            *
+     * @param lane: The lane, less than REPLICATION_LANES.                                  *
+     * @return: uint64_t - The total time recorded for the truck across all states.         *
+     ****************************************************************************************/
+    uint64_t get_total_time(size_t truck_idx, size_t lane);
+
+    /****************************************************************************************
+     * get_trucks_unloaded                                                                  *
+     * @brief Retrieves the number of trucks a station of one lane has unloaded.            *
+     *                                                                                      *
+     * @param station_idx: The index of the station.                                        *
+     * @param lane: The lane, less than REPLICATION_LANES.                                  *
+     * @return: uint16_t - The number of trucks unloaded.                                   *
+     ****************************************************************************************/
+    uint16_t get_trucks_unloaded(size_t station_idx, size_t lane);
+
+    /* Number of trucks and stations in every replication                                   */
+    uint16_t num_trucks;
+    uint16_t num_stations;
+
+    /* Store the total execution time of the replications                                   */
+    uint16_t total_time;
+
+    /* Site the replications run at, and the truck state machine built from it              */
+    SiteConfig site;
+    TruckTransitionTable transitions;
+
+    /* Number of ticks run since the replications were set up, see `Station`                */
+    uint32_t tick;
+
+private:
+    /****************************************************************************************
+     * run_engine                                                                           *
+     * @brief Runs the tick loop with the mining time distribution and the selection        *
+     *        policy fixed at compile time.                                                 *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename MiningTime, typename Selector>
+    void run_engine();
+
+    /****************************************************************************************
+     * resolve                                                                              *
+     * @brief Runs the transition of one lane's truck whose timer expired and resolves its  *
+     *        event, as `Truck::run_local` and `Truck::resolve` would.                      *
+     *                                                                                      *
+     * @param truck: The truck, in every lane.                                              *
+     * @param lane: The lane of the truck.                                                  *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename MiningTime, typename Selector>
+    void resolve(TruckLanes& truck, size_t lane);
+
+    /* Every truck, in index order                                                          */
+    std::pmr::vector<TruckLanes> trucks;
+
+    /* Stations of every lane, lane-major since only resolved events touch them             */
+    std::pmr::vector<Station> stations;
+
+    /* Selection policy, generator and distribution of every lane                           */
+    std::pmr::vector<StationSelector> selectors;
+    std::pmr::vector<std::mt19937> gens;
+    std::pmr::vector<MiningTimeDistribution> mining_times;
+};
+
+/********************************************************************************************
+ * LaneReport                                                                               *
+ * @brief Result of `benchmark_lanes`, the scalar and the replication-vectorized engine     *
+ *        side by side.                                                                     *
+ ********************************************************************************************/
+struct LaneReport {
+
+    /* Size and number of the replications run                                              */
+    uint16_t num_trucks;
+    uint16_t num_stations;
+    size_t replications;
+
+    /* Replications per second of each engine                                               */
+    double scalar_rate;
+    double lane_rate;
+};
+
+/********************************************************************************************
+ * Lane Functions                                                                           *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * run_lane_replications                                                                    *
+ * @brief Runs one replication per entry of `results` for the fixed horizon, seeded         *
+ *        `first_seed`, `first_seed + 1`, ..., and stores their state fractions.            *
+ *                                                                                          *
+ * The replications run REPLICATION_LANES at a time on the calling thread. A last batch     *
+ * that is not full still runs every lane, and the surplus lanes are discarded.             *
+ *                                                                                          *
+ * @param num_trucks: The number of trucks in every replication.                            *
+ * @param num_stations: The number of stations in every replication.                        *
+ * @param mining_time: The mining time distribution of every replication.                   *
+ * @param first_seed: The seed of the first replication.                                    *
+ * @param results: Receives the state fractions of each replication, in seed order.         *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+void run_lane_replications(uint16_t num_trucks,
+                           uint16_t num_stations,
+                           const MiningTimeDistribution& mining_time,
+                           uint32_t first_seed,
+                           std::span<StateFractions> results);
+
+/********************************************************************************************
+ * benchmark_lanes                                                                          *
+ * @brief Measures the throughput of running LANE_REPLICATIONS replications one after the   *
+ *        other with `Simulation` and REPLICATION_LANES at a time with `LaneSimulation`.    *
+ *                                                                                          *
+ * Both engines run the same seeds, and the state fractions of every replication are        *
+ * compared afterwards so a lane that diverges is reported as an error.                     *
+ *                                                                                          *
+ * @param num_trucks: The number of trucks in every replication.                            *
+ * @param num_stations: The number of stations in every replication.                        *
+ * @return: LaneReport - The replication rate of both engines.                              *
+ * @throws: std::runtime_error if a lane does not produce the scalar engine's results.      *
+ ********************************************************************************************/
+LaneReport benchmark_lanes(uint16_t num_trucks, uint16_t num_stations);
+
+/********************************************************************************************
+ * log_lane_report                                                                          *
+ * @brief Outputs the result of `benchmark_lanes` to the console.                           *
+ *                                                                                          *
+ * @param report: The benchmark result to print.                                            *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+void log_lane_report(const LaneReport& report);
+
+/********************************************************************************************
+ * Template Definitions                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * LaneSimulation::run_engine                                                               *
+ * @brief Runs the tick loop with the mining time distribution and the selection policy     *
+ *        fixed at compile time.                                                            *
+ *                                                                                          *
+ * A truck only looks up the state machine when its timer expires, and keeps the increment  *
+ * and countdown of the state it enters. Unloading does not count down, which leaves its    *
+ * timer at zero, so a lane expires exactly when its timer reads zero after the countdown.  *
+ *                                                                                          *
+ * @param: None                                                                             *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename MiningTime, typename Selector>
+void LaneSimulation::run_engine() {
+
+    constexpr size_t lanes = REPLICATION_LANES;
+
+    for(uint16_t t = 0; t < this->total_time; t++) {
+
+        for(size_t i = 0; i < this->num_trucks; i++) {
+
+            TruckLanes& truck = this->trucks[i];
+            uint16_t expired = 0;
+
+            /* Same truck in every lane, no branches so the loop vectorizes                 */
+            for(size_t l = 0; l < lanes; l++) {
+
+                truck.total_times[l] += truck.increments[l];
+                truck.timers[l] -= truck.countdowns[l];
+                expired |= (truck.timers[l] == 0);
+            }
+
+            if(!expired) {
+                continue;
+            }
+
+            /* Resolve the lanes whose timer expired one at a time                          */
+            for(size_t l = 0; l < lanes; l++) {
+                if(truck.timers[l] == 0) {
+                    this->resolve<MiningTime, Selector>(truck, l);
+                }
+            }
+        }
+
+        this->tick++;
+    }
+}
+
+/********************************************************************************************
+ * LaneSimulation::resolve                                                                  *
+ * @brief Runs the transition of one lane's truck whose timer expired and resolves its      *
+ *        event, as `Truck::run_local` and `Truck::resolve` would.                          *
+ *                                                                                          *
+ * @param truck: The truck, in every lane.                                                  *
+ * @param lane: The lane of the truck.                                                      *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename MiningTime, typename Selector>
+void LaneSimulation::resolve(TruckLanes& truck, size_t lane) {
+
+    const TruckTransition& transition = this->transitions[truck.states[lane]];
+
+    truck.states[lane] = static_cast<uint16_t>(transition.next);
+    truck.timers[lane] = transition.reload;
+
+    std::span<Station> stations(&this->stations[lane * this->num_stations],
+                                this->num_stations);
+
+    if(TruckEvent::Arrive == transition.event) {
+
+        /* Queue at the station the lane's policy picks, as in `Truck::resolve`             */
+        Selector& selector = std::get<Selector>(this->selectors[lane]);
+        uint16_t station_idx = static_cast<uint16_t>(selector.select(stations, this->tick));
+
+        truck.station_idxs[lane] = station_idx;
+        truck.timers[lane] = stations[station_idx].get_queue(this->tick);
+        stations[station_idx].increment_queue(this->tick);
+
+        truck.states[lane] = static_cast<uint16_t>(truck.timers[lane] ? TruckState::Waiting
+                                                                    : TruckState::Unloading);
+    }
+    else if(TruckEvent::Unload == transition.event) {
+        stations[truck.station_idxs[lane]].increment_trucks_unloaded();
+    }
+    else if(TruckEvent::Draw == transition.event) {
+
+        MiningTime& mining_time = std::get<MiningTime>(this->mining_times[lane]);
+
+        truck.timers[lane] = mining_time(this->gens[lane]);
+        truck.states[lane] = static_cast<uint16_t>(TruckState::Mining);
+    }
+
+    /* Keep what the lane loop needs of the state the truck entered                         */
+    const TruckTransition& entered = this->transitions[truck.states[lane]];
+
+    truck.increments[lane] = entered.increment;
+    truck.countdowns[lane] = entered.countdown;
+}
+
+#endif // LANES_HPP
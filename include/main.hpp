@@ -15,19 +15,34 @@
 /********************************************************************************************
  * Includes                                                                                 *
  ********************************************************************************************/
+#include <array>
 #include <iostream>
 #include <random>
 #include <chrono>
 #include <functional>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+#ifndef DISTRIBUTION_HPP
+#include "../include/distribution.hpp"
+#endif
+
+#ifndef SELECTION_HPP
+#include "../include/selection.hpp"
+#endif
 
 /********************************************************************************************
  * Defines/Macros                                                                           *
  ********************************************************************************************/
+/* Times of the standard site, see SiteConfig                                               */
 #define TRAVEL_TIME     6u      /*Scale: 5 mins/bit, 12*5  = 30 minutes   = Travel time     */
 #define ONE_HOUR        12u     /*Scale: 5 mins/bit, 12*5  = 60 minutes   = 1 hour          */
 #define FIVE_HOUR       60u     /*Scale: 5 mins/bit, 60*5  = 300 minutes  = 5 hours         */
 #define MAX_TIME        864u    /*Scale: 5 mins/bit, 864*5 = 4320 minutes = 72 hours        */
 
+#define LEAP_BACKOFF    64u     /*Most ticks between two looks for ticks to leap over       */
+
 #define WAITING_INC     0x0000000000000001
 #define UNLOADING_INC   0x0000000000010000
 #define TRAVELING_INC   0x0000000100000000
@@ -51,6 +66,146 @@ enum class TruckState {
     TravelMining
 };
 
+/* Effect a truck's tick has on the shared simulation state, see Truck::run_local           */
+enum class TruckEvent {
+    None,
+    Arrive,
+    Unload,
+    Draw,
+    Depart
+};
+
+/********************************************************************************************
+ * SiteConfig                                                                               *
+ * @brief Times that describe a mining site, in ticks of 5 minutes.                         *
+ *                                                                                          *
+ * A site can be used as a runtime value, which the generic tick loop reads from memory,    *
+ * or as a template argument, which lets the compiler fold its times into the tick loop     *
+ * like it did with the macros. `select_site` picks the specialized loop whenever a         *
+ * runtime site matches one of the sites it has been compiled for.                          *
+ ********************************************************************************************/
+struct SiteConfig {
+
+    /* Ticks to travel between the mines and the stations, in either direction              */
+    uint16_t travel_time;
+
+    /* Bounds of the default uniform mining time distribution                               */
+    uint16_t min_mining_time;
+    uint16_t max_mining_time;
+
+    /* Ticks simulated by a fixed horizon run                                               */
+    uint16_t max_time;
+
+    /* Sites are compared member by member when dispatching                                 */
+    constexpr bool operator==(const SiteConfig&) const = default;
+};
+
+/* Site the simulator was written for, its tick loop is always compiled in specialized      */
+inline constexpr SiteConfig STANDARD_SITE = {TRAVEL_TIME, ONE_HOUR, FIVE_HOUR, MAX_TIME};
+
+/********************************************************************************************
+ * TruckTransition                                                                          *
+ * @brief One row of the truck state machine, describing what a truck in that state does    *
+ *        every tick.                                                                       *
+ *                                                                                          *
+ * Every tick a truck adds `increment` to its recorded time and counts its timer down by    *
+ * `countdown`. Once the timer reaches zero the truck moves to `next`, its timer is         *
+ * reloaded with `reload` and `event` is raised, so `Truck::resolve` can finish             *
+ * transitions that depend on shared state (the station queue or a mining time draw).       *
+ ********************************************************************************************/
+struct TruckTransition {
+
+    /* Added to the packed time of the truck, one of the *_INC macros                       */
+    uint64_t increment;
+
+    /* Subtracted from the timer, zero for states that last exactly one tick                */
+    uint16_t countdown;
+
+    /* Timer value once it expires, zero when `resolve` sets it                             */
+    uint16_t reload;
+
+    /* State once the timer expires, unchanged when `resolve` sets it                       */
+    TruckState next;
+
+    /* Event raised once the timer expires                                                  */
+    TruckEvent event;
+};
+
+/* Transition of each state, indexed by TruckState                                          */
+using TruckTransitionTable = std::array<TruckTransition, 5>;
+
+/********************************************************************************************
+ * make_truck_transitions                                                                   *
+ * @brief Builds the truck state machine of a site at compile time.                         *
+ *                                                                                          *
+ * A truck reaching the stations or the mines stays in its travel state and raises an       *
+ * event, `resolve` then picks its next state and timer. Unloading lasts exactly one tick,  *
+ * a truck only ever enters it with its timer at zero, so it expires without counting down. *
+ *                                                                                          *
+ * @param site: The site whose travel time the trucks take.                                 *
+ * @return: TruckTransitionTable - The transition of each state.                            *
+ ********************************************************************************************/
+constexpr TruckTransitionTable make_truck_transitions(const SiteConfig& site) {
+
+    TruckTransitionTable table = {};
+
+    table[static_cast<size_t>(TruckState::Mining)] =
+        {MINING_INC, 1, site.travel_time, TruckState::TravelStation, TruckEvent::None};
+
+    table[static_cast<size_t>(TruckState::TravelStation)] =
+        {TRAVELING_INC, 1, 0, TruckState::TravelStation, TruckEvent::Arrive};
+
+    table[static_cast<size_t>(TruckState::Waiting)] =
+        {WAITING_INC, 1, 0, TruckState::Unloading, TruckEvent::None};
+
+    table[static_cast<size_t>(TruckState::Unloading)] =
+        {UNLOADING_INC, 0, site.travel_time, TruckState::TravelMining, TruckEvent::Unload};
+
+    table[static_cast<size_t>(TruckState::TravelMining)] =
+        {TRAVELING_INC, 1, 0, TruckState::TravelMining, TruckEvent::Draw};
+
+    return table;
+}
+
+/* State machine of the standard site                                                       */
+inline constexpr TruckTransitionTable TRUCK_TRANSITIONS =
+    make_truck_transitions(STANDARD_SITE);
+
+/********************************************************************************************
+ * StaticSite                                                                               *
+ * @brief Site policy of the specialized tick loop, the state machine is a compile time     *
+ *        constant.                                                                         *
+ ********************************************************************************************/
+template<SiteConfig Site>
+struct StaticSite {
+
+    /* State machine of the site, folded into the tick loop                                 */
+    static constexpr TruckTransitionTable transitions = make_truck_transitions(Site);
+};
+
+/********************************************************************************************
+ * DynamicSite                                                                              *
+ * @brief Site policy of the generic tick loop, the state machine is read from the          *
+ *        simulation.                                                                       *
+ ********************************************************************************************/
+struct DynamicSite {
+
+    /* State machine of the site, built by the simulation                                   */
+    const TruckTransitionTable& transitions;
+};
+
+/********************************************************************************************
+ * StateFractions                                                                           *
+ * @brief Fraction of the simulation time (0.0 - 1.0) spent in each of the four recorded    *
+ *        categories, averaged across the fleet.                                            *
+ ********************************************************************************************/
+struct StateFractions {
+    double waiting;
+    double unloading;
+    double traveling;
+    double mining;
+};
+
 /********************************************************************************************
  * Station                                                                                  *
  * @brief Represents a station in the simulation where trucks can wait and unload.          *
@@ -58,6 +213,11 @@ enum class TruckState {
  * The Station class models the behavior of a station, tracking the number of trucks        *
  * currently in the station's queue and the total number of trucks that have been           *
  * unloaded at the station.                                                                 *
+ *                                                                                          *
+ * A station unloads one truck per tick, so rather than counting its queue down every tick  *
+ * it stores the tick at which its queue runs empty, and the queue at any tick follows from *
+ * it as max(0, empty tick - tick). Only the stations trucks actually queue at are touched, *
+ * which keeps thousands of idle stations free.                                             *
  ********************************************************************************************/
 class Station {
 public:
@@ -98,53 +258,63 @@ public:
      * get_queue                                                                            *
      * @brief Retrieves the current number of trucks in the station's queue.                *
      *                                                                                      *
-     * This function returns the current value of the station's queue, which represents     *
-     * the number of trucks waiting at the station.                                         *
+     * This function returns the number of trucks waiting at the station at the given       *
+     * tick, computed from the tick at which the queue runs empty.                          *
      *                                                                                      *
-     * @param: None                                                                         *
+     * @param tick: The number of ticks the simulation has run.                             *
      * @return: uint16_t - The number of trucks currently in the station's queue.           *
      ****************************************************************************************/
-    uint16_t get_queue();
+    uint16_t get_queue(uint32_t tick);
 
     /****************************************************************************************
      * increment_queue                                                                      *
      * @brief Increases the station's queue count by one.                                   *
      *                                                                                      *
-     * This function increments the `queue` variable by one, representing the arrival of    *
-     * a new truck at the station.                                                          *
+     * This function pushes the tick at which the queue runs empty back by one tick,        *
+     * representing the arrival of a new truck at the station. An empty queue starts        *
+     * over from the given tick.                                                            *
      *                                                                                      *
-     * @param: None                                                                         *
+     * @param tick: The number of ticks the simulation has run.                             *
      * @return: None                                                                        *
      ****************************************************************************************/
-    void increment_queue();
+    void increment_queue(uint32_t tick);
 
     /****************************************************************************************
-     * decrement_queue                                                                      *
-     * @brief Decreases the station's queue count by one, ensuring it doesn't go below zero.*
+     * increment_trucks_unloaded                                                            *
+     * @brief Increments the count of trucks that have been unloaded at the station.        *
      *                                                                                      *
-     * This function decrements the `queue` variable by one, representing the departure of  *
-     * a truck from the station. If the queue is already at zero, it remains unchanged.     *
+     * This function increments the `num_trucks_unloaded` variable by one, representing     *
+     * another truck that has successfully unloaded at the station.                         *
      *                                                                                      *
      * @param: None                                                                         *
      * @return: None                                                                        *
      ****************************************************************************************/
-    void decrement_queue();
+    void increment_trucks_unloaded();
 
     /****************************************************************************************
-     * increment_trucks_unloaded                                                            *
-     * @brief Increments the count of trucks that have been unloaded at the station.        *
+     * get_trucks_unloaded                                                                  *
+     * @brief Retrieves the count of trucks that have been unloaded at the station.         *
      *                                                                                      *
-     * This function increments the `num_trucks_unloaded` variable by one, representing     *
-     * another truck that has successfully unloaded at the station.                         *
+     * @param: None                                                                         *
+     * @return: uint16_t - The number of trucks unloaded.                                   *
+     ****************************************************************************************/
+    uint16_t get_trucks_unloaded();
+
+    /****************************************************************************************
+     * reset_trucks_unloaded                                                                *
+     * @brief Resets the count of trucks that have been unloaded at the station.            *
+     *                                                                                      *
+     * Used to discard the statistics gathered during the warm-up of a simulation. The      *
+     * queue is left untouched since it is part of the simulation's state.                  *
      *                                                                                      *
      * @param: None                                                                         *
      * @return: None                                                                        *
      ****************************************************************************************/
-    void increment_trucks_unloaded();
+    void reset_trucks_unloaded();
 
 private:
-    /* Number of trucks currently in the station's queue                                    */
-    uint16_t queue;
+    /* Tick at which the last truck in the station's queue has been unloaded                */
+    uint32_t empty_tick;
     /* Total number of trucks that have been unloaded at this station                       */
     uint16_t num_trucks_unloaded;
 };
@@ -178,14 +348,15 @@ public:
      *   Unloading, Waiting) during the simulation.                                         *
      * - `station_idx`: Initialized to 0, used to track which station the truck             *
      *    is unloading/queued at.                                                           *
-     * - `timer`: This value is initialized by drawing a random time duration from          *
-     *   a uniform distribution between 1 and 5 hours with a scaling of 5 mins/bit          *
-     *   using the `rmt` distribution and `gen` random number generator.                    *
+     * - `timer`: Initialized to the first mining time, which the owning simulation         *
+     *   draws from its mining time distribution.                                           *
+     * - `mine_idx`: The mine site the truck works at, only used with several sites.        *
      *                                                                                      *
-     * @param: None                                                                         *
+     * @param mining_time: The number of ticks the truck spends in its first Mining state.  *
+     * @param mine_idx: Optional index of the truck's mine site, defaults to the only one.  *
      * @return: None                                                                        *
      ****************************************************************************************/
-    Truck();
+    explicit Truck(uint16_t mining_time, uint16_t mine_idx = 0);
 
     /****************************************************************************************
      * ~Truck                                                                               *
@@ -246,13 +417,55 @@ public:
      *                                                                                      *
      * @param stations: A reference to a vector of Station objects, which represent         *
      *                  the stations where trucks can wait and unload.                      *
-     * @param curr_idx: A reference to the current index in the stations vector,            *
-     *                  used to track which station the truck is interacting with.          *
+     * @param tick: The number of ticks the simulation has run, see `Station::get_queue`.   *
+     * @param selector: The station selection policy, asked for a station when the truck    *
+     *                  arrives at the stations.                                            *
+     * @param mining_time: The mining time distribution policy, drawn from when the truck   *
+     *                     arrives back at the mines.                                       *
+     * @param gen: The random number generator owned by the simulation.                     *
+     * @param transitions: The state machine of the site, see `make_truck_transitions`.     *
      *                                                                                      *
      * @return: None                                                                        *
-     * @throws: std::runtime_error if an unexpected state is encountered.                   *
      ****************************************************************************************/
-    void run(std::vector<Station>& stations, size_t& curr_idx);
+    template<typename MiningTime, typename Selector>
+    void run(std::pmr::vector<Station>& stations, uint32_t tick, Selector& selector,
+             MiningTime& mining_time, std::mt19937& gen,
+             const TruckTransitionTable& transitions = TRUCK_TRANSITIONS);
+
+    /****************************************************************************************
+     * run_local                                                                            *
+     * @brief Advances the truck by one tick without touching anything outside of it.       *
+     *                                                                                      *
+     * This is the part of `run` that only depends on the truck's own state. Whenever the   *
+     * truck needs something shared to finish its transition, the transition is left for    *
+     * `resolve` and reported as an event. Since it never touches shared state, any number  *
+     * of trucks can run this concurrently.                                                 *
+     *                                                                                      *
+     * @param transitions: The state machine of the site, see `make_truck_transitions`.     *
+     * @return: TruckEvent - The event `resolve` has to apply for this tick.                *
+     ****************************************************************************************/
+    TruckEvent run_local(const TruckTransitionTable& transitions = TRUCK_TRANSITIONS);
+
+    /****************************************************************************************
+     * resolve                                                                              *
+     * @brief Applies the event reported by `run_local` to the shared simulation state.     *
+     *                                                                                      *
+     * Events have to be resolved in truck index order within a tick to reproduce the       *
+     * results of the serial tick loop exactly.                                             *
+     *                                                                                      *
+     * @param event: The event returned by `run_local` for this tick.                       *
+     * @param stations: A reference to a vector of Station objects, which represent         *
+     *                  the stations where trucks can wait and unload.                      *
+     * @param tick: The number of ticks the simulation has run, see `Station::get_queue`.   *
+     * @param selector: The station selection policy, asked for a station when the truck    *
+     *                  arrives at the stations.                                            *
+     * @param mining_time: The mining time distribution policy.                             *
+     * @param gen: The random number generator owned by the simulation.                     *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename MiningTime, typename Selector>
+    void resolve(TruckEvent event, std::pmr::vector<Station>& stations, uint32_t tick,
+                 Selector& selector, MiningTime& mining_time, std::mt19937& gen);
 
     /****************************************************************************************
      * get_total_time                                                                       *
@@ -268,6 +481,131 @@ public:
      ****************************************************************************************/
     uint64_t get_total_time();
 
+    /****************************************************************************************
+     * get_state                                                                            *
+     * @brief Retrieves the state the truck is currently in.                                *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: TruckState - The truck's current state.                                     *
+     ****************************************************************************************/
+    TruckState get_state();
+
+    /****************************************************************************************
+     * get_station_idx                                                                      *
+     * @brief Retrieves the station the truck is heading to, queued at or last unloaded at. *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: size_t - The index of the station.                                          *
+     ****************************************************************************************/
+    size_t get_station_idx();
+
+    /****************************************************************************************
+     * get_mine_idx                                                                         *
+     * @brief Retrieves the mine site the truck works at.                                   *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: uint16_t - The index of the mine site.                                      *
+     ****************************************************************************************/
+    uint16_t get_mine_idx();
+
+    /****************************************************************************************
+     * depart                                                                               *
+     * @brief Sends a truck that has finished mining to the given station.                  *
+     *                                                                                      *
+     * Used by simulations with several sites, where the station is picked when the truck   *
+     * leaves the mines since the travel time depends on it.                                *
+     *                                                                                      *
+     * @param station_idx: The index of the station the truck unloads at.                   *
+     * @param travel_time: The ticks it takes to get there.                                 *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void depart(size_t station_idx, uint16_t travel_time);
+
+    /****************************************************************************************
+     * join_queue                                                                           *
+     * @brief Queues a truck that has arrived at its station behind the trucks already      *
+     *        there.                                                                        *
+     *                                                                                      *
+     * @param station: The station the truck has arrived at.                                *
+     * @param tick: The number of ticks the simulation has run.                             *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void join_queue(Station& station, uint32_t tick);
+
+    /****************************************************************************************
+     * head_home                                                                            *
+     * @brief Sets the time a truck that has finished unloading takes back to its mine.     *
+     *                                                                                      *
+     * @param travel_time: The ticks it takes to get back.                                  *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void head_home(uint16_t travel_time);
+
+    /****************************************************************************************
+     * start_mining                                                                         *
+     * @brief Starts mining for the given time once the truck is back at its mine.          *
+     *                                                                                      *
+     * @param mining_time: The ticks the truck spends mining.                               *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void start_mining(uint16_t mining_time);
+
+    /****************************************************************************************
+     * wait_for_bay                                                                         *
+     * @brief Holds a truck that has arrived at a station with every bay taken.             *
+     *                                                                                      *
+     * Used by simulations with multi-bay stations, where the station starts the truck      *
+     * unloading once a bay frees up, so the wait does not count down.                      *
+     *                                                                                      *
+     * @param station_idx: The index of the station the truck queues at.                    *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void wait_for_bay(size_t station_idx);
+
+    /****************************************************************************************
+     * start_unloading                                                                      *
+     * @brief Starts unloading a truck in a bay of the given station.                       *
+     *                                                                                      *
+     * @param station_idx: The index of the station the truck unloads at.                   *
+     * @param unload_time: The ticks the truck takes to unload, at least one.               *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void start_unloading(size_t station_idx, uint16_t unload_time);
+
+    /****************************************************************************************
+     * reset_total_time                                                                     *
+     * @brief Clears the time recorded in every category.                                   *
+     *                                                                                      *
+     * Used to discard the statistics gathered during the warm-up of a simulation. The      *
+     * truck's state and timer are left untouched, so it carries on where it was.           *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void reset_total_time();
+
+    /****************************************************************************************
+     * get_ticks_left                                                                       *
+     * @brief Retrieves the number of ticks the truck runs before its timer expires.        *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: uint16_t - The ticks left, counting the tick the timer expires in.          *
+     ****************************************************************************************/
+    uint16_t get_ticks_left();
+
+    /****************************************************************************************
+     * leap                                                                                 *
+     * @brief Advances the truck by several ticks at once, none of which expire its timer.  *
+     *                                                                                      *
+     * The truck records the ticks and counts its timer down exactly as `run_local` would   *
+     * over the same ticks, in a single step.                                               *
+     *                                                                                      *
+     * @param ticks: The number of ticks, less than `get_ticks_left`.                       *
+     * @param transitions: The state machine of the site, see `make_truck_transitions`.     *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void leap(uint16_t ticks, const TruckTransitionTable& transitions = TRUCK_TRANSITIONS);
+
 private:
 
     /* Current truck state                                                                  */
@@ -276,6 +614,9 @@ private:
     /* Timer to keep track of the current time left to spend in a particular state          */
     uint16_t timer;
 
+    /* Mine site the truck works at, fits in the padding before `total_time`                */
+    uint16_t mine_idx;
+
     /****************************************************************************************
      * I've decided to store all the data into one 64 bit unsigned integer. Each timer can  *
      * be stored using 16 bits, which is perfect for tracking the time of the 4 categories  *
@@ -298,6 +639,66 @@ private:
     size_t station_idx;
 };
 
+/********************************************************************************************
+ * FixedHorizon                                                                             *
+ * @brief Tick loop observer that stops the simulation after a fixed number of ticks.       *
+ *                                                                                          *
+ * The tick loop calls its observer's `observe` with every truck right before the truck     *
+ * runs, and `next_tick` before every tick, stopping as soon as `next_tick` returns false.  *
+ * This observer ignores the trucks and only counts down, which is the original fixed       *
+ * horizon behavior of the simulator. Since the tick loop is instantiated per observer,     *
+ * the empty `observe` compiles away entirely.                                              *
+ *                                                                                          *
+ * When no truck changes state for a while, `Simulation`'s tick loop asks its observer's    *
+ * `leap` how many of those ticks it may skip. An observer that has to see every tick       *
+ * returns 0, this one lets the loop skip as many as are left. The blocked tick loop (see   *
+ * `run_blocked_engine`) asks the same before every window of ticks whose trucks it does    *
+ * not show to the observer.                                                                *
+ ********************************************************************************************/
+class FixedHorizon {
+public:
+    /****************************************************************************************
+     * FixedHorizon Constructor                                                             *
+     * @brief Initializes the observer with the number of ticks to run.                     *
+     *                                                                                      *
+     * @param ticks: The number of ticks the simulation runs for.                           *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    explicit FixedHorizon(size_t ticks);
+
+    /****************************************************************************************
+     * observe                                                                              *
+     * @brief Called with every truck before it runs, does nothing for a fixed horizon.     *
+     *                                                                                      *
+     * @param truck: The truck about to run.                                                *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void observe(Truck& truck);
+
+    /****************************************************************************************
+     * next_tick                                                                            *
+     * @brief Called before every tick, counts down the remaining ticks.                    *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: bool - True while there are ticks left to run.                              *
+     ****************************************************************************************/
+    bool next_tick();
+
+    /****************************************************************************************
+     * leap                                                                                 *
+     * @brief Called instead of `next_tick` and `observe` for ticks in which no truck       *
+     *        changes state, counts them down all at once.                                  *
+     *                                                                                      *
+     * @param ticks: The number of ticks the tick loop would like to skip.                  *
+     * @return: size_t - The number of ticks it may skip, at most the ticks left to run.    *
+     ****************************************************************************************/
+    size_t leap(size_t ticks);
+
+private:
+    /* Number of ticks left to run                                                          */
+    size_t remaining;
+};
+
 /********************************************************************************************
  * Simulation                                                                               *
  * @brief Manages the overall simulation of trucks and stations, orchestrating the          *
@@ -306,8 +707,8 @@ private:
  * The Simulation class is responsible for running a simulation that models the             *
  * behavior of trucks as they transition through various states (Mining, Traveling,         *
  * Waiting, Unloading) while interacting with stations. The class maintains a               *
- * collection of trucks and stations, tracks the current station index for                  *
- * round-robin assignment, and handles the timing and logging of events throughout          *
+ * collection of trucks and stations, holds the station selection policy (round-robin       *
+ * assignment by default), and handles the timing and logging of events throughout          *
  * the simulation.                                                                          *
  *                                                                                          *
  * Key Features:                                                                            *
@@ -315,8 +716,9 @@ private:
  *   initializing them based on user-defined parameters.                                    *
  * - **Round-Robin Assignment**: Distributes trucks evenly across stations using a          *
  *   round-robin strategy to prevent bottlenecks and ensure balanced load distribution.     *
- * - **Queue Management**: Decrements the queue sizes of stations uniformly after each      *
- *   simulation step, simulating the processing of trucks at stations.                      *
+ * - **Queue Management**: Shortens the queues of all stations uniformly after each         *
+ *   simulation step, simulating the processing of trucks at stations, by counting the      *
+ *   ticks rather than decrementing every queue.                                            *
  * - **Simulation Control**: Runs the simulation for a fixed number of iterations,          *
  *   controlling the flow of time and the progression of truck activities.                  *
  * - **Logging and Debugging**: Provides detailed logging of truck and station              *
@@ -333,17 +735,33 @@ public:
      *        stations, and sets up the initial simulation parameters.                      *
      *                                                                                      *
      * This constructor initializes the Simulation with a specified number of trucks and    *
-     * stations. It also sets the initial station index and the total simulation time.      *
-     * Optionally, debugging mode can be enabled to perform additional checks during the    *
-     * simulation.                                                                          *
+     * stations. It also sets up the station selection policy and the total simulation      *
+     * time. Optionally, debugging mode can be enabled to perform additional checks         *
+     * during the simulation.                                                               *
      *                                                                                      *
      * @param num_trucks: The number of trucks to be simulated.                             *
      * @param num_stations: The number of stations available in the simulation.             *
      * @param debug: Optional parameter that enables debug mode if set to true. Debug mode  *
      *               performs additional consistency checks during the simulation.          *
+     * @param mining_time: Optional distribution of mining times, defaults to the uniform   *
+     *                     distribution between the site's mining time bounds.              *
+     * @param seed: Optional seed of the simulation's random number generator, defaults     *
+     *              to a non-deterministic seed.                                            *
+     * @param memory: Optional resource the trucks and stations are stored in, e.g. an      *
+     *                arena reused across replications, or a FirstTouchResource to place    *
+     *                the trucks on the NUMA nodes of the workers that run them.            *
+     * @param site: Optional site the simulation runs at, defaults to the standard site.    *
+     * @param selection: Optional station selection policy, defaults to round robin.        *
      * @return: None                                                                        *
      ****************************************************************************************/
-    Simulation(uint16_t num_trucks, uint16_t num_stations, bool debug = false);
+    Simulation(uint16_t num_trucks,
+               uint16_t num_stations,
+               bool debug = false,
+               std::optional<MiningTimeDistribution> mining_time = std::nullopt,
+               uint32_t seed = std::random_device{}(),
+               std::pmr::memory_resource* memory = std::pmr::get_default_resource(),
+               const SiteConfig& site = STANDARD_SITE,
+               SelectionPolicy selection = SelectionPolicy::RoundRobin);
 
     /****************************************************************************************
      * ~Simulation                                                                          *
@@ -358,6 +776,18 @@ public:
      ****************************************************************************************/
     ~Simulation();
 
+    /****************************************************************************************
+     * storage_bytes                                                                        *
+     * @brief Computes the memory a simulation allocates from its memory resource.          *
+     *                                                                                      *
+     * @param num_trucks: The number of trucks to be simulated.                             *
+     * @param num_stations: The number of stations available in the simulation.             *
+     * @param selection: The station selection policy of the simulation.                    *
+     * @return: size_t - The bytes needed, including the worst case alignment padding.      *
+     ****************************************************************************************/
+    static size_t storage_bytes(uint16_t num_trucks, uint16_t num_stations,
+                                SelectionPolicy selection = SelectionPolicy::RoundRobin);
+
     /****************************************************************************************
      * run_sim                                                                              *
      * @brief Executes the simulation, running all trucks through their respective states   *
@@ -370,11 +800,11 @@ public:
      *    various states (Mining, Traveling, Waiting, Unloading).                           *
      *                                                                                      *
      * 3. If debugging mode is enabled, consistency checks are performed after each truck   *
-     *    runs, ensuring the current station index matches the station with the minimum     *
-     *    queue size.                                                                       *
+     *    runs, ensuring the station the selection policy picks next is the station with    *
+     *    the minimum queue size.                                                           *
      *                                                                                      *
-     * 4. After processing all trucks, decrements the queue count for each station,         *
-     *    ensuring that no queue falls below zero.                                          *
+     * 4. After processing all trucks, moves the tick on, which shortens the queue of       *
+     *    every station by one without touching the stations (see `Station`).               *
      *                                                                                      *
      * 5. Decrements the simulation time and repeats until the simulation time reaches zero.*
      *                                                                                      *
@@ -389,8 +819,123 @@ public:
      ****************************************************************************************/
     void run_sim();
 
-    /* Store the index of the station queue with the shortest wait time                     */
-    size_t curr_station_idx;
+    /****************************************************************************************
+     * simulate                                                                             *
+     * @brief Runs the tick loop of the simulation without logging the results.             *
+     *                                                                                      *
+     * This is the part of `run_sim` that advances the trucks and stations. It is used on   *
+     * its own when the results are consumed programmatically, e.g. when comparing the      *
+     * simulation against the analytic estimate.                                            *
+     *                                                                                      *
+     * If a warm-up is set, the simulation first runs for that many ticks and then resets   *
+     * its statistics, so the results only cover the following `total_time` ticks.          *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void simulate();
+
+    /****************************************************************************************
+     * simulate                                                                             *
+     * @brief Runs the tick loop of the simulation until the observer stops it.             *
+     *                                                                                      *
+     * The observer sees every truck before it runs and decides before every tick whether   *
+     * the simulation continues (see `FixedHorizon`). This lets the length of a run be      *
+     * decided while it is running, e.g. until the results reach steady state, without      *
+     * adding any work to the tick loop of a fixed horizon run.                             *
+     *                                                                                      *
+     * @param observer: The tick loop observer.                                             *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename Observer>
+    void simulate(Observer& observer);
+
+    /****************************************************************************************
+     * logging                                                                              *
+     * @brief Logs the operational statistics of every truck and station.                   *
+     *                                                                                      *
+     * If debugging mode is enabled, additional checks are performed to verify that the     *
+     * total time recorded for each truck matches the total simulation time.                *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void logging();
+
+    /****************************************************************************************
+     * reset                                                                                *
+     * @brief Puts the simulation back to its initial state for a new replication,          *
+     *        reusing the storage of the current one.                                       *
+     *                                                                                      *
+     * Reseeds the random number generator, empties the stations and redraws the mining     *
+     * time of every truck, exactly as constructing a new Simulation with the same          *
+     * parameters would. The stations and trucks are only reallocated when there are more   *
+     * of them than before, so back-to-back replications of the same size allocate          *
+     * nothing. The debug flag, mining time distribution, site, total and warm-up time are  *
+     * kept.                                                                                *
+     *                                                                                      *
+     * @param seed: The seed of the new replication.                                        *
+     * @param num_trucks: The number of trucks to be simulated.                             *
+     * @param num_stations: The number of stations available in the simulation.             *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void reset(uint32_t seed, uint16_t num_trucks, uint16_t num_stations);
+
+    /****************************************************************************************
+     * reset_statistics                                                                     *
+     * @brief Discards the time recorded by every truck and the unload count of every       *
+     *        station, without changing the state of the simulation.                        *
+     *                                                                                      *
+     * Every truck starts out mining with a freshly drawn timer, so the first hours of a    *
+     * simulation are a transient that biases the reported percentages. Resetting the       *
+     * statistics once that transient has passed leaves only steady state behavior in       *
+     * the results.                                                                         *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void reset_statistics();
+
+    /****************************************************************************************
+     * get_state_fractions                                                                  *
+     * @brief Computes the fraction of time the fleet spent in each category.               *
+     *                                                                                      *
+     * Unpacks the time recorded by every truck and averages it across the fleet,           *
+     * relative to the total simulation time.                                               *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: StateFractions - The fleet-wide fraction of time spent in each category.    *
+     ****************************************************************************************/
+    StateFractions get_state_fractions();
+
+    /****************************************************************************************
+     * set_warmup_time                                                                      *
+     * @brief Sets the number of ticks run before `total_time` whose statistics are         *
+     *        discarded.                                                                    *
+     *                                                                                      *
+     * Without a warm-up, a fixed horizon run records from the first tick, and              *
+     * `run_until_steady` detects the warm-up itself.                                       *
+     *                                                                                      *
+     * @param ticks: The warm-up in ticks, 0 for none.                                      *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void set_warmup_time(uint16_t ticks);
+
+    /****************************************************************************************
+     * get_warmup_time                                                                      *
+     * @brief Retrieves the number of ticks run before `total_time` whose statistics are    *
+     *        discarded.                                                                    *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: uint16_t - The warm-up in ticks, 0 for none.                                *
+     ****************************************************************************************/
+    uint16_t get_warmup_time() const;
+
+    /* Policy picking the station each arriving truck queues at                             */
+    StationSelector selector;
+
+    /* Number of ticks run since the simulation was set up or reset, see `Station`          */
+    uint32_t tick;
 
     /* Store the total execution time of the simulation                                     */
     uint16_t total_time;
@@ -399,12 +944,550 @@ public:
     bool debug;
 
     /* list of stations                                                                     */
-    std::vector<Station> stations;
+    std::pmr::vector<Station> stations;
 
     /* list of trucks                                                                       */
-    std::vector<Truck> trucks;
+    std::pmr::vector<Truck> trucks;
+
+    /* Distribution the trucks draw their mining times from                                 */
+    MiningTimeDistribution mining_time;
+
+    /* Mersenne Twister pseudorandom number generator used for every draw                   */
+    std::mt19937 gen;
+
+    /* Site the simulation runs at, and the truck state machine built from it               */
+    SiteConfig site;
+    TruckTransitionTable transitions;
+
+private:
+
+    /****************************************************************************************
+     * run_engine                                                                           *
+     * @brief Runs the tick loop with the mining time distribution, the observer and the    *
+     *        consistency checks fixed at compile time.                                     *
+     *                                                                                      *
+     * `simulate` selects the active alternative of `mining_time` once and calls into this  *
+     * function, so each distribution gets its own instantiation of the tick loop and the   *
+     * draw in `Truck::run` is inlined rather than dispatched per truck.                    *
+     * The checks are selected the same way, so the release loop has no debug branches,     *
+     * and so are the site, so the standard site's times are folded into its loop, and the  *
+     * station selection policy.                                                            *
+     *                                                                                      *
+     * @param mining_time: The active mining time distribution policy.                      *
+     * @param selector: The active station selection policy.                                *
+     * @param observer: The tick loop observer.                                             *
+     * @param checks: The consistency check policy, see `select_checks`.                    *
+     * @param site: The site policy, see `select_site`.                                     *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename MiningTime, typename Selector, typename Observer, typename Checks,
+             typename Site>
+    void run_engine(MiningTime& mining_time, Selector& selector, Observer& observer,
+                    Checks checks, Site site);
+
+    /****************************************************************************************
+     * leap                                                                                 *
+     * @brief Advances the trucks and the stations by several ticks at once, none of which  *
+     *        expire a truck's timer.                                                       *
+     *                                                                                      *
+     * Kept out of line, like `get_next_expiry`, so the rarely taken leap does not crowd    *
+     * the trucks' tick out of the tick loop when the compiler decides what to inline.      *
+     *                                                                                      *
+     * @param ticks: The number of ticks, less than the ticks left of every truck.          *
+     * @param transitions: The state machine of the site, see `make_truck_transitions`.     *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void leap(uint16_t ticks, const TruckTransitionTable& transitions);
+
+    /****************************************************************************************
+     * get_next_expiry                                                                      *
+     * @brief Retrieves the number of ticks until the first truck's timer expires.          *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: uint16_t - The fewest ticks left of any truck, UINT16_MAX without trucks.   *
+     ****************************************************************************************/
+    uint16_t get_next_expiry();
+
+    /* Number of ticks run before `total_time` whose statistics are discarded               */
+    uint16_t warmup_time;
 };
 
+/********************************************************************************************
+ * Statistics Functions                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * fleet_state_fractions                                                                    *
+ * @brief Computes the fraction of time a fleet spent in each category.                     *
+ *                                                                                          *
+ * @param trucks: The trucks of the fleet.                                                  *
+ * @param total_time: The ticks the statistics were recorded over.                          *
+ * @return: StateFractions - The fleet-wide fraction of time spent in each category.        *
+ ********************************************************************************************/
+StateFractions fleet_state_fractions(std::pmr::vector<Truck>& trucks, uint16_t total_time);
+
+/********************************************************************************************
+ * Site Functions                                                                           *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * validate_site                                                                            *
+ * @brief Verifies that a site can be simulated.                                            *
+ *                                                                                          *
+ * The travel time is loaded into the truck's timer and counted down to zero, so a zero     *
+ * travel time would wrap the timer, and a zero horizon leaves nothing to simulate.         *
+ *                                                                                          *
+ * @param site: The site to verify.                                                         *
+ * @return: None                                                                            *
+ * @throws: std::invalid_argument if the travel time or the horizon is zero.                *
+ ********************************************************************************************/
+void validate_site(const SiteConfig& site);
+
+/********************************************************************************************
+ * site_mining_time                                                                         *
+ * @brief Creates the default mining time distribution of a site.                           *
+ *                                                                                          *
+ * @param site: The site whose mining time bounds are used.                                 *
+ * @return: MiningTimeDistribution - The uniform distribution between the site's bounds.    *
+ * @throws: std::invalid_argument if the bounds are empty or contain zero.                  *
+ ********************************************************************************************/
+MiningTimeDistribution site_mining_time(const SiteConfig& site);
+
+/********************************************************************************************
+ * select_site                                                                              *
+ * @brief Calls `body` with the specialized site policy if `site` is a site the tick loop   *
+ *        has been compiled for, and with the generic one otherwise.                        *
+ *                                                                                          *
+ * @param site: The site of the simulation.                                                 *
+ * @param transitions: The state machine built from `site`, used by the generic policy.     *
+ * @param body: Called with a `StaticSite` or a `DynamicSite` object.                       *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename Body>
+void select_site(const SiteConfig& site, const TruckTransitionTable& transitions,
+                 Body&& body);
+
+/********************************************************************************************
+ * Template and Inline Definitions                                                          *
+ ********************************************************************************************/
+
+/* The tick loop runs the debug checks, which need the classes declared above               */
+#ifndef TESTING_HPP
+#include "../include/testing.hpp"
+#endif
+
+/********************************************************************************************
+ * FixedHorizon::observe                                                                    *
+ * @brief Called with every truck before it runs, does nothing for a fixed horizon.         *
+ *                                                                                          *
+ * @param truck: The truck about to run.                                                    *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+inline void FixedHorizon::observe(Truck&) {}
+
+/********************************************************************************************
+ * FixedHorizon::next_tick                                                                  *
+ * @brief Called before every tick, counts down the remaining ticks.                        *
+ *                                                                                          *
+ * @param: None                                                                             *
+ * @return: bool - True while there are ticks left to run.                                  *
+ ********************************************************************************************/
+inline bool FixedHorizon::next_tick() {
+
+    if(this->remaining == 0) {
+        return false;
+    }
+    this->remaining--;
+
+    return true;
+}
+
+/********************************************************************************************
+ * FixedHorizon::leap                                                                       *
+ * @brief Called instead of `next_tick` and `observe` for ticks in which no truck changes   *
+ *        state, counts them down all at once.                                              *
+ *                                                                                          *
+ * @param ticks: The number of ticks the tick loop would like to skip.                      *
+ * @return: size_t - The number of ticks it may skip, at most the ticks left to run.        *
+ ********************************************************************************************/
+inline size_t FixedHorizon::leap(size_t ticks) {
+
+    size_t skipped = std::min(ticks, this->remaining);
+
+    this->remaining -= skipped;
+
+    return skipped;
+}
+
+/********************************************************************************************
+ * select_site                                                                              *
+ * @brief Calls `body` with the specialized site policy if `site` is a site the tick loop   *
+ *        has been compiled for, and with the generic one otherwise.                        *
+ *                                                                                          *
+ * Each specialized site costs one more instantiation of every tick loop, so only sites     *
+ * that are run regularly should be added here.                                             *
+ *                                                                                          *
+ * @param site: The site of the simulation.                                                 *
+ * @param transitions: The state machine built from `site`, used by the generic policy.     *
+ * @param body: Called with a `StaticSite` or a `DynamicSite` object.                       *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename Body>
+void select_site(const SiteConfig& site, const TruckTransitionTable& transitions,
+                 Body&& body) {
+
+    if(STANDARD_SITE == site) {
+        body(StaticSite<STANDARD_SITE>{});
+    }
+    else {
+        body(DynamicSite{transitions});
+    }
+}
+
+/********************************************************************************************
+ * Simulation::simulate                                                                     *
+ * @brief Runs the tick loop of the simulation until the observer stops it.                 *
+ *                                                                                          *
+ * @param observer: The tick loop observer.                                                 *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename Observer>
+void Simulation::simulate(Observer& observer) {
+
+    /* Select the distribution, the selection policy, the checks and the site once, outside  *
+     * of the tick loop                                                                     */
+    std::visit([this, &observer](auto& dist, auto& selector) {
+        select_checks(this->debug, [&](auto checks) {
+            select_site(this->site, this->transitions, [&](auto site) {
+                this->run_engine(dist, selector, observer, checks, site);
+            });
+        });
+    }, this->mining_time, this->selector);
+}
+
+/********************************************************************************************
+ * Simulation::run_engine                                                                   *
+ * @brief Runs the tick loop with the mining time distribution, the observer and the        *
+ *        consistency checks fixed at compile time.                                         *
+ *                                                                                          *
+ * Between timer expiries a truck only records its time and counts its timer down, and the  *
+ * station queues move on with the tick by themselves. So after a tick the loop may look    *
+ * for the nearest expiry, and the ticks before it are leapt over in one pass over the      *
+ * trucks, as far as the observer allows. The ticks that do expire a timer are still run    *
+ * truck by truck, so the results are exactly those of running every tick.                  *
+ *                                                                                          *
+ * A large fleet has a timer expiring almost every tick, so looking costs more than it      *
+ * saves. Every look that finds nothing to leap over doubles the ticks until the next one,  *
+ * up to LEAP_BACKOFF, and a leap brings the loop back to looking every tick.               *
+ *                                                                                          *
+ * @param mining_time: The active mining time distribution policy.                          *
+ * @param selector: The active station selection policy.                                    *
+ * @param observer: The tick loop observer.                                                 *
+ * @param checks: The consistency check policy, see `select_checks`.                        *
+ * @param site: The site policy, see `select_site`.                                         *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename MiningTime, typename Selector, typename Observer, typename Checks,
+         typename Site>
+void Simulation::run_engine(MiningTime& mining_time, Selector& selector, Observer& observer,
+                            Checks checks, Site site) {
+
+    /* Ticks until the next look for ticks to leap over, and the ticks between two looks    */
+    uint32_t next_look = 1;
+    uint32_t backoff = 1;
+
+    /* Each iteration is one tick, the observer decides when the simulation ends            */
+    while(observer.next_tick()) {
+
+        /* Run through all the trucks                                                       */
+        for(auto& truck: trucks) {
+
+            observer.observe(truck);
+
+            truck.run(stations, tick, selector, mining_time, gen, site.transitions);
+
+            checks.check_selection(stations, tick, selector);
+        }
+
+        /* Every station unloaded a truck, which moves all the queues on at once            */
+        tick++;
+
+        if(--next_look > 0) {
+            continue;
+        }
+
+        /* Nothing happens before the next expiry, leap to the tick it happens in           */
+        uint16_t next_expiry = this->get_next_expiry();
+        size_t skipped = (next_expiry > 1) ? observer.leap(next_expiry - 1) : 0;
+
+        if(skipped) {
+            this->leap(static_cast<uint16_t>(skipped), site.transitions);
+        }
+
+        /* Look less often while there is nothing to leap over                              */
+        backoff = skipped ? 1 : std::min(2 * backoff, LEAP_BACKOFF);
+        next_look = backoff;
+    }
+}
+
+/********************************************************************************************
+ * run                                                                                      *
+ * @brief Simulates the operations of a truck as it transitions through                     *
+ *        different states (Mining, Traveling, Waiting, Unloading).                         *
+ *                                                                                          *
+ * This function updates the state of the truck based on its current activity               *
+ * (e.g., mining, traveling to a station, waiting at a station, or unloading).              *
+ * The truck's state and timers are adjusted accordingly, with each state                   *
+ * decrementing its associated timer and updating the truck's cumulative time               *
+ * (`total_time`) using predefined bitwise increments.                                      *
+ *                                                                                          *
+ * The truck can transition between the following states:                                   *
+ * - `Mining`: Decrements mining time and switches to traveling to a station                *
+ *   when mining is complete.                                                               *
+ * - `TravelStation`: Decrements travel time to the station and determines                  *
+ *   whether the truck should wait or unload upon arrival.                                  *
+ * - `Waiting`: Decrements the waiting time before the truck can begin unloading.           *
+ * - `Unloading`: Increments unloading time, updates the station's unloaded                 *
+ *   truck count, and then transitions back to traveling towards the mining                 *
+ *   area.                                                                                  *
+ * - `TravelMining`: Decrements travel time to the mining area, then returns                *
+ *   the truck to the mining state.                                                         *
+ *                                                                                          *
+ * The function also manages the station queue by updating the queue count                  *
+ * when a truck arrives and increments the number of trucks unloaded after                  *
+ * unloading.                                                                               *
+ *                                                                                          *
+ * @param stations: A reference to a vector of Station objects, which represent             *
+ *                  the stations where trucks can wait and unload.                          *
+ * @param tick: The number of ticks the simulation has run, see `Station::get_queue`.       *
+ * @param selector: The station selection policy, asked for a station when the truck        *
+ *                  arrives at the stations.                                                *
+ * @param mining_time: The mining time distribution policy, drawn from when the truck       *
+ *                     arrives back at the mines.                                           *
+ * @param gen: The random number generator owned by the simulation.                         *
+ * @param transitions: The state machine of the site, see `make_truck_transitions`.         *
+ *                                                                                          *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename MiningTime, typename Selector>
+void Truck::run(std::pmr::vector<Station>& stations, uint32_t tick, Selector& selector,
+                MiningTime& mining_time, std::mt19937& gen,
+                const TruckTransitionTable& transitions) {
+
+    /* Advance the truck itself, then apply the event to the shared simulation state        */
+    this->resolve(this->run_local(transitions), stations, tick, selector, mining_time, gen);
+}
+
+/********************************************************************************************
+ * run_local                                                                                *
+ * @brief Advances the truck by one tick without touching anything outside of it.           *
+ *                                                                                          *
+ * This is the part of `run` that only depends on the truck's own state. Whenever the       *
+ * truck needs something shared to finish its transition, the transition is left for        *
+ * `resolve` and reported as an event:                                                      *
+ * - `Arrive`: the truck has arrived at the stations and needs one assigned.                *
+ * - `Unload`: the truck has finished unloading at `station_idx`.                           *
+ * - `Draw`: the truck has arrived at the mines and needs a mining time drawn.              *
+ * - `Depart`: the truck has finished mining and needs a station, with several sites.       *
+ *                                                                                          *
+ * Since it never touches shared state, any number of trucks can run this concurrently.     *
+ *                                                                                          *
+ * Each tick is one lookup in the transition table of the truck's state followed by         *
+ * selects, so there is no branch on the state and no unreachable state to throw on.        *
+ *                                                                                          *
+ * @param transitions: The state machine of the site, see `make_truck_transitions`.         *
+ * @return: TruckEvent - The event `resolve` has to apply for this tick.                    *
+ ********************************************************************************************/
+inline TruckEvent Truck::run_local(const TruckTransitionTable& transitions) {
+
+    const TruckTransition& transition = transitions[static_cast<size_t>(this->state)];
+
+    /* Record the tick and count the timer down, every state does the same                  */
+    this->total_time += transition.increment;
+    this->timer -= transition.countdown;
+
+    /* Selects rather than branches, so the compiler can keep this branchless               */
+    bool expired = (this->timer == 0);
+
+    this->state = expired ? transition.next : this->state;
+    this->timer = expired ? transition.reload : this->timer;
+
+    return expired ? transition.event : TruckEvent::None;
+}
+
+/********************************************************************************************
+ * resolve                                                                                  *
+ * @brief Applies the event reported by `run_local` to the shared simulation state.         *
+ *                                                                                          *
+ * Events have to be resolved in truck index order within a tick: arrivals read and         *
+ * update the station queues and the selection policy, and draws consume the shared         *
+ * random number generator, so resolving them in the same order as the serial tick loop     *
+ * reproduces its results exactly.                                                          *
+ *                                                                                          *
+ * @param event: The event returned by `run_local` for this tick.                           *
+ * @param stations: A reference to a vector of Station objects, which represent             *
+ *                  the stations where trucks can wait and unload.                          *
+ * @param tick: The number of ticks the simulation has run, see `Station::get_queue`.       *
+ * @param selector: The station selection policy, asked for a station when the truck        *
+ *                  arrives at the stations.                                                *
+ * @param mining_time: The mining time distribution policy.                                 *
+ * @param gen: The random number generator owned by the simulation.                         *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename MiningTime, typename Selector>
+void Truck::resolve(TruckEvent event, std::pmr::vector<Station>& stations, uint32_t tick,
+                    Selector& selector, MiningTime& mining_time, std::mt19937& gen) {
+
+    if(TruckEvent::Arrive == event) {
+
+        /* Ask the selection policy for a station and keep track of its index for when       *
+         * we have finished unloading (See the Shortest Wait Time Allocation strategy in     *
+         * the Notes section of the header file)                                            */
+        this->station_idx = selector.select(stations, tick);
+
+        /* Set the wait time to the number of the trucks queued ahead of this truck         */
+        this->timer = stations[this->station_idx].get_queue(tick);
+
+        /* Add this truck to the station's queue                                            */
+        stations[this->station_idx].increment_queue(tick);
+
+        /* If there are trucks ahead of this one proceed to the Waiting State.               *
+         * Otherwise proceed to the Unloading state                                         */
+        this->state = (this->timer) ? TruckState::Waiting : TruckState::Unloading;
+    }
+    else if(TruckEvent::Unload == event) {
+
+        /* Once the unloading has completed, then increment the Station's trucks             *
+         * unloaded count                                                                   */
+        stations[this->station_idx].increment_trucks_unloaded();
+    }
+    else if(TruckEvent::Draw == event) {
+
+        /* Use the simulation's RNG to determine the time the truck will be mining          */
+        this->timer = mining_time(gen);
+
+        /* Proceed to the Mining State                                                      */
+        this->state = TruckState::Mining;
+    }
+}
+
+/********************************************************************************************
+ * Truck::depart                                                                            *
+ * @brief Sends a truck that has finished mining to the given station.                      *
+ *                                                                                          *
+ * @param station_idx: The index of the station the truck unloads at.                       *
+ * @param travel_time: The ticks it takes to get there.                                     *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+inline void Truck::depart(size_t station_idx, uint16_t travel_time) {
+
+    this->station_idx = station_idx;
+    this->timer = travel_time;
+    this->state = TruckState::TravelStation;
+}
+
+/********************************************************************************************
+ * Truck::join_queue                                                                        *
+ * @brief Queues a truck that has arrived at its station behind the trucks already there.   *
+ *                                                                                          *
+ * @param station: The station the truck has arrived at.                                    *
+ * @param tick: The number of ticks the simulation has run.                                 *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+inline void Truck::join_queue(Station& station, uint32_t tick) {
+
+    /* Wait for the trucks ahead, or start unloading straight away if there are none        */
+    this->timer = station.get_queue(tick);
+    station.increment_queue(tick);
+
+    this->state = (this->timer) ? TruckState::Waiting : TruckState::Unloading;
+}
+
+/********************************************************************************************
+ * Truck::get_ticks_left                                                                    *
+ * @brief Retrieves the number of ticks the truck runs before its timer expires.            *
+ *                                                                                          *
+ * A state that does not count down expires in the very next tick.                          *
+ *                                                                                          *
+ * @param transitions: The state machine of the site, see `make_truck_transitions`.         *
+ * @return: uint16_t - The ticks left, counting the tick the timer expires in.              *
+ ********************************************************************************************/
+inline uint16_t Truck::get_ticks_left() {
+    return std::max<uint16_t>(this->timer, 1);
+}
+
+/********************************************************************************************
+ * Truck::leap                                                                              *
+ * @brief Advances the truck by several ticks at once, none of which expire its timer.      *
+ *                                                                                          *
+ * @param ticks: The number of ticks, less than `get_ticks_left`.                           *
+ * @param transitions: The state machine of the site, see `make_truck_transitions`.         *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+inline void Truck::leap(uint16_t ticks, const TruckTransitionTable& transitions) {
+
+    const TruckTransition& transition = transitions[static_cast<size_t>(this->state)];
+
+    /* The same as `ticks` calls of `run_local`, the fields of `total_time` cannot carry    */
+    this->total_time += ticks * transition.increment;
+    this->timer -= ticks * transition.countdown;
+}
+
+/********************************************************************************************
+ * Truck::head_home                                                                         *
+ * @brief Sets the time a truck that has finished unloading takes back to its mine.         *
+ *                                                                                          *
+ * @param travel_time: The ticks it takes to get back.                                      *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+inline void Truck::head_home(uint16_t travel_time) {
+    this->timer = travel_time;
+}
+
+/********************************************************************************************
+ * Truck::start_mining                                                                      *
+ * @brief Starts mining for the given time once the truck is back at its mine.              *
+ *                                                                                          *
+ * @param mining_time: The ticks the truck spends mining.                                   *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+inline void Truck::start_mining(uint16_t mining_time) {
+
+    this->timer = mining_time;
+    this->state = TruckState::Mining;
+}
+
+/********************************************************************************************
+ * Truck::wait_for_bay                                                                      *
+ * @brief Holds a truck that has arrived at a station with every bay taken.                 *
+ *                                                                                          *
+ * The timer is left at one, which the multi-bay state machine never counts down.           *
+ *                                                                                          *
+ * @param station_idx: The index of the station the truck queues at.                        *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+inline void Truck::wait_for_bay(size_t station_idx) {
+
+    this->station_idx = station_idx;
+    this->timer = 1;
+    this->state = TruckState::Waiting;
+}
+
+/********************************************************************************************
+ * Truck::start_unloading                                                                   *
+ * @brief Starts unloading a truck in a bay of the given station.                           *
+ *                                                                                          *
+ * @param station_idx: The index of the station the truck unloads at.                       *
+ * @param unload_time: The ticks the truck takes to unload, at least one.                   *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+inline void Truck::start_unloading(size_t station_idx, uint16_t unload_time) {
+
+    this->station_idx = station_idx;
+    this->timer = unload_time;
+    this->state = TruckState::Unloading;
+}
+
 /********************************************************************************************
  * Notes                                                                                    *
  ********************************************************************************************/
@@ -419,14 +1502,16 @@ public:
  *                                                                                          *
  * 1. **Round-Robin Assignment**:                                                           *
  *    - Trucks are assigned to stations in a cyclic manner, with each truck                 *
- *      being assigned to the next station in the list (using `curr_idx` as the             *
- *      index). This ensures that the workload is evenly distributed among                  *
- *      stations initially, avoiding overloading any single station.                        *
+ *      being assigned to the next station in the list (see `RoundRobinSelector`,           *
+ *      the default selection policy). This ensures that the workload is evenly             *
+ *      distributed among stations initially, avoiding overloading any single station.      *
  *                                                                                          *
  * 2. **Uniform Queue Decrementing**:                                                       *
  *    - After each loop iteration, the wait times (queues) at all stations are              *
  *      uniformly decremented. This simulates the processing of trucks at all               *
- *      stations, reducing their queues over time.                                          *
+ *      stations, reducing their queues over time. Every queue drops by exactly one         *
+ *      tick, so the decrement is done by moving the simulation's tick on and each          *
+ *      station works out its queue from the tick at which it runs empty.                   *
  *                                                                                          *
  * 3. **Minimizing Wait Times**:                                                            *
  *    - Since each truck is placed in a station's queue in a cyclic manner, and             *
@@ -446,12 +1531,18 @@ public:
  * 5. **Runtime Complexity**:                                                               *
  *    - The round-robin assignment has a runtime complexity of O(1) per truck,              *
  *      as it involves only a simple index update and a modulo operation to assign          *
- *      the truck to the next station. The uniform queue decrementing operation has         *
- *      a runtime complexity of O(m) per simulation loop, where m is the number of          *
- *      stations, because it involves decrementing the queue for each station. Over the     *
- *      entire simulation, which runs for a fixed number of iterations (864), the total     *
- *      complexity becomes O(m * 864). Since 864 is a constant, this simplifies to          *
- *      O(m), indicating that the algorithm scales linearly with the number of stations.    *
+ *      the truck to the next station. The uniform queue decrementing operation used        *
+ *      to cost O(m) per simulation loop, where m is the number of stations, because it     *
+ *      decremented the queue of each station. Counting ticks instead makes it O(1) per     *
+ *      loop, so a simulation costs O(n) per loop for n trucks however many stations        *
+ *      there are, and idle stations are never touched.                                     *
+ *                                                                                          *
+ * 6. **Other Policies**:                                                                   *
+ *    - The policy is a template parameter of the tick loops, see selection.hpp.            *
+ *      `ShortestQueueSelector` finds the shortest queue directly in O(log m) and           *
+ *      `PowerOfTwoSelector` picks the shorter of two random queues in O(1), and            *
+ *      `ShortestWaitSelector` the shortest trip plus queue in O(log m). They only touch    *
+ *      the stations they pick rather than relying on the cyclic order.                     *
  ********************************************************************************************/
 
 #endif // MAIN_HPP
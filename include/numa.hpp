@@ -0,0 +1,183 @@
+/********************************************************************************************
+ * File: numa.hpp                                                                           *
+ *                                                                                          *
+ * Description:                                                                             *
+ *  Contains the NUMA-aware memory placement of the Helium-3 Mining Simulator. On machines  *
+ *  with several sockets, memory is placed on the node of the thread that first writes to   *
+ *  it, so the truck storage of a simulation is first written by the pool workers that      *
+ *  will later advance those trucks rather than by the thread constructing it.              *
+ *                                                                                          *
+ *  Building with HAVE_LIBNUMA defined (and linking libnuma) additionally binds each chunk  *
+ *  of storage to the node of the worker that touches it, and reports the node of every     *
+ *  worker. Without it, placement relies on the operating system's first-touch policy       *
+ *  and every worker is reported on node 0.                                                 *
+ *                                                                                          *
+ * Changes:                                                                                 *
+ *  10/16/2026 - Created                                                                    *
+ *                                                                                          *
+ ********************************************************************************************/
+#ifndef NUMA_HPP
+#define NUMA_HPP
+
+/********************************************************************************************
+ * Includes                                                                                 *
+ ********************************************************************************************/
+#include <map>
+#include <memory_resource>
+
+#ifndef MAIN_HPP
+#include "../include/main.hpp"
+#endif
+
+#ifndef THREAD_POOL_HPP
+#include "../include/thread_pool.hpp"
+#endif
+
+/********************************************************************************************
+ * Defines/Macros                                                                           *
+ ********************************************************************************************/
+#define PAGE_SIZE               4096u   /*Bytes, smallest unit the OS places on a node      */
+#define FIRST_TOUCH_MIN_BYTES   65536u  /*Smaller ones reuse memory that is already placed  */
+
+/********************************************************************************************
+ * Enumerations/Classes                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * FirstTouchResource                                                                       *
+ * @brief Memory resource that has the pool's workers write to new storage first, so it is  *
+ *        placed on their NUMA nodes.                                                       *
+ *                                                                                          *
+ * Large allocations are split into the same chunks `ThreadPool::grain_size` splits a loop  *
+ * over them into, assuming they hold items of `item_size` bytes, and chunk i is touched    *
+ * by worker i % size() through `ThreadPool::parallel_for_static`. The parallel engines     *
+ * advance the trucks with the same loop, whose chunks are never stolen, so the worker      *
+ * touching a chunk here is the worker that advances the trucks in it every tick.           *
+ *                                                                                          *
+ * Small allocations are passed straight to the upstream resource, which usually serves     *
+ * them from memory that has already been touched and placed.                               *
+ *                                                                                          *
+ * The resource only knows the one item size, so only storage of those items is placed      *
+ * with their workers. A simulation built in it also keeps its stations and selector        *
+ * there. They stay below FIRST_TOUCH_MIN_BYTES up to several thousand stations, and are    *
+ * then placed by the constructing thread. A larger station array would be split at truck   *
+ * boundaries and its pages would land on arbitrary nodes.                                  *
+ ********************************************************************************************/
+class FirstTouchResource : public std::pmr::memory_resource {
+public:
+    /****************************************************************************************
+     * FirstTouchResource Constructor                                                       *
+     * @brief Initializes the resource for storage of one kind of item.                     *
+     *                                                                                      *
+     * @param pool: The pool whose workers touch the storage.                               *
+     * @param item_size: The size in bytes of the items stored, e.g. sizeof(Truck).         *
+     * @param upstream: The resource the memory is allocated from.                          *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    FirstTouchResource(ThreadPool& pool,
+                       size_t item_size,
+                       std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+private:
+    /****************************************************************************************
+     * do_allocate                                                                          *
+     * @brief Allocates from upstream and touches every page of large allocations from      *
+     *        the worker that will use it.                                                  *
+     *                                                                                      *
+     * @param bytes: The size of the allocation.                                            *
+     * @param alignment: The alignment of the allocation.                                   *
+     * @return: void* - The allocated memory.                                               *
+     ****************************************************************************************/
+    void* do_allocate(size_t bytes, size_t alignment) override;
+
+    /****************************************************************************************
+     * do_deallocate                                                                        *
+     * @brief Returns memory to upstream.                                                   *
+     *                                                                                      *
+     * @param p: The memory to return.                                                      *
+     * @param bytes: The size of the allocation.                                            *
+     * @param alignment: The alignment of the allocation.                                   *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+
+    /****************************************************************************************
+     * do_is_equal                                                                          *
+     * @brief Checks whether memory from one resource can be returned to the other.         *
+     *                                                                                      *
+     * @param other: The resource to compare against.                                       *
+     * @return: bool - True only for the same resource.                                     *
+     ****************************************************************************************/
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    /* Pool whose workers touch new storage                                                 */
+    ThreadPool& pool;
+
+    /* Size of the items stored, to split allocations like loops over them are split        */
+    size_t item_size;
+
+    /* Resource the memory comes from                                                       */
+    std::pmr::memory_resource* upstream;
+};
+
+/********************************************************************************************
+ * PlacementReport                                                                          *
+ * @brief Result of benchmarking a parallel simulation with and without first-touch         *
+ *        placement of its trucks.                                                          *
+ ********************************************************************************************/
+struct PlacementReport {
+
+    /* Truck updates per second of the whole pool, trucks stored by the calling thread      */
+    double serial_touch_rate;
+
+    /* Truck updates per second of the whole pool, trucks stored by FirstTouchResource      */
+    double first_touch_rate;
+
+    /* Truck updates per second of the workers on each NUMA node, with first touch          */
+    std::map<int, double> node_rates;
+};
+
+/********************************************************************************************
+ * NUMA Functions                                                                           *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * current_numa_node                                                                        *
+ * @brief Retrieves the NUMA node of the CPU the calling thread is running on.              *
+ *                                                                                          *
+ * @param: None                                                                             *
+ * @return: int - The node, always 0 without HAVE_LIBNUMA.                                  *
+ ********************************************************************************************/
+int current_numa_node();
+
+/********************************************************************************************
+ * benchmark_placement                                                                      *
+ * @brief Measures the throughput of a parallel simulation with its trucks placed by the    *
+ *        constructing thread, and with them placed by first touch.                         *
+ *                                                                                          *
+ * Both runs use the same seed, so they do exactly the same work. The throughput of each    *
+ * node is the number of trucks its workers advanced, estimated from their task counts,     *
+ * divided by the run time.                                                                 *
+ *                                                                                          *
+ * Only the trucks are placed by first touch. Up to several thousand stations, the stations *
+ * and the selector are placed by the constructing thread in both runs, see                 *
+ * `FirstTouchResource`.                                                                    *
+ *                                                                                          *
+ * @param num_trucks: The number of trucks in the simulation.                               *
+ * @param num_stations: The number of stations in the simulation.                           *
+ * @param pool: The pool running both simulations, its workers should be pinned.            *
+ * @return: PlacementReport - The throughput of both runs and of each node.                 *
+ ********************************************************************************************/
+PlacementReport benchmark_placement(uint16_t num_trucks, uint16_t num_stations,
+                                    ThreadPool& pool);
+
+/********************************************************************************************
+ * log_placement_report                                                                     *
+ * @brief Outputs the result of `benchmark_placement` to the console.                       *
+ *                                                                                          *
+ * @param report: The benchmark result to print.                                            *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+void log_placement_report(const PlacementReport& report);
+
+#endif // NUMA_HPP
@@ -0,0 +1,570 @@
+/********************************************************************************************
+ * File: outages.hpp                                                                        *
+ *                                                                                          *
+ * Description:                                                                             *
+ *  Contains the station outages of the Helium-3 Mining Simulator. Stations go down for     *
+ *  scheduled maintenance windows, which can take a whole range of stations down at once,   *
+ *  and fail at random for a random repair time. Arriving trucks are only sent to the       *
+ *  stations that are up, and the trucks queued at a station when it goes down are either   *
+ *  rerouted to another one or held until it comes back. The stations that are up are kept  *
+ *  in a two level bitmap, so finding one is a couple of word scans and taking stations     *
+ *  down or bringing them back only touches their own bits.                                 *
+ *                                                                                          *
+ * Changes:                                                                                 *
+ *  10/17/2026 - Created                                                                    *
+ *                                                                                          *
+ ********************************************************************************************/
+#ifndef OUTAGES_HPP
+#define OUTAGES_HPP
+
+/********************************************************************************************
+ * Includes                                                                                 *
+ ********************************************************************************************/
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#ifndef BAYS_HPP
+#include "../include/bays.hpp"
+#endif
+
+/********************************************************************************************
+ * Defines/Macros                                                                           *
+ ********************************************************************************************/
+#define ONE_DAY         288u    /*Scale: 5 mins/bit, 288*5 = 1440 minutes = 1 day           */
+#define NO_STATION      SIZE_MAX /*Returned by `next_up` when every station is down         */
+
+/********************************************************************************************
+ * Enumerations/Classes                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * OutagePolicy                                                                             *
+ * @brief What happens to the trucks queued at a station when it goes down.                 *
+ ********************************************************************************************/
+enum class OutagePolicy {
+    Reroute,
+    Hold
+};
+
+/********************************************************************************************
+ * OutageWindow                                                                             *
+ * @brief Scheduled maintenance of the stations [first_station, last_station) over the      *
+ *        ticks [start, end).                                                               *
+ ********************************************************************************************/
+struct OutageWindow {
+    uint16_t first_station;
+    uint16_t last_station;
+    uint32_t start;
+    uint32_t end;
+};
+
+/********************************************************************************************
+ * OutageConfig                                                                             *
+ * @brief Scheduled and random outages of a simulation, and how the trucks respond to them. *
+ ********************************************************************************************/
+struct OutageConfig {
+
+    /* Scheduled maintenance, windows may overlap                                           */
+    std::vector<OutageWindow> windows;
+
+    /* Random failures of each station per day, zero for none                               */
+    double failures_per_day;
+
+    /* Range of the time a failed station takes to repair, in ticks                         */
+    uint16_t min_repair;
+    uint16_t max_repair;
+
+    /* What the trucks queued at a failing station do                                       */
+    OutagePolicy policy;
+
+    /* Ticks a rerouted truck takes to get to its next station                              */
+    uint16_t reroute_time;
+};
+
+/********************************************************************************************
+ * StationAvailability                                                                      *
+ * @brief Tracks which stations are up and finds the next one that is.                      *
+ *                                                                                          *
+ * Every station has a count of the outages holding it down, and a bit that is set while    *
+ * the count is zero. A second level holds a bit per word of the first that has any bit     *
+ * set, so finding the next station that is up scans at most one word of stations and the   *
+ * summary words after it, 16 of them with 65535 stations. Taking a range of stations       *
+ * down or bringing it back touches only the counts and the bits of that range, the         *
+ * structure is never rebuilt.                                                              *
+ ********************************************************************************************/
+class StationAvailability {
+public:
+    /****************************************************************************************
+     * StationAvailability Constructor                                                      *
+     * @brief Initializes the structure, `reset` sets it up for a number of stations.       *
+     *                                                                                      *
+     * @param memory: The resource the counts and the bitmaps are stored in.                *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    explicit StationAvailability(std::pmr::memory_resource* memory =
+                                     std::pmr::get_default_resource());
+
+    /****************************************************************************************
+     * reset                                                                                *
+     * @brief Brings every station up, reusing the storage.                                 *
+     *                                                                                      *
+     * @param num_stations: The number of stations.                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void reset(size_t num_stations);
+
+    /****************************************************************************************
+     * disable                                                                              *
+     * @brief Takes the stations [first, last) down for one more outage.                    *
+     *                                                                                      *
+     * @param first: The index of the first station.                                        *
+     * @param last: One past the index of the last station.                                 *
+     * @param went_down: Called with the index of every station that was up before.         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename Callback>
+    void disable(size_t first, size_t last, Callback&& went_down);
+
+    /****************************************************************************************
+     * enable                                                                               *
+     * @brief Ends one outage of the stations [first, last).                                *
+     *                                                                                      *
+     * @param first: The index of the first station.                                        *
+     * @param last: One past the index of the last station.                                 *
+     * @param came_up: Called with the index of every station no other outage holds down.   *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename Callback>
+    void enable(size_t first, size_t last, Callback&& came_up);
+
+    /****************************************************************************************
+     * is_up                                                                                *
+     * @brief Retrieves whether a station is up.                                            *
+     *                                                                                      *
+     * @param station: The index of the station.                                            *
+     * @return: bool - True if no outage holds the station down.                            *
+     ****************************************************************************************/
+    bool is_up(size_t station) const;
+
+    /****************************************************************************************
+     * get_num_up                                                                           *
+     * @brief Retrieves the number of stations that are up.                                 *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: size_t - The number of stations up.                                         *
+     ****************************************************************************************/
+    size_t get_num_up() const;
+
+    /****************************************************************************************
+     * next_up                                                                              *
+     * @brief Finds the first station that is up at or after the given one, wrapping around *
+     *        after the last station.                                                       *
+     *                                                                                      *
+     * @param station: The index of the station to start at.                                *
+     * @return: size_t - The index of the station, NO_STATION if every station is down.     *
+     ****************************************************************************************/
+    size_t next_up(size_t station) const;
+
+    /****************************************************************************************
+     * route                                                                                *
+     * @brief Maps a station to the station that is up a truck sent to it goes to instead.  *
+     *                                                                                      *
+     * @param station: The index of the station.                                            *
+     * @return: size_t - `next_up`, or the station itself if every station is down.         *
+     ****************************************************************************************/
+    size_t route(size_t station) const;
+
+private:
+    /****************************************************************************************
+     * find_up                                                                              *
+     * @brief Finds the first station that is up at or after the given one.                 *
+     *                                                                                      *
+     * @param station: The index of the station to start at.                                *
+     * @return: size_t - The index of the station, NO_STATION if there is none.             *
+     ****************************************************************************************/
+    size_t find_up(size_t station) const;
+
+    /* Number of outages holding each station down                                          */
+    std::pmr::vector<uint16_t> holds;
+
+    /* Bit i of word w is set while station 64w + i is up                                   */
+    std::pmr::vector<uint64_t> words;
+
+    /* Bit i of word w is set while word 64w + i of `words` is not zero                     */
+    std::pmr::vector<uint64_t> summary;
+
+    size_t num_stations;
+    size_t num_up;
+};
+
+/********************************************************************************************
+ * AvailableStations                                                                        *
+ * @brief View of the stations that sends every index to the station that is up a truck     *
+ *        would go to instead, see `StationAvailability::route`.                            *
+ *                                                                                          *
+ * Lets the selection policies that look at the queues compare only stations that are up,   *
+ * without knowing about outages.                                                           *
+ ********************************************************************************************/
+template<typename Stations>
+struct AvailableStations {
+
+    Stations& stations;
+    const StationAvailability& availability;
+
+    auto& operator[](size_t station) {
+        return this->stations[this->availability.route(station)];
+    }
+};
+
+/********************************************************************************************
+ * OutageEvent                                                                              *
+ * @brief The start or the end of an outage of a range of stations, scheduled for a tick.   *
+ ********************************************************************************************/
+struct OutageEvent {
+
+    uint32_t tick;
+    uint16_t first_station;
+    uint16_t last_station;
+    bool down;
+
+    /* Orders the calendar as a min heap, ends before starts within a tick                  */
+    bool operator>(const OutageEvent& other) const {
+        return (this->tick != other.tick) ? (this->tick > other.tick)
+                                          : (this->down > other.down);
+    }
+};
+
+/********************************************************************************************
+ * OutageSimulation                                                                         *
+ * @brief Runs a fleet at a single site with multi-bay stations that go down for scheduled  *
+ *        and random outages.                                                               *
+ *                                                                                          *
+ * The outages starting or ending in a tick are applied before the trucks run. A station    *
+ * going down lets the trucks in its bays finish unloading, but hands no bay on. With the   *
+ * reroute policy the trucks in its queue leave for another station, which they pick when   *
+ * they get there; with the hold policy they wait for it to come back up. An arriving       *
+ * truck is only sent to a station that is up, and if every station is down it waits at     *
+ * the one its policy picked.                                                               *
+ *                                                                                          *
+ * Random failures strike the fleet of stations as a Poisson process and are drawn from a   *
+ * generator of their own, so without outages the run is exactly that of `BaySimulation`    *
+ * with the same seed.                                                                      *
+ *                                                                                          *
+ * The simulation is a `BaySimulation` that runs the bay tick loop with itself as the       *
+ * outage policy, see `NoOutages`.                                                          *
+ ********************************************************************************************/
+class OutageSimulation : public BaySimulation {
+public:
+    /****************************************************************************************
+     * OutageSimulation Constructor                                                         *
+     * @brief Initializes a simulation of the given fleet, stations and outages, with every *
+     *        truck mining and every station up.                                            *
+     *                                                                                      *
+     * @param num_trucks: The number of trucks to be simulated.                             *
+     * @param configs: The bays and unload times of every station.                          *
+     * @param outages: The scheduled and random outages of the stations.                    *
+     * @param debug: Optional parameter that enables debug mode if set to true.             *
+     * @param mining_time: Optional distribution of mining times, defaults to the uniform   *
+     *                     distribution between the site's mining time bounds.              *
+     * @param seed: Optional seed of the simulation's random number generator.              *
+     * @param memory: Optional resource the trucks, stations and outages are stored in.     *
+     * @param site: Optional site the simulation runs at, defaults to the standard site.    *
+     * @param selection: Optional station selection policy, defaults to round robin.        *
+     * @return: None                                                                        *
+     * @throws: std::invalid_argument if a station, a window or the outages are invalid,    *
+     *          or the selection policy mirrors the queues.                                 *
+     ****************************************************************************************/
+    OutageSimulation(uint16_t num_trucks,
+                     const std::vector<BayConfig>& configs,
+                     const OutageConfig& outages,
+                     bool debug = false,
+                     std::optional<MiningTimeDistribution> mining_time = std::nullopt,
+                     uint32_t seed = std::random_device{}(),
+                     std::pmr::memory_resource* memory = std::pmr::get_default_resource(),
+                     const SiteConfig& site = STANDARD_SITE,
+                     SelectionPolicy selection = SelectionPolicy::RoundRobin);
+
+    /****************************************************************************************
+     * simulate                                                                             *
+     * @brief Runs the tick loop for `total_time` ticks.                                    *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void simulate();
+
+    /****************************************************************************************
+     * simulate                                                                             *
+     * @brief Runs the tick loop until the observer stops it.                               *
+     *                                                                                      *
+     * @param observer: The tick loop observer, see `Simulation::simulate`.                 *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename Observer>
+    void simulate(Observer& observer);
+
+    /****************************************************************************************
+     * logging                                                                              *
+     * @brief Outputs the statistics of every truck and station, and of the outages, to     *
+     *        the console.                                                                  *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void logging();
+
+    /****************************************************************************************
+     * get_num_outages                                                                      *
+     * @brief Retrieves the number of times a station went down.                            *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: uint32_t - The number of outages.                                           *
+     ****************************************************************************************/
+    uint32_t get_num_outages();
+
+    /****************************************************************************************
+     * get_num_rerouted                                                                     *
+     * @brief Retrieves the number of trucks sent away from a station that went down.       *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: uint32_t - The number of trucks rerouted.                                   *
+     ****************************************************************************************/
+    uint32_t get_num_rerouted();
+
+    /****************************************************************************************
+     * apply_outages                                                                        *
+     * @brief Starts and ends the outages due at the current tick, the outage policy of     *
+     *        the tick loop, see `NoOutages`.                                               *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void apply_outages();
+
+    /****************************************************************************************
+     * choose_station                                                                       *
+     * @brief Picks the station that is up an arriving truck goes to.                       *
+     *                                                                                      *
+     * @param selector: The active station selection policy.                                *
+     * @param stations: The stations of the simulation.                                     *
+     * @param tick: The number of ticks the simulation has run.                             *
+     * @return: size_t - The index of the station.                                          *
+     ****************************************************************************************/
+    template<typename Selector>
+    size_t choose_station(Selector& selector, std::pmr::vector<BayStation>& stations,
+                          uint32_t tick);
+
+    /****************************************************************************************
+     * is_up                                                                                *
+     * @brief Checks whether a station is up.                                               *
+     *                                                                                      *
+     * @param station_idx: The index of the station.                                        *
+     * @return: bool - True if no outage holds the station down.                            *
+     ****************************************************************************************/
+    bool is_up(size_t station_idx) const;
+
+    /* Stations that are up                                                                 */
+    StationAvailability availability;
+
+private:
+    /****************************************************************************************
+     * go_down                                                                              *
+     * @brief Sends the trucks queued at a station that went down elsewhere, if the policy  *
+     *        is to reroute them.                                                           *
+     *                                                                                      *
+     * @param station_idx: The index of the station.                                        *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void go_down(size_t station_idx);
+
+    /****************************************************************************************
+     * reroute                                                                              *
+     * @brief Sends the trucks queued at a station that is down elsewhere.                  *
+     *                                                                                      *
+     * @param station_idx: The index of the station.                                        *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void reroute(size_t station_idx);
+
+    /****************************************************************************************
+     * come_up                                                                              *
+     * @brief Hands the free bays of a station that came back up to its queue.              *
+     *                                                                                      *
+     * @param station_idx: The index of the station.                                        *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void come_up(size_t station_idx);
+
+    /* Scheduled and random outages, and the response to them                               */
+    OutageConfig outages;
+
+    /* Starts and ends of the outages still to come, as a min heap on the tick              */
+    std::pmr::vector<OutageEvent> calendar;
+
+    /* Stations that came up during the current tick, handed their bays at its end          */
+    std::pmr::vector<uint16_t> repaired;
+
+    /* Generator of the random failures, kept apart from the mining times                   */
+    std::minstd_rand outage_gen;
+
+    /* Time of the next random failure in ticks, infinite without random failures           */
+    double next_failure;
+
+    uint32_t num_outages;
+    uint32_t num_rerouted;
+};
+
+/********************************************************************************************
+ * Template (and Inline) Definitions                                                        *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * StationAvailability::disable                                                             *
+ * @brief Takes the stations [first, last) down for one more outage.                        *
+ *                                                                                          *
+ * @param first: The index of the first station.                                            *
+ * @param last: One past the index of the last station.                                     *
+ * @param went_down: Called with the index of every station that was up before.             *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename Callback>
+void StationAvailability::disable(size_t first, size_t last, Callback&& went_down) {
+
+    for(size_t station = first; station < last; station++) {
+
+        if(this->holds[station]++) {
+            continue;
+        }
+
+        size_t word = station / 64;
+
+        this->words[word] &= ~(uint64_t{1} << (station % 64));
+
+        if(!this->words[word]) {
+            this->summary[word / 64] &= ~(uint64_t{1} << (word % 64));
+        }
+        this->num_up--;
+
+        went_down(station);
+    }
+}
+
+/********************************************************************************************
+ * StationAvailability::enable                                                              *
+ * @brief Ends one outage of the stations [first, last).                                    *
+ *                                                                                          *
+ * @param first: The index of the first station.                                            *
+ * @param last: One past the index of the last station.                                     *
+ * @param came_up: Called with the index of every station no other outage holds down.       *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename Callback>
+void StationAvailability::enable(size_t first, size_t last, Callback&& came_up) {
+
+    for(size_t station = first; station < last; station++) {
+
+        if(--this->holds[station]) {
+            continue;
+        }
+
+        size_t word = station / 64;
+
+        this->words[word] |= uint64_t{1} << (station % 64);
+        this->summary[word / 64] |= uint64_t{1} << (word % 64);
+        this->num_up++;
+
+        came_up(station);
+    }
+}
+
+/********************************************************************************************
+ * StationAvailability::is_up                                                               *
+ * @brief Retrieves whether a station is up.                                                *
+ *                                                                                          *
+ * @param station: The index of the station.                                                *
+ * @return: bool - True if no outage holds the station down.                                *
+ ********************************************************************************************/
+inline bool StationAvailability::is_up(size_t station) const {
+    return (this->words[station / 64] >> (station % 64)) & 1;
+}
+
+/********************************************************************************************
+ * StationAvailability::route                                                               *
+ * @brief Maps a station to the station that is up a truck sent to it goes to instead.      *
+ *                                                                                          *
+ * @param station: The index of the station.                                                *
+ * @return: size_t - `next_up`, or the station itself if every station is down.             *
+ ********************************************************************************************/
+inline size_t StationAvailability::route(size_t station) const {
+
+    /* Every station is up in most ticks, check the station itself before searching         */
+    if(this->is_up(station)) {
+        return station;
+    }
+
+    size_t up = this->next_up(station);
+
+    return (NO_STATION == up) ? station : up;
+}
+
+/********************************************************************************************
+ * OutageSimulation::is_up                                                                  *
+ * @brief Checks whether a station is up.                                                   *
+ *                                                                                          *
+ * @param station_idx: The index of the station.                                            *
+ * @return: bool - True if no outage holds the station down.                                *
+ ********************************************************************************************/
+inline bool OutageSimulation::is_up(size_t station_idx) const {
+    return this->availability.is_up(station_idx);
+}
+
+/********************************************************************************************
+ * OutageSimulation::simulate                                                               *
+ * @brief Runs the tick loop until the observer stops it.                                   *
+ *                                                                                          *
+ * @param observer: The tick loop observer, see `Simulation::simulate`.                     *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename Observer>
+void OutageSimulation::simulate(Observer& observer) {
+
+    /* Select the distribution and the selection policy once, outside of the tick loop      */
+    std::visit([this, &observer](auto& dist, auto& selector) {
+        this->run_engine(dist, selector, observer, *this);
+    }, this->mining_time, this->selector);
+}
+
+/********************************************************************************************
+ * OutageSimulation::choose_station                                                         *
+ * @brief Picks the station that is up an arriving truck goes to.                           *
+ *                                                                                          *
+ * The policy picks from a view that sends every station that is down to the next one       *
+ * that is up, and its pick is sent on the same way. Round robin then carries on after      *
+ * the station it ended up at, so a run of stations that are down does not all fall to      *
+ * the station after it.                                                                    *
+ *                                                                                          *
+ * @param selector: The active station selection policy.                                    *
+ * @param stations: The stations of the simulation.                                         *
+ * @param tick: The number of ticks the simulation has run.                                 *
+ * @return: size_t - The index of the station.                                              *
+ ********************************************************************************************/
+template<typename Selector>
+size_t OutageSimulation::choose_station(Selector& selector,
+                                        std::pmr::vector<BayStation>& stations,
+                                        uint32_t tick) {
+
+    AvailableStations<std::pmr::vector<BayStation>> view = {stations, this->availability};
+
+    size_t station_idx = this->availability.route(selector.select(view, tick));
+
+    if constexpr(std::is_same_v<Selector, RoundRobinSelector>) {
+        selector.resume_after(station_idx);
+    }
+
+    return station_idx;
+}
+
+#endif // OUTAGES_HPP
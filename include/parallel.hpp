@@ -0,0 +1,387 @@
+/********************************************************************************************
+ * File: parallel.hpp                                                                       *
+ *                                                                                          *
+ * Description:                                                                             *
+ *  Contains the intra-simulation parallel mode of the Helium-3 Mining Simulator. The       *
+ *  trucks of a single simulation are split into chunks that are advanced by several        *
+ *  threads every tick, while everything the trucks share is resolved serially so the       *
+ *  results are identical to the serial tick loop.                                          *
+ *                                                                                          *
+ * Changes:                                                                                 *
+ *  10/16/2026 - Created                                                                    *
+ *                                                                                          *
+ ********************************************************************************************/
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+/********************************************************************************************
+ * Includes                                                                                 *
+ ********************************************************************************************/
+#include <atomic>
+#include <exception>
+#include <thread>
+
+#ifndef MAIN_HPP
+#include "../include/main.hpp"
+#endif
+
+#ifndef THREAD_POOL_HPP
+#include "../include/thread_pool.hpp"
+#endif
+
+/********************************************************************************************
+ * Defines/Macros                                                                           *
+ ********************************************************************************************/
+#define CONTENTION_THREADS      64u     /*Threads used by the arrival queue benchmark       */
+#define CONTENTION_PUSHES       100000u /*Entries pushed by each thread of the benchmark    */
+
+/********************************************************************************************
+ * Enumerations/Classes                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * ArrivalQueue                                                                             *
+ * @brief Lock-free multi-producer single-consumer buffer of the trucks that need shared    *
+ *        state this tick.                                                                  *
+ *                                                                                          *
+ * Trucks that arrive at the stations enqueue themselves here while the trucks are being    *
+ * advanced in parallel, as do trucks that finish unloading or arrive at the mines, since   *
+ * those update a station's count or draw from the shared random number generator. An       *
+ * assignment stage then drains the buffer on a single thread.                              *
+ *                                                                                          *
+ * The buffer has a fixed capacity, one entry per truck, since a truck raises at most one   *
+ * event per tick. Pushing claims a slot with a single atomic fetch-and-add on the tail,    *
+ * so producers never wait on each other or retry. Producers and the consumer never run at  *
+ * the same time: the tick barrier orders every push before the drain, which is what makes  *
+ * the plain writes to the entries visible to the consumer.                                 *
+ *                                                                                          *
+ * Entries end up in the order the producers claimed their slots, so the drain sorts them   *
+ * by truck index before handing them out. This restores the order of the serial tick       *
+ * loop, and only costs O(k log k) for the k trucks that raised an event.                   *
+ ********************************************************************************************/
+class ArrivalQueue {
+public:
+    /* A truck that raised an event, and the event to resolve for it                        */
+    struct Entry {
+        size_t truck_idx;
+        TruckEvent event;
+    };
+
+    /****************************************************************************************
+     * ArrivalQueue Constructor                                                             *
+     * @brief Allocates the buffer for a fleet of trucks.                                   *
+     *                                                                                      *
+     * @param capacity: The number of trucks that can enqueue themselves each tick.         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    explicit ArrivalQueue(size_t capacity);
+
+    /****************************************************************************************
+     * push                                                                                 *
+     * @brief Enqueues a truck's event, can be called from any number of threads at once.   *
+     *                                                                                      *
+     * @param truck_idx: The index of the truck in the simulation.                          *
+     * @param event: The event the truck raised.                                            *
+     * @return: None                                                                        *
+     * @throws: std::runtime_error if the buffer is full.                                   *
+     ****************************************************************************************/
+    void push(size_t truck_idx, TruckEvent event);
+
+    /****************************************************************************************
+     * drain                                                                                *
+     * @brief Hands every enqueued entry to `assign` in truck index order and empties the   *
+     *        buffer. Must only be called once all the producers have synchronized with     *
+     *        the calling thread.                                                           *
+     *                                                                                      *
+     * @param assign: Called with each `Entry`.                                             *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename Assign>
+    void drain(Assign&& assign);
+
+    /****************************************************************************************
+     * size                                                                                 *
+     * @brief Retrieves the number of entries enqueued since the last drain.                *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: size_t - The number of entries.                                             *
+     ****************************************************************************************/
+    size_t size() const;
+
+private:
+    /* Slots of the buffer, only the first `tail` are in use                                */
+    std::vector<Entry> entries;
+
+    /* Next free slot, on its own cache line since every producer writes to it              */
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail;
+};
+
+/********************************************************************************************
+ * ContentionReport                                                                         *
+ * @brief Result of benchmarking concurrent pushes to an ArrivalQueue.                      *
+ ********************************************************************************************/
+struct ContentionReport {
+
+    /* Threads pushing at the same time, and the entries each of them pushed                */
+    size_t num_threads;
+    size_t pushes_per_thread;
+
+    /* Wall clock time from the first push to the last one in microseconds                  */
+    double elapsed_us;
+
+    /* Wall clock time divided by the pushes of all threads, and their pushes per second    */
+    double ns_per_push;
+    double pushes_per_second;
+};
+
+/********************************************************************************************
+ * Parallel Functions                                                                       *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * simulate_parallel                                                                        *
+ * @brief Runs the tick loop of a simulation for its fixed horizon using several threads.   *
+ *                                                                                          *
+ * This is the parallel counterpart of `Simulation::simulate`, including the warm-up, and   *
+ * produces exactly the same results for the same seed.                                     *
+ *                                                                                          *
+ * @param sim: The simulation to run.                                                       *
+ * @param pool: The pool advancing the trucks, every truck on a fixed worker.               *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if a debug check fails.                                      *
+ ********************************************************************************************/
+void simulate_parallel(Simulation& sim, ThreadPool& pool);
+
+/********************************************************************************************
+ * simulate_parallel                                                                        *
+ * @brief Runs the tick loop of a simulation using several threads until the observer       *
+ *        ends it.                                                                          *
+ *                                                                                          *
+ * Every tick is split into two phases:                                                     *
+ * 1. Parallel: the trucks are split into chunks of `ThreadPool::grain_size` trucks, and    *
+ *    the pool advances each chunk with `Truck::run_local`, which only touches the truck    *
+ *    itself. Chunk i always runs on worker i % size(), so the trucks stay in the caches,   *
+ *    and with `FirstTouchResource` on the NUMA node, of the same worker. Trucks that need  *
+ *    shared state to finish their transition enqueue themselves in a lock-free             *
+ *    ArrivalQueue.                                                                         *
+ * 2. Serial: once every chunk is done, the queue is drained with `Truck::resolve` in       *
+ *    truck index order, so the station assignments, queue lengths and random draws are     *
+ *    exactly those of the serial tick loop. The tick then moves on, which shortens every   *
+ *    station queue at once, and the observer is consulted.                                 *
+ *                                                                                          *
+ * Only a few trucks arrive, unload or start mining in any tick, so the serial phase is     *
+ * short compared to advancing the whole fleet. The serial phase runs on the calling        *
+ * thread once `ThreadPool::parallel_for_static` has returned.                              *
+ *                                                                                          *
+ * The observer sees every truck before the tick it runs, in truck index order, during the  *
+ * serial phase, so observers do not need to be thread safe.                                *
+ *                                                                                          *
+ * @param sim: The simulation to run.                                                       *
+ * @param observer: The tick loop observer, see `Simulation::simulate`.                     *
+ * @param pool: The pool advancing the trucks, every truck on a fixed worker.               *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if a debug check fails.                                      *
+ ********************************************************************************************/
+template<typename Observer>
+void simulate_parallel(Simulation& sim, Observer& observer, ThreadPool& pool);
+
+/********************************************************************************************
+ * benchmark_arrival_queue                                                                  *
+ * @brief Measures the cost of pushing to an ArrivalQueue when every thread pushes at once. *
+ *                                                                                          *
+ * All the threads are released together and push `pushes_per_thread` entries each as       *
+ * fast as they can, which is far more contention than a tick ever produces, so it bounds   *
+ * the cost of the parallel phase's enqueues from above. The drained entries are checked    *
+ * so a lost or duplicated push is reported as an error.                                    *
+ *                                                                                          *
+ * @param num_threads: The number of threads pushing at the same time.                      *
+ * @param pushes_per_thread: The number of entries each thread pushes.                      *
+ * @return: ContentionReport - The time taken and the resulting throughput.                 *
+ * @throws: std::runtime_error if the drained entries do not match the pushed ones.         *
+ ********************************************************************************************/
+ContentionReport benchmark_arrival_queue(size_t num_threads, size_t pushes_per_thread);
+
+/********************************************************************************************
+ * log_contention_report                                                                    *
+ * @brief Outputs the result of `benchmark_arrival_queue` to the console.                   *
+ *                                                                                          *
+ * @param report: The benchmark result to print.                                            *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+void log_contention_report(const ContentionReport& report);
+
+/********************************************************************************************
+ * Template and Inline Definitions                                                          *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * ArrivalQueue::push                                                                       *
+ * @brief Enqueues a truck's event, can be called from any number of threads at once.       *
+ *                                                                                          *
+ * The slot is claimed with a relaxed fetch-and-add: the only ordering needed is between    *
+ * the write to the slot and the drain, which the tick barrier already provides.            *
+ *                                                                                          *
+ * @param truck_idx: The index of the truck in the simulation.                              *
+ * @param event: The event the truck raised.                                                *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if the buffer is full.                                       *
+ ********************************************************************************************/
+inline void ArrivalQueue::push(size_t truck_idx, TruckEvent event) {
+
+    size_t slot = this->tail.fetch_add(1, std::memory_order_relaxed);
+
+    if(slot >= this->entries.size()) {
+        throw std::runtime_error("More trucks enqueued than the arrival queue can hold");
+    }
+
+    this->entries[slot] = Entry{truck_idx, event};
+}
+
+/********************************************************************************************
+ * ArrivalQueue::size                                                                       *
+ * @brief Retrieves the number of entries enqueued since the last drain.                    *
+ *                                                                                          *
+ * @param: None                                                                             *
+ * @return: size_t - The number of entries.                                                 *
+ ********************************************************************************************/
+inline size_t ArrivalQueue::size() const {
+    return std::min(this->tail.load(std::memory_order_relaxed), this->entries.size());
+}
+
+/********************************************************************************************
+ * ArrivalQueue::drain                                                                      *
+ * @brief Hands every enqueued entry to `assign` in truck index order and empties the       *
+ *        buffer. Must only be called once all the producers have synchronized with the     *
+ *        calling thread.                                                                   *
+ *                                                                                          *
+ * @param assign: Called with each `Entry`.                                                 *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename Assign>
+void ArrivalQueue::drain(Assign&& assign) {
+
+    auto last = this->entries.begin() + this->size();
+
+    /* Restore the truck index order lost to the order the slots were claimed in            */
+    std::sort(this->entries.begin(), last, [](const Entry& lhs, const Entry& rhs) {
+        return lhs.truck_idx < rhs.truck_idx;
+    });
+
+    for(auto entry = this->entries.begin(); entry != last; entry++) {
+        assign(*entry);
+    }
+
+    this->tail.store(0, std::memory_order_relaxed);
+}
+
+/********************************************************************************************
+ * run_parallel_engine                                                                      *
+ * @brief Runs the two phase tick loop with the mining time distribution, the selection     *
+ *        policy, the observer, the consistency checks and the site fixed at compile time.  *
+ *                                                                                          *
+ * @param sim: The simulation to run.                                                       *
+ * @param mining_time: The active mining time distribution policy.                          *
+ * @param selector: The active station selection policy.                                    *
+ * @param observer: The tick loop observer.                                                 *
+ * @param pool: The pool advancing the trucks.                                              *
+ * @param checks: The consistency check policy, see `select_checks`.                        *
+ * @param site: The site policy, see `select_site`.                                         *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename MiningTime, typename Selector, typename Observer, typename Checks,
+         typename Site>
+void run_parallel_engine(Simulation& sim,
+                         MiningTime& mining_time,
+                         Selector& selector,
+                         Observer& observer,
+                         ThreadPool& pool,
+                         Checks checks,
+                         Site site) {
+
+    std::pmr::vector<Truck>& trucks = sim.trucks;
+    std::pmr::vector<Station>& stations = sim.stations;
+
+    size_t grain = pool.grain_size(trucks.size());
+
+    /* Trucks that need their event resolved this tick                                      */
+    ArrivalQueue arrivals(trucks.size());
+
+    /* Each iteration is one tick, the observer decides when the simulation ends            */
+    while(observer.next_tick()) {
+
+        for(auto& truck : trucks) {
+            observer.observe(truck);
+        }
+
+        /* Parallel phase, advance every truck by itself                                    */
+        pool.parallel_for_static(0, trucks.size(), grain, [&](size_t first, size_t last) {
+
+            for(size_t idx = first; idx < last; idx++) {
+
+                TruckEvent event = trucks[idx].run_local(site.transitions);
+
+                if(TruckEvent::None != event) {
+                    arrivals.push(idx, event);
+                }
+            }
+        });
+
+        /* Assignment stage, resolve the events in truck index order                        */
+        arrivals.drain([&](const ArrivalQueue::Entry& entry) {
+
+            trucks[entry.truck_idx].resolve(entry.event, stations, sim.tick, selector,
+                                            mining_time, sim.gen);
+
+            checks.check_selection(stations, sim.tick, selector);
+        });
+
+        /* Every station unloaded a truck, which moves all the queues on at once            */
+        sim.tick++;
+    }
+}
+
+/********************************************************************************************
+ * simulate_parallel                                                                        *
+ * @brief Runs the tick loop of a simulation using several threads until the observer       *
+ *        ends it.                                                                          *
+ *                                                                                          *
+ * Every tick is split into two phases:                                                     *
+ * 1. Parallel: the trucks are split into chunks of `ThreadPool::grain_size` trucks, and    *
+ *    the pool advances each chunk with `Truck::run_local`, which only touches the truck    *
+ *    itself. Chunk i always runs on worker i % size(), so the trucks stay in the caches,   *
+ *    and with `FirstTouchResource` on the NUMA node, of the same worker. Trucks that need  *
+ *    shared state to finish their transition enqueue themselves in a lock-free             *
+ *    ArrivalQueue.                                                                         *
+ * 2. Serial: once every chunk is done, the queue is drained with `Truck::resolve` in       *
+ *    truck index order, so the station assignments, queue lengths and random draws are     *
+ *    exactly those of the serial tick loop. The tick then moves on, which shortens every   *
+ *    station queue at once, and the observer is consulted.                                 *
+ *                                                                                          *
+ * Only a few trucks arrive, unload or start mining in any tick, so the serial phase is     *
+ * short compared to advancing the whole fleet. The serial phase runs on the calling        *
+ * thread once `ThreadPool::parallel_for_static` has returned.                              *
+ *                                                                                          *
+ * The observer sees every truck before the tick it runs, in truck index order, during the  *
+ * serial phase, so observers do not need to be thread safe.                                *
+ *                                                                                          *
+ * @param sim: The simulation to run.                                                       *
+ * @param observer: The tick loop observer, see `Simulation::simulate`.                     *
+ * @param pool: The pool advancing the trucks, every truck on a fixed worker.               *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if a debug check fails.                                      *
+ ********************************************************************************************/
+template<typename Observer>
+void simulate_parallel(Simulation& sim, Observer& observer, ThreadPool& pool) {
+
+    /* Resolve the distribution, the selection policy, the checks and the site once, so the  *
+     * tick loop is specialized for them                                                    */
+    std::visit([&](auto& dist, auto& selector) {
+        select_checks(sim.debug, [&](auto checks) {
+            select_site(sim.site, sim.transitions, [&](auto site) {
+                run_parallel_engine(sim, dist, selector, observer, pool, checks, site);
+            });
+        });
+    }, sim.mining_time, sim.selector);
+}
+
+#endif // PARALLEL_HPP
@@ -0,0 +1,495 @@
+/********************************************************************************************
+ * File: process.hpp                                                                        *
+ *                                                                                          *
+ * Description:                                                                             *
+ *  Contains the process-oriented engine of the Helium-3 Mining Simulator. Rather than a    *
+ *  state machine advanced one tick at a time, every truck is a C++20 coroutine that reads  *
+ *  as the sequence of things it does:                                                      *
+ *                                                                                          *
+ *      co_await sim.mine(mining_time(sim.gen));                                            *
+ *      co_await sim.travel();                                                              *
+ *      co_await sim.unload(selector.select(sim.stations, sim.tick));                       *
+ *      co_await sim.travel();                                                              *
+ *                                                                                          *
+ *  Each `co_await` suspends the truck until the activity is over, and a calendar of        *
+ *  wake-ups resumes the trucks tick by tick, in truck index order within a tick, so the    *
+ *  results are identical to those of `Simulation` for the same seed. New behaviours only   *
+ *  need another awaitable and another line in the process.                                 *
+ *                                                                                          *
+ *  The coroutine frames come from a pool owned by the simulation, and the awaitables live  *
+ *  in the frames, so a truck suspending and resuming never allocates.                      *
+ *                                                                                          *
+ * Changes:                                                                                 *
+ *  10/17/2026 - Created                                                                    *
+ *                                                                                          *
+ ********************************************************************************************/
+#ifndef PROCESS_HPP
+#define PROCESS_HPP
+
+/********************************************************************************************
+ * Includes                                                                                 *
+ ********************************************************************************************/
+#include <coroutine>
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#ifndef MAIN_HPP
+#include "../include/main.hpp"
+#endif
+
+/********************************************************************************************
+ * Defines/Macros                                                                           *
+ ********************************************************************************************/
+#define FRAME_HEADER            alignof(std::max_align_t)   /*Pool pointer before a frame   */
+
+/********************************************************************************************
+ * Enumerations/Classes                                                                     *
+ ********************************************************************************************/
+class ProcessSimulation;
+
+/********************************************************************************************
+ * TruckProcess                                                                             *
+ * @brief Handle to the coroutine of one truck, see `truck_process`.                        *
+ *                                                                                          *
+ * The process starts running as soon as it is created, up to its first `co_await`, and     *
+ * from then on only the simulation's calendar resumes it. It never returns, the            *
+ * simulation destroys it when it is done with it.                                          *
+ ********************************************************************************************/
+class TruckProcess {
+public:
+    /****************************************************************************************
+     * promise_type                                                                         *
+     * @brief State of a truck that lives in its coroutine frame.                           *
+     ****************************************************************************************/
+    struct promise_type {
+
+        /************************************************************************************
+         * promise_type Constructor                                                         *
+         * @brief Takes the truck index from the arguments of the process.                  *
+         *                                                                                  *
+         * @param sim: The simulation the truck belongs to.                                 *
+         * @param truck_idx: The index of the truck.                                        *
+         * @param args: The remaining arguments of the process, unused.                     *
+         * @return: None                                                                    *
+         ************************************************************************************/
+        template<typename... Args>
+        promise_type(ProcessSimulation& sim, uint32_t truck_idx, Args&... args);
+
+        /************************************************************************************
+         * operator new                                                                     *
+         * @brief Allocates the coroutine frame from the simulation's frame pool.           *
+         *                                                                                  *
+         * The pool is stored in front of the frame, where `operator delete` finds it.      *
+         *                                                                                  *
+         * @param size: The size of the frame.                                              *
+         * @param sim: The simulation the truck belongs to.                                 *
+         * @param args: The remaining arguments of the process, unused.                     *
+         * @return: void* - The frame.                                                      *
+         ************************************************************************************/
+        template<typename... Args>
+        static void* operator new(size_t size, ProcessSimulation& sim, Args&... args);
+
+        /************************************************************************************
+         * operator delete                                                                  *
+         * @brief Returns the coroutine frame to the pool it came from.                     *
+         *                                                                                  *
+         * @param frame: The frame.                                                         *
+         * @param size: The size of the frame.                                              *
+         * @return: None                                                                    *
+         ************************************************************************************/
+        static void operator delete(void* frame, size_t size);
+
+        TruckProcess get_return_object();
+        std::suspend_never initial_suspend() noexcept;
+        std::suspend_always final_suspend() noexcept;
+        void return_void() noexcept;
+        void unhandled_exception();
+
+        /* Index of the truck, which orders the trucks resumed in the same tick             */
+        uint32_t truck_idx;
+
+        /* Tick the truck's next activity starts at                                         */
+        uint32_t cursor;
+
+        /* Packed time recorded in each state, see `Truck::get_total_time`                  */
+        uint64_t total_time;
+    };
+
+    /****************************************************************************************
+     * TruckProcess Constructor                                                             *
+     * @brief Takes ownership of a truck's coroutine.                                       *
+     *                                                                                      *
+     * @param handle: The coroutine.                                                        *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    explicit TruckProcess(std::coroutine_handle<promise_type> handle);
+
+    /* Owns the coroutine, so it can only be moved                                          */
+    TruckProcess(const TruckProcess&) = delete;
+    TruckProcess& operator=(const TruckProcess&) = delete;
+    TruckProcess(TruckProcess&& other) noexcept;
+    TruckProcess& operator=(TruckProcess&& other) noexcept;
+
+    /****************************************************************************************
+     * ~TruckProcess                                                                        *
+     * @brief Destroys the coroutine, returning its frame to the pool.                      *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    ~TruckProcess();
+
+    /****************************************************************************************
+     * resume                                                                               *
+     * @brief Runs the truck from where it last suspended up to its next `co_await`.        *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     * @throws: Whatever the process throws.                                                *
+     ****************************************************************************************/
+    void resume();
+
+    /****************************************************************************************
+     * get_total_time                                                                       *
+     * @brief Retrieves the packed time the truck recorded, see `Truck::get_total_time`.    *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: uint64_t - The total time recorded for the truck across all states.         *
+     ****************************************************************************************/
+    uint64_t get_total_time() const;
+
+private:
+    std::coroutine_handle<promise_type> handle;
+};
+
+/* Coroutine of a truck, as the awaitables see it when the truck suspends                  */
+using ProcessHandle = std::coroutine_handle<TruckProcess::promise_type>;
+
+/********************************************************************************************
+ * ProcessDelay                                                                             *
+ * @brief Awaitable of an activity that takes a fixed number of ticks, e.g. mining or       *
+ *        travelling. The truck resumes in the last tick of the activity.                   *
+ ********************************************************************************************/
+struct ProcessDelay {
+
+    bool await_ready() const noexcept;
+    void await_suspend(ProcessHandle process);
+    void await_resume() const noexcept;
+
+    ProcessSimulation* sim;
+
+    /* Added to the packed time every tick of the activity, one of the *_INC macros         */
+    uint64_t increment;
+
+    /* Length of the activity                                                               */
+    uint16_t ticks;
+};
+
+/********************************************************************************************
+ * ProcessUnload                                                                            *
+ * @brief Awaitable of a truck queueing at a station and unloading there. The truck joins   *
+ *        the queue as it suspends and resumes in the tick it unloads.                      *
+ ********************************************************************************************/
+struct ProcessUnload {
+
+    bool await_ready() const noexcept;
+    void await_suspend(ProcessHandle process);
+    void await_resume();
+
+    ProcessSimulation* sim;
+
+    /* Station the truck unloads at                                                         */
+    size_t station_idx;
+};
+
+/********************************************************************************************
+ * ProcessWakeup                                                                            *
+ * @brief Entry of the calendar, a truck to resume and the tick to resume it in.            *
+ ********************************************************************************************/
+struct ProcessWakeup {
+    uint32_t tick;
+    uint32_t truck_idx;
+
+    /* Orders the calendar as a min-heap, by tick and then by truck index                   */
+    bool operator>(const ProcessWakeup& other) const;
+};
+
+/********************************************************************************************
+ * ProcessSimulation                                                                        *
+ * @brief Simulates a fleet at a single site with one coroutine per truck, see              *
+ *        `truck_process`.                                                                  *
+ *                                                                                          *
+ * The discrete-event core is a calendar of wake-ups, a binary heap ordered by tick and     *
+ * truck index. Every truck has at most one wake-up pending, so the heap never grows past   *
+ * the fleet, and it is reserved up front. The simulation runs for its fixed horizon:       *
+ * activities are recorded when they start, up to the horizon, and wake-ups past it are     *
+ * never scheduled.                                                                         *
+ ********************************************************************************************/
+class ProcessSimulation {
+public:
+    /****************************************************************************************
+     * ProcessSimulation Constructor                                                        *
+     * @brief Initializes the stations and the selection policy, the trucks are started by  *
+     *        `simulate`.                                                                   *
+     *                                                                                      *
+     * @param num_trucks: The number of trucks to be simulated.                             *
+     * @param num_stations: The number of stations available in the simulation.             *
+     * @param mining_time: Optional distribution of mining times, defaults to the uniform   *
+     *                     distribution between the site's mining time bounds.              *
+     * @param seed: Optional seed of the simulation's random number generator.              *
+     * @param memory: Optional resource the stations, the calendar and the frame pool are   *
+     *                stored in.                                                            *
+     * @param site: Optional site the simulation runs at, defaults to the standard site.    *
+     * @param selection: Optional station selection policy, defaults to round robin.        *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    ProcessSimulation(uint16_t num_trucks,
+                      uint16_t num_stations,
+                      std::optional<MiningTimeDistribution> mining_time = std::nullopt,
+                      uint32_t seed = std::random_device{}(),
+                      std::pmr::memory_resource* memory = std::pmr::get_default_resource(),
+                      const SiteConfig& site = STANDARD_SITE,
+                      SelectionPolicy selection = SelectionPolicy::RoundRobin);
+
+    /****************************************************************************************
+     * start                                                                                *
+     * @brief Creates the process of every truck in index order, each of which draws its    *
+     *        first mining time and suspends.                                               *
+     *                                                                                      *
+     * This is where the coroutine frames are allocated. Does nothing once the trucks       *
+     * have been started.                                                                   *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void start();
+
+    /****************************************************************************************
+     * simulate                                                                             *
+     * @brief Starts the trucks if need be and resumes them from the calendar until the     *
+     *        horizon.                                                                      *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     * @throws: Whatever a process throws.                                                  *
+     ****************************************************************************************/
+    void simulate();
+
+    /****************************************************************************************
+     * mine                                                                                 *
+     * @brief Awaitable that keeps a truck mining.                                          *
+     *                                                                                      *
+     * @param ticks: The mining time, at least one tick.                                    *
+     * @return: ProcessDelay - Resumes the truck in its last tick of mining.                *
+     ****************************************************************************************/
+    ProcessDelay mine(uint16_t ticks);
+
+    /****************************************************************************************
+     * travel                                                                               *
+     * @brief Awaitable that takes a truck between the mines and the stations.              *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: ProcessDelay - Resumes the truck in its last tick of travel.                *
+     ****************************************************************************************/
+    ProcessDelay travel();
+
+    /****************************************************************************************
+     * unload                                                                               *
+     * @brief Awaitable that queues a truck at a station and unloads it there.              *
+     *                                                                                      *
+     * @param station_idx: The station, as picked by the selection policy.                  *
+     * @return: ProcessUnload - Resumes the truck in the tick it unloads.                   *
+     ****************************************************************************************/
+    ProcessUnload unload(size_t station_idx);
+
+    /****************************************************************************************
+     * schedule                                                                             *
+     * @brief Records the ticks of an activity a truck starts, and books its wake-up.       *
+     *                                                                                      *
+     * @param process: The truck.                                                           *
+     * @param increment: The packed time added every tick, one of the *_INC macros.         *
+     * @param ticks: The length of the activity.                                            *
+     * @param wakeup: The tick to resume the truck in, skipped past the horizon.            *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void schedule(TruckProcess::promise_type& process, uint64_t increment, uint32_t ticks,
+                  uint32_t wakeup);
+
+    /****************************************************************************************
+     * get_total_time                                                                       *
+     * @brief Retrieves the packed time a truck recorded.                                   *
+     *                                                                                      *
+     * @param truck_idx: The index of the truck.                                            *
+     * @return: uint64_t - The total time recorded for the truck across all states.         *
+     ****************************************************************************************/
+    uint64_t get_total_time(size_t truck_idx) const;
+
+    /****************************************************************************************
+     * get_state_fractions                                                                  *
+     * @brief Computes the fraction of time the fleet spent in each category.               *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: StateFractions - The fleet-wide fraction of time spent in each category.    *
+     ****************************************************************************************/
+    StateFractions get_state_fractions() const;
+
+    /****************************************************************************************
+     * get_frame_pool                                                                       *
+     * @brief Retrieves the pool the coroutine frames are allocated from.                   *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: std::pmr::memory_resource* - The pool.                                      *
+     ****************************************************************************************/
+    std::pmr::memory_resource* get_frame_pool();
+
+    /* Number of trucks in the fleet                                                        */
+    uint16_t num_trucks;
+
+    /* Store the total execution time of the simulation                                     */
+    uint16_t total_time;
+
+    /* Site the simulation runs at                                                          */
+    SiteConfig site;
+
+    /* Tick of the trucks being resumed, see `Station`                                      */
+    uint32_t tick;
+
+    /* Stations of the site, and the policy that sends the trucks to them                   */
+    std::pmr::vector<Station> stations;
+    StationSelector selector;
+
+    /* Distribution the trucks draw their mining times from, and the generator they use     */
+    MiningTimeDistribution mining_time;
+    std::mt19937 gen;
+
+private:
+    /* Pool of the coroutine frames, declared before the trucks so it outlives them         */
+    std::pmr::unsynchronized_pool_resource frames;
+
+    /* Process of every truck, in index order                                               */
+    std::pmr::vector<TruckProcess> trucks;
+
+    /* Pending wake-ups, a min-heap, see `ProcessWakeup`                                    */
+    std::pmr::vector<ProcessWakeup> calendar;
+};
+
+/********************************************************************************************
+ * ProcessReport                                                                            *
+ * @brief Result of `benchmark_processes`, the state machine and the process engine side by *
+ *        side.                                                                             *
+ ********************************************************************************************/
+struct ProcessReport {
+
+    /* Size of the simulations run                                                          */
+    uint16_t num_trucks;
+    uint16_t num_stations;
+
+    /* Truck updates (trucks times ticks) per second of each engine                         */
+    double state_machine_rate;
+    double process_rate;
+
+    /* Bytes the frame pool took from its upstream resource to start the trucks             */
+    size_t frame_bytes;
+};
+
+/********************************************************************************************
+ * Process Functions                                                                        *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * benchmark_processes                                                                      *
+ * @brief Measures the throughput of the state machine and the process engine on the same   *
+ *        simulation.                                                                       *
+ *                                                                                          *
+ * The process engine's memory goes through a `CountingResource`, which must see nothing    *
+ * once the trucks have been started, and the trucks and stations of both engines are       *
+ * compared afterwards.                                                                     *
+ *                                                                                          *
+ * @param num_trucks: The number of trucks in the simulation.                               *
+ * @param num_stations: The number of stations in the simulation.                           *
+ * @return: ProcessReport - The metrics of both engines.                                    *
+ * @throws: std::runtime_error if the engines do not agree or a suspension allocated.       *
+ ********************************************************************************************/
+ProcessReport benchmark_processes(uint16_t num_trucks, uint16_t num_stations);
+
+/********************************************************************************************
+ * log_process_report                                                                       *
+ * @brief Outputs the result of `benchmark_processes` to the console.                       *
+ *                                                                                          *
+ * @param report: The benchmark result to print.                                            *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+void log_process_report(const ProcessReport& report);
+
+/********************************************************************************************
+ * Template Definitions                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * truck_process                                                                            *
+ * @brief The life of one truck: mine, travel to the stations, queue and unload at the      *
+ *        station the selection policy picks, travel back, and over again.                  *
+ *                                                                                          *
+ * The mining time is drawn when the truck starts mining and the station is picked when     *
+ * the truck arrives, in the tick and in the truck order the state machine does both, so    *
+ * the generator and the selector see the same calls.                                       *
+ *                                                                                          *
+ * @param sim: The simulation the truck belongs to.                                         *
+ * @param truck_idx: The index of the truck.                                                *
+ * @param mining_time: The active mining time distribution policy.                          *
+ * @param selector: The active station selection policy.                                    *
+ * @return: TruckProcess - The truck, suspended in its first mining trip.                   *
+ ********************************************************************************************/
+template<typename MiningTime, typename Selector>
+TruckProcess truck_process(ProcessSimulation& sim,
+                           [[maybe_unused]] uint32_t truck_idx,
+                           MiningTime& mining_time,
+                           Selector& selector) {
+
+    while(true) {
+        co_await sim.mine(mining_time(sim.gen));
+        co_await sim.travel();
+        co_await sim.unload(selector.select(sim.stations, sim.tick));
+        co_await sim.travel();
+    }
+}
+
+/********************************************************************************************
+ * TruckProcess::promise_type Constructor                                                   *
+ * @brief Takes the truck index from the arguments of the process.                          *
+ *                                                                                          *
+ * @param sim: The simulation the truck belongs to.                                         *
+ * @param truck_idx: The index of the truck.                                                *
+ * @param args: The remaining arguments of the process, unused.                             *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename... Args>
+TruckProcess::promise_type::promise_type(ProcessSimulation&, uint32_t truck_idx, Args&...)
+                                         : truck_idx(truck_idx),
+                                           cursor(0),
+                                           total_time(0) {}
+
+/********************************************************************************************
+ * TruckProcess::promise_type::operator new                                                 *
+ * @brief Allocates the coroutine frame from the simulation's frame pool.                   *
+ *                                                                                          *
+ * @param size: The size of the frame.                                                      *
+ * @param sim: The simulation the truck belongs to.                                         *
+ * @param args: The remaining arguments of the process, unused.                             *
+ * @return: void* - The frame.                                                              *
+ ********************************************************************************************/
+template<typename... Args>
+void* TruckProcess::promise_type::operator new(size_t size, ProcessSimulation& sim,
+                                               Args&...) {
+
+    std::pmr::memory_resource* pool = sim.get_frame_pool();
+    std::byte* block = static_cast<std::byte*>(pool->allocate(FRAME_HEADER + size,
+                                                              FRAME_HEADER));
+
+    *reinterpret_cast<std::pmr::memory_resource**>(block) = pool;
+
+    return block + FRAME_HEADER;
+}
+
+#endif // PROCESS_HPP
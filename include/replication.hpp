@@ -0,0 +1,97 @@
+/********************************************************************************************
+ * File: replication.hpp                                                                    *
+ *                                                                                          *
+ * Description:                                                                             *
+ *  Contains the replication runner of the Helium-3 Mining Simulator. Independent           *
+ *  replications of one configuration are spread across a thread pool, and every worker     *
+ *  builds its simulations in a reused arena so a batch of replications does not go back    *
+ *  to the heap once the arenas have grown to the size of one simulation.                   *
+ *                                                                                          *
+ * Changes:                                                                                 *
+ *  10/16/2026 - Created                                                                    *
+ *                                                                                          *
+ ********************************************************************************************/
+#ifndef REPLICATION_HPP
+#define REPLICATION_HPP
+
+/********************************************************************************************
+ * Includes                                                                                 *
+ ********************************************************************************************/
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+
+#ifndef MAIN_HPP
+#include "../include/main.hpp"
+#endif
+
+#ifndef THREAD_POOL_HPP
+#include "../include/thread_pool.hpp"
+#endif
+
+/********************************************************************************************
+ * Enumerations/Classes                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * ReplicationRunner                                                                        *
+ * @brief Runs batches of independent replications on a thread pool, building every         *
+ *        simulation in a per-worker arena.                                                 *
+ *                                                                                          *
+ * Each worker, and the calling thread, owns a buffer the size of one simulation's          *
+ * storage (see `Simulation::storage_bytes`) and the tables of its distribution. A          *
+ * replication wraps the buffer of the thread running it in a                               *
+ * `std::pmr::monotonic_buffer_resource`, builds its simulation in it, and drops the arena  *
+ * when it is done, which costs nothing since the buffer is kept. A buffer only grows when  *
+ * a larger configuration comes along, so after the first batch of a configuration the      *
+ * replications allocate nothing from the upstream resource.                                *
+ *                                                                                          *
+ * The mining time distribution is copied into every simulation. The uniform and            *
+ * lognormal distributions do not allocate, the empirical one copies its alias table into   *
+ * the arena as well (see `copy_distribution`).                                             *
+ ********************************************************************************************/
+class ReplicationRunner {
+public:
+    /****************************************************************************************
+     * ReplicationRunner Constructor                                                        *
+     * @brief Initializes an empty arena buffer for every thread of the pool.               *
+     *                                                                                      *
+     * @param pool: The pool the replications run on.                                       *
+     * @param upstream: The resource the arena buffers, and any allocation that does not    *
+     *                  fit in them, come from.                                             *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    ReplicationRunner(ThreadPool& pool,
+                      std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+    /****************************************************************************************
+     * run                                                                                  *
+     * @brief Runs one replication per entry of `results` for the fixed horizon, seeded     *
+     *        `first_seed`, `first_seed + 1`, ..., and stores their state fractions.        *
+     *                                                                                      *
+     * @param num_trucks: The number of trucks in every replication.                        *
+     * @param num_stations: The number of stations in every replication.                    *
+     * @param mining_time: The mining time distribution of every replication.               *
+     * @param first_seed: The seed of the first replication.                                *
+     * @param results: Receives the state fractions of each replication, in seed order.     *
+     * @return: None                                                                        *
+     * @throws: std::runtime_error if a replication fails.                                  *
+     ****************************************************************************************/
+    void run(uint16_t num_trucks,
+             uint16_t num_stations,
+             const MiningTimeDistribution& mining_time,
+             uint32_t first_seed,
+             std::span<StateFractions> results);
+
+private:
+    /* Pool the replications run on                                                         */
+    ThreadPool& pool;
+
+    /* Resource the arena buffers come from                                                 */
+    std::pmr::memory_resource* upstream;
+
+    /* Arena buffer of each worker, followed by the one of the calling thread               */
+    std::vector<std::pmr::vector<std::byte>> buffers;
+};
+
+#endif // REPLICATION_HPP
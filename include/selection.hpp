@@ -0,0 +1,619 @@
+/********************************************************************************************
+ * File: selection.hpp                                                                      *
+ *                                                                                          *
+ * Description:                                                                             *
+ *  Contains the station selection policies of the Helium-3 Mining Simulator. A policy      *
+ *  picks the station an arriving truck queues at. Like the mining time distributions,      *
+ *  each policy is a small value type with a templated `select`, so the tick loop is        *
+ *  instantiated once per policy and the pick is inlined without any virtual dispatch.      *
+ *                                                                                          *
+ * Changes:                                                                                 *
+ *  10/16/2026 - Created                                                                    *
+ *                                                                                          *
+ ********************************************************************************************/
+#ifndef SELECTION_HPP
+#define SELECTION_HPP
+
+/********************************************************************************************
+ * Includes                                                                                 *
+ ********************************************************************************************/
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <memory_resource>
+#include <random>
+#include <span>
+#include <variant>
+#include <vector>
+
+/********************************************************************************************
+ * Defines/Macros                                                                           *
+ ********************************************************************************************/
+#define SELECTION_ASSIGNMENTS   1000000u /*Trucks assigned per policy by the benchmark      */
+#define SELECTION_LOAD          0.9     /*Arrivals per station and tick in the benchmark    */
+
+/********************************************************************************************
+ * Enumerations/Classes                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * SelectionPolicy                                                                          *
+ * @brief Station selection policies a Simulation can be constructed with.                  *
+ ********************************************************************************************/
+enum class SelectionPolicy {
+    RoundRobin,
+    ShortestQueue,
+    PowerOfTwo,
+    ShortestWait
+};
+
+/********************************************************************************************
+ * RoundRobinSelector                                                                       *
+ * @brief Sends each arriving truck to the next station in turn.                            *
+ *                                                                                          *
+ * This is the original behavior of the simulator. Every station serves one truck per tick  *
+ * and every arrival is sent to the station after the previous one, so the next station is  *
+ * always one with the shortest queue (see the Notes section of main.hpp). O(1) per truck.  *
+ ********************************************************************************************/
+class RoundRobinSelector {
+public:
+    /* The station `peek` returns always has the shortest queue                             */
+    static constexpr bool picks_shortest = true;
+
+    /****************************************************************************************
+     * RoundRobinSelector Constructor                                                       *
+     * @brief Initializes the selector, `reset` sets it up for a number of stations.        *
+     *                                                                                      *
+     * @param memory: Unused, the selector stores nothing outside of itself.                *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    explicit RoundRobinSelector(std::pmr::memory_resource* memory =
+                                    std::pmr::get_default_resource());
+
+    /****************************************************************************************
+     * reset                                                                                *
+     * @brief Starts over at the first station.                                             *
+     *                                                                                      *
+     * @param num_stations: The number of stations to pick from.                            *
+     * @param seed: Unused, the policy is deterministic.                                    *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void reset(size_t num_stations, uint32_t seed);
+
+    /****************************************************************************************
+     * select                                                                               *
+     * @brief Picks the station for an arriving truck and moves on to the next one.         *
+     *                                                                                      *
+     * @param stations: The stations of the simulation.                                     *
+     * @param tick: The number of ticks the simulation has run, see `Station::get_queue`.   *
+     * @return: size_t - The index of the station the truck queues at.                      *
+     ****************************************************************************************/
+    template<typename Stations>
+    size_t select(Stations& stations, uint32_t tick);
+
+    /****************************************************************************************
+     * peek                                                                                 *
+     * @brief Retrieves the station the next arriving truck would be sent to.               *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: size_t - The index of the station.                                          *
+     ****************************************************************************************/
+    size_t peek() const;
+
+    /****************************************************************************************
+     * resume_after                                                                         *
+     * @brief Sends the next arriving truck to the station after the given one.             *
+     *                                                                                      *
+     * Lets a caller that skipped over stations carry on the rotation from the station it   *
+     * picked instead, so the skipped stations do not all fall to the same one.             *
+     *                                                                                      *
+     * @param station: The index of the station the last truck was sent to.                 *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void resume_after(size_t station);
+
+private:
+    /* Index of the station the next truck is sent to                                       */
+    size_t next;
+
+    /* Number of stations to pick from                                                      */
+    size_t num_stations;
+};
+
+/********************************************************************************************
+ * ShortestQueueSelector                                                                    *
+ * @brief Sends each arriving truck to the station with the shortest queue.                 *
+ *                                                                                          *
+ * Like the stations themselves, the selector keeps the tick at which each station next     *
+ * runs empty (see `Station`). A station's queue is max(0, empty - tick), which orders the  *
+ * stations the same way the empty ticks do, and the empty ticks only change when a truck   *
+ * joins a queue: empty' = max(empty, tick) + 1. The empty ticks are the leaves of a min    *
+ * segment tree stored as an implicit binary heap, so the shortest queue is found by        *
+ * walking down from the root and a join is one leaf to root update,                        *
+ * both O(log S). Ties go to the station that has been empty the longest.                   *
+ ********************************************************************************************/
+class ShortestQueueSelector {
+public:
+    /* The station `peek` returns always has the shortest queue                             */
+    static constexpr bool picks_shortest = true;
+
+    /****************************************************************************************
+     * ShortestQueueSelector Constructor                                                    *
+     * @brief Initializes the selector, `reset` sets it up for a number of stations.        *
+     *                                                                                      *
+     * @param memory: The resource the segment tree is stored in.                           *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    explicit ShortestQueueSelector(std::pmr::memory_resource* memory =
+                                       std::pmr::get_default_resource());
+
+    /****************************************************************************************
+     * reset                                                                                *
+     * @brief Empties every queue, reusing the tree's storage.                              *
+     *                                                                                      *
+     * @param num_stations: The number of stations to pick from.                            *
+     * @param seed: Unused, the policy is deterministic.                                    *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void reset(size_t num_stations, uint32_t seed);
+
+    /****************************************************************************************
+     * select                                                                               *
+     * @brief Picks the station with the shortest queue and records the truck joining it.   *
+     *                                                                                      *
+     * @param stations: The stations of the simulation, unused since the tree mirrors them. *
+     * @param tick: The number of ticks the simulation has run, see `Station::get_queue`.   *
+     * @return: size_t - The index of the station the truck queues at.                      *
+     ****************************************************************************************/
+    template<typename Stations>
+    size_t select(Stations& stations, uint32_t tick);
+
+    /****************************************************************************************
+     * peek                                                                                 *
+     * @brief Retrieves the station the next arriving truck would be sent to.               *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: size_t - The index of the station.                                          *
+     ****************************************************************************************/
+    size_t peek() const;
+
+    /****************************************************************************************
+     * storage_bytes                                                                        *
+     * @brief Computes the memory the selector allocates from its memory resource.          *
+     *                                                                                      *
+     * @param num_stations: The number of stations to pick from.                            *
+     * @return: size_t - The bytes needed, including the worst case alignment padding.      *
+     ****************************************************************************************/
+    static size_t storage_bytes(size_t num_stations);
+
+private:
+    /* Segment tree, node i covers nodes 2i and 2i + 1, the leaves start at `num_leaves`     *
+     * and hold the empty tick of each station, padding leaves hold UINT32_MAX              */
+    std::pmr::vector<uint32_t> empty_ticks;
+
+    /* Number of leaves, the number of stations rounded up to a power of two                */
+    size_t num_leaves;
+
+};
+
+/********************************************************************************************
+ * PowerOfTwoSelector                                                                       *
+ * @brief Sends each arriving truck to the shorter queue of two stations picked at random.  *
+ *                                                                                          *
+ * Two random choices are enough to keep the longest queue within O(log log S) of the       *
+ * average, close to joining the shortest queue, at O(1) per truck and without any state    *
+ * beyond a random number generator. The selector draws from its own generator, so the      *
+ * simulation's mining times are the same whichever policy is used.                         *
+ ********************************************************************************************/
+class PowerOfTwoSelector {
+public:
+    /* The station picked is only the shorter of two, not the shortest of all               */
+    static constexpr bool picks_shortest = false;
+
+    /****************************************************************************************
+     * PowerOfTwoSelector Constructor                                                       *
+     * @brief Initializes the selector, `reset` sets it up for a number of stations.        *
+     *                                                                                      *
+     * @param memory: Unused, the selector stores nothing outside of itself.                *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    explicit PowerOfTwoSelector(std::pmr::memory_resource* memory =
+                                    std::pmr::get_default_resource());
+
+    /****************************************************************************************
+     * reset                                                                                *
+     * @brief Reseeds the selector's random number generator.                               *
+     *                                                                                      *
+     * @param num_stations: The number of stations to pick from.                            *
+     * @param seed: The seed of the generator.                                              *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void reset(size_t num_stations, uint32_t seed);
+
+    /****************************************************************************************
+     * select                                                                               *
+     * @brief Picks the shorter queue of two random stations.                               *
+     *                                                                                      *
+     * @param stations: The stations of the simulation.                                     *
+     * @param tick: The number of ticks the simulation has run, see `Station::get_queue`.   *
+     * @return: size_t - The index of the station the truck queues at.                      *
+     ****************************************************************************************/
+    template<typename Stations>
+    size_t select(Stations& stations, uint32_t tick);
+
+private:
+    /* Generator of the two candidates, cheaper than the simulation's Mersenne Twister      */
+    std::minstd_rand gen;
+
+    /* Number of stations to pick from                                                      */
+    size_t num_stations;
+};
+
+/********************************************************************************************
+ * ExpectedWaitTree                                                                         *
+ * @brief Finds the station a truck that still has to travel would be unloaded at soonest,  *
+ *        in O(log S).                                                                      *
+ *                                                                                          *
+ * A truck setting off now with a trip of `trip` ticks can be unloaded once it has arrived  *
+ * and the trucks queued at the station have been, whichever takes longer, and after the    *
+ * trucks already on their way there, which are assumed to arrive first:                    *
+ *                                                                                          *
+ *     ready = max(trip, queue) + inbound                                                   *
+ *                                                                                          *
+ * The queue is max(0, empty - tick), so ready + tick = max(trip + tick, empty) + inbound.  *
+ * Stations whose queue outlasts the trip ("queue bound") have a fixed ready tick of        *
+ * empty + inbound, the others ("trip bound") one of trip + inbound + tick, which moves on  *
+ * by the same tick for all of them. A segment tree over the stations keeps the minimum of  *
+ * each kind, so both compare correctly at any tick, plus the earliest tick at which a      *
+ * queue bound station becomes trip bound. Picking a station first flips the stations       *
+ * whose tick has come, each at most once per update, then walks down from the root         *
+ * towards the smaller child. Both are O(log S), amortized over the updates.                *
+ *                                                                                          *
+ * Keys hold the ready tick above the trip, so ties go to the shorter trip and then, as     *
+ * the walk prefers the left child, to the lower index.                                     *
+ ********************************************************************************************/
+class ExpectedWaitTree {
+public:
+    /****************************************************************************************
+     * ExpectedWaitTree Constructor                                                         *
+     * @brief Initializes the tree, `reset` sets it up for a row of trips.                  *
+     *                                                                                      *
+     * @param memory: The resource the tree is stored in.                                   *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    explicit ExpectedWaitTree(std::pmr::memory_resource* memory =
+                                  std::pmr::get_default_resource());
+
+    /****************************************************************************************
+     * reset                                                                                *
+     * @brief Sets up one leaf per station with an empty queue and nothing inbound.         *
+     *                                                                                      *
+     * @param trips: The trip to each station in ticks, at most 65534.                      *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void reset(std::span<const uint16_t> trips);
+
+    /****************************************************************************************
+     * update                                                                               *
+     * @brief Records the queue and the inbound trucks of a station.                        *
+     *                                                                                      *
+     * @param leaf: The index of the station in the row of trips.                           *
+     * @param queue: The station's queue at `tick`, see `Station::get_queue`.               *
+     * @param inbound: The trucks on their way to the station.                              *
+     * @param tick: The number of ticks the simulation has run.                             *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void update(size_t leaf, uint32_t queue, uint32_t inbound, uint32_t tick);
+
+    /****************************************************************************************
+     * select                                                                               *
+     * @brief Picks the station a truck setting off now would be unloaded at soonest.       *
+     *                                                                                      *
+     * @param tick: The number of ticks the simulation has run, never less than at the      *
+     *              previous call.                                                          *
+     * @return: size_t - The index of the station in the row of trips.                      *
+     ****************************************************************************************/
+    size_t select(uint32_t tick);
+
+    /****************************************************************************************
+     * storage_bytes                                                                        *
+     * @brief Computes the memory the tree allocates from its memory resource.              *
+     *                                                                                      *
+     * @param num_leaves: The number of stations in the row of trips.                       *
+     * @return: size_t - The bytes needed, including the worst case alignment padding.      *
+     ****************************************************************************************/
+    static size_t storage_bytes(size_t num_leaves);
+
+private:
+    /* Minimum keys of the trip and queue bound stations below a node, and the earliest     *
+     * tick at which one of its queue bound stations becomes trip bound                     */
+    struct Node {
+        uint64_t trip;
+        uint64_t queue;
+        uint32_t flip;
+    };
+
+    /****************************************************************************************
+     * key                                                                                  *
+     * @brief Computes the key of a node at a tick.                                         *
+     *                                                                                      *
+     * @param node: The index of the node.                                                  *
+     * @param tick: The number of ticks the simulation has run.                             *
+     * @return: uint64_t - The smaller key of the two kinds, UINT64_MAX for no station.     *
+     ****************************************************************************************/
+    uint64_t key(size_t node, uint32_t tick) const;
+
+    /****************************************************************************************
+     * pull                                                                                 *
+     * @brief Recomputes a node from its children.                                          *
+     *                                                                                      *
+     * @param node: The index of the node.                                                  *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void pull(size_t node);
+
+    /****************************************************************************************
+     * flip_due                                                                             *
+     * @brief Turns the queue bound stations below a node into trip bound ones once their   *
+     *        queue no longer outlasts the trip.                                            *
+     *                                                                                      *
+     * @param node: The index of the node.                                                  *
+     * @param tick: The number of ticks the simulation has run.                             *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void flip_due(size_t node, uint32_t tick);
+
+    /* Segment tree, node i covers nodes 2i and 2i + 1, the leaves start at `num_leaves`    */
+    std::pmr::vector<Node> nodes;
+
+    /* Trip bound key of each station without the tick, used when a station flips           */
+    std::pmr::vector<uint64_t> trip_keys;
+
+    /* Number of leaves, the number of stations rounded up to a power of two                */
+    size_t num_leaves;
+};
+
+/********************************************************************************************
+ * ShortestWaitSelector                                                                     *
+ * @brief Sends each arriving truck to the station where the trip there plus the queue it   *
+ *        finds is shortest.                                                                *
+ *                                                                                          *
+ * Each station can be given its own trip from where the trucks arrive, e.g. stations       *
+ * spread along a road, and a truck then goes to the nearest station with the shortest      *
+ * expected wait: trip + queue. Without a row of trips every station is TRAVEL_TIME away,   *
+ * the trip only offsets every station by the same amount and the policy joins the          *
+ * shortest queue. Ties go to the shorter trip, then to the lower index.                    *
+ *                                                                                          *
+ * The selector mirrors the stations' empty ticks like ShortestQueueSelector, and feeds     *
+ * trip + queue into an ExpectedWaitTree, whose trip bound stations are the idle ones. A    *
+ * station turns idle once its queue has run empty, so the tree picks in O(log S).          *
+ ********************************************************************************************/
+class ShortestWaitSelector {
+public:
+    /* The station picked waits least counting the trip, not necessarily the shortest queue */
+    static constexpr bool picks_shortest = false;
+
+    /****************************************************************************************
+     * ShortestWaitSelector Constructor                                                     *
+     * @brief Initializes the selector, `reset` sets it up for a number of stations.        *
+     *                                                                                      *
+     * @param travel_time: The trip to every station in ticks, the site's travel time.      *
+     * @param memory: The resource the trips, empty ticks and tree are stored in.           *
+     * @param trips: Optional trip to each station in ticks. Empty for the same             *
+     *               `travel_time` to every station.                                        *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    explicit ShortestWaitSelector(uint16_t travel_time,
+                                  std::pmr::memory_resource* memory =
+                                      std::pmr::get_default_resource(),
+                                  std::span<const uint16_t> trips = {});
+
+    /****************************************************************************************
+     * reset                                                                                *
+     * @brief Empties every queue, reusing the storage.                                     *
+     *                                                                                      *
+     * @param num_stations: The number of stations to pick from.                            *
+     * @param seed: Unused, the policy is deterministic.                                    *
+     * @return: None                                                                        *
+     * @throws: std::invalid_argument if a row of trips was given for a different number    *
+     *          of stations.                                                                *
+     ****************************************************************************************/
+    void reset(size_t num_stations, uint32_t seed);
+
+    /****************************************************************************************
+     * select                                                                               *
+     * @brief Picks the station with the shortest trip plus queue and records the truck     *
+     *        joining it.                                                                   *
+     *                                                                                      *
+     * @param stations: The stations of the simulation, unused since the selector mirrors   *
+     *                  their queues.                                                       *
+     * @param tick: The number of ticks the simulation has run, see `Station::get_queue`.   *
+     * @return: size_t - The index of the station the truck queues at.                      *
+     ****************************************************************************************/
+    template<typename Stations>
+    size_t select(Stations& stations, uint32_t tick);
+
+    /****************************************************************************************
+     * storage_bytes                                                                        *
+     * @brief Computes the memory the selector allocates from its memory resource.          *
+     *                                                                                      *
+     * @param num_stations: The number of stations to pick from.                            *
+     * @return: size_t - The bytes needed, including the worst case alignment padding.      *
+     ****************************************************************************************/
+    static size_t storage_bytes(size_t num_stations);
+
+private:
+    /* Trip to each station, given or filled in by `reset`                                  */
+    std::pmr::vector<uint16_t> trips;
+
+    /* Whether the trips were given, rather than filled in for the number of stations       */
+    bool given;
+
+    /* Trip to every station when none were given                                           */
+    uint16_t travel_time;
+
+    /* Tick at which each station's queue runs empty, see `Station`                         */
+    std::pmr::vector<uint32_t> empty_ticks;
+
+    /* Tree over trip + queue of every station                                              */
+    ExpectedWaitTree tree;
+};
+
+/* Selection policy of a simulation, chosen at run time and dispatched once per run         */
+using StationSelector = std::variant<RoundRobinSelector,
+                                     ShortestQueueSelector,
+                                     PowerOfTwoSelector,
+                                     ShortestWaitSelector>;
+
+/********************************************************************************************
+ * SelectorMetrics                                                                          *
+ * @brief Cost and quality of one selection policy, as measured by `benchmark_selectors`.   *
+ ********************************************************************************************/
+struct SelectorMetrics {
+
+    /* Wall clock time per truck assigned, in nanoseconds                                   */
+    double assign_ns;
+
+    /* Trucks already queued at the station a truck was sent to, on average                 */
+    double mean_queue;
+};
+
+/********************************************************************************************
+ * SelectionReport                                                                          *
+ * @brief Result of `benchmark_selectors`, one entry per policy.                            *
+ ********************************************************************************************/
+struct SelectionReport {
+    size_t num_stations;
+    SelectorMetrics round_robin;
+    SelectorMetrics shortest_queue;
+    SelectorMetrics power_of_two;
+    SelectorMetrics shortest_wait;
+};
+
+/********************************************************************************************
+ * Selection Functions                                                                      *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * make_selector                                                                            *
+ * @brief Creates the selector of a policy.                                                 *
+ *                                                                                          *
+ * @param policy: The selection policy.                                                     *
+ * @param memory: The resource the selector stores its state in.                            *
+ * @param travel_time: The site's travel time, the trip to every station.                   *
+ * @return: StationSelector - The selector, `reset` has to be called before it is used.     *
+ ********************************************************************************************/
+StationSelector make_selector(SelectionPolicy policy, std::pmr::memory_resource* memory,
+                              uint16_t travel_time);
+
+/********************************************************************************************
+ * benchmark_selectors                                                                      *
+ * @brief Measures how long each policy takes to assign a truck, and how long the queues    *
+ *        it sends trucks to are.                                                           *
+ *                                                                                          *
+ * @param num_stations: The number of stations to pick from.                                *
+ * @param num_assignments: The number of trucks each policy assigns.                        *
+ * @return: SelectionReport - The metrics of every policy.                                  *
+ ********************************************************************************************/
+SelectionReport benchmark_selectors(uint16_t num_stations, size_t num_assignments);
+
+/********************************************************************************************
+ * log_selection_report                                                                     *
+ * @brief Outputs the result of `benchmark_selectors` to the console.                       *
+ *                                                                                          *
+ * @param report: The benchmark result to print.                                            *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+void log_selection_report(const SelectionReport& report);
+
+/********************************************************************************************
+ * Template (and Inline) Definitions                                                        *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * RoundRobinSelector::select                                                               *
+ * @brief Picks the station for an arriving truck and moves on to the next one.             *
+ *                                                                                          *
+ * @param stations: The stations of the simulation.                                         *
+ * @param tick: The number of ticks the simulation has run, see `Station::get_queue`.       *
+ * @return: size_t - The index of the station the truck queues at.                          *
+ ********************************************************************************************/
+template<typename Stations>
+size_t RoundRobinSelector::select(Stations&, uint32_t) {
+
+    size_t station = this->next++;
+
+    this->next %= this->num_stations;
+
+    return station;
+}
+
+/********************************************************************************************
+ * ShortestQueueSelector::select                                                            *
+ * @brief Picks the station with the shortest queue and records the truck joining it.       *
+ *                                                                                          *
+ * @param stations: The stations of the simulation, unused since the tree mirrors them.     *
+ * @param tick: The number of ticks the simulation has run, see `Station::get_queue`.       *
+ * @return: size_t - The index of the station the truck queues at.                          *
+ ********************************************************************************************/
+template<typename Stations>
+size_t ShortestQueueSelector::select(Stations&, uint32_t tick) {
+
+    size_t station = this->peek();
+    size_t node = this->num_leaves + station;
+
+    /* The truck joins behind the trucks still queued, or starts a new queue now            */
+    this->empty_ticks[node] = std::max(this->empty_ticks[node], tick) + 1;
+
+    for(node /= 2; node > 0; node /= 2) {
+        this->empty_ticks[node] = std::min(this->empty_ticks[2 * node],
+                                           this->empty_ticks[2 * node + 1]);
+    }
+
+    return station;
+}
+
+/********************************************************************************************
+ * PowerOfTwoSelector::select                                                               *
+ * @brief Picks the shorter queue of two random stations.                                   *
+ *                                                                                          *
+ * @param stations: The stations of the simulation.                                         *
+ * @param tick: The number of ticks the simulation has run, see `Station::get_queue`.       *
+ * @return: size_t - The index of the station the truck queues at.                          *
+ ********************************************************************************************/
+template<typename Stations>
+size_t PowerOfTwoSelector::select(Stations& stations, uint32_t tick) {
+
+    size_t first = this->gen() % this->num_stations;
+    size_t second = this->gen() % this->num_stations;
+
+    return (stations[second].get_queue(tick) < stations[first].get_queue(tick)) ? second
+                                                                            : first;
+}
+
+/********************************************************************************************
+ * ShortestWaitSelector::select                                                             *
+ * @brief Picks the station with the shortest trip plus queue and records the truck joining *
+ *        it.                                                                               *
+ *                                                                                          *
+ * @param stations: The stations of the simulation, unused since the selector mirrors their *
+ *                  queues.                                                                 *
+ * @param tick: The number of ticks the simulation has run, see `Station::get_queue`.       *
+ * @return: size_t - The index of the station the truck queues at.                          *
+ ********************************************************************************************/
+template<typename Stations>
+size_t ShortestWaitSelector::select(Stations&, uint32_t tick) {
+
+    size_t station = this->tree.select(tick);
+
+    /* The truck joins behind the trucks still queued, or starts a new queue now            */
+    this->empty_ticks[station] = std::max(this->empty_ticks[station], tick) + 1;
+
+    uint32_t queue = this->empty_ticks[station] - tick;
+
+    this->tree.update(station, this->trips[station] + queue, 0, tick);
+
+    return station;
+}
+
+#endif // SELECTION_HPP
@@ -0,0 +1,237 @@
+/********************************************************************************************
+ * File: steady_state.hpp                                                                   *
+ *                                                                                          *
+ * Description:                                                                             *
+ *  Contains the steady state detector of the Helium-3 Mining Simulator. The detector       *
+ *  runs alongside the tick loop, estimates the length of the initial transient and         *
+ *  stops the simulation once the fleet-wide state fractions are known to within a          *
+ *  requested tolerance, instead of always running for a fixed horizon.                     *
+ *                                                                                          *
+ * Changes:                                                                                 *
+ *  10/16/2026 - Created                                                                    *
+ *                                                                                          *
+ ********************************************************************************************/
+#ifndef STEADY_STATE_HPP
+#define STEADY_STATE_HPP
+
+/********************************************************************************************
+ * Includes                                                                                 *
+ ********************************************************************************************/
+#include <array>
+#include <cmath>
+#include <limits>
+
+#ifndef MAIN_HPP
+#include "../include/main.hpp"
+#endif
+
+/********************************************************************************************
+ * Defines/Macros                                                                           *
+ ********************************************************************************************/
+#define MSER_BATCH_SIZE         5u      /*Ticks per batch of the MSER-5 warm-up rule        */
+#define STEADY_STATE_BATCHES    20u     /*Batches of the batch means confidence interval    */
+#define STEADY_STATE_T_VALUE    2.093   /*Student t, 95% interval, 19 degrees of freedom    */
+#define STEADY_STATE_INTERVAL   60u     /*Scale: 5 mins/bit, 60*5 = 5 hours between checks  */
+#define STEADY_STATE_EPSILON    0.005   /*Default interval half width, 0.005 = +/- 0.5%     */
+
+/********************************************************************************************
+ * Enumerations/Classes                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * SteadyStateReport                                                                        *
+ * @brief Result of running a simulation until it reached steady state.                     *
+ ********************************************************************************************/
+struct SteadyStateReport {
+
+    /* Whether every category reached the requested tolerance before the tick limit         */
+    bool converged;
+
+    /* Length of the initial transient, specified or detected by MSER-5, in ticks           */
+    size_t warmup_ticks;
+
+    /* Ticks at the start of the run whose statistics were reset, 0 if none were            */
+    size_t truncated_ticks;
+
+    /* Total number of ticks simulated, including the warm-up                               */
+    size_t ticks_run;
+
+    /* Steady state fraction of the fleet in each category, excluding the warm-up           */
+    StateFractions mean;
+
+    /* Half width of the 95% batch means confidence interval of each category               */
+    StateFractions half_width;
+};
+
+/********************************************************************************************
+ * SteadyStateDetector                                                                      *
+ * @brief Tick loop observer that stops the simulation once it has reached steady state.    *
+ *                                                                                          *
+ * Every tick the detector records which fraction of the fleet is in each category,         *
+ * building one time series per category. Every STEADY_STATE_INTERVAL ticks it:             *
+ * 1. Estimates the warm-up with the MSER-5 rule: the series is averaged in batches of      *
+ *    five ticks, and the warm-up is the truncation point (within the first half) that      *
+ *    minimizes the squared standard error of the remaining batches. The warm-up of the     *
+ *    simulation is the longest warm-up across the categories.                              *
+ * 2. Splits the ticks after the warm-up into STEADY_STATE_BATCHES batch means and          *
+ *    computes the 95% confidence interval of each category from them.                      *
+ * 3. Stops the simulation when every half width is within the tolerance.                   *
+ *                                                                                          *
+ * Each check is O(ticks), and only happens every few hours of simulated time, so the       *
+ * cost of the detector is dominated by counting the state of each truck every tick.        *
+ ********************************************************************************************/
+class SteadyStateDetector {
+public:
+    /****************************************************************************************
+     * SteadyStateDetector Constructor                                                      *
+     * @brief Initializes the detector for a fleet and a tolerance.                         *
+     *                                                                                      *
+     * @param num_trucks: The number of trucks in the simulation.                           *
+     * @param epsilon: The largest accepted half width of the 95% confidence interval,      *
+     *                 as a fraction (0.005 is +/- 0.5%).                                   *
+     * @param max_ticks: The tick limit, the simulation stops here even if it has not       *
+     *                   converged.                                                         *
+     * @param truncate: Optional simulation whose statistics are reset once the warm-up     *
+     *                  has been detected, nullptr to leave the statistics untouched.       *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    SteadyStateDetector(size_t num_trucks,
+                        double epsilon,
+                        size_t max_ticks,
+                        Simulation* truncate = nullptr);
+
+    /****************************************************************************************
+     * observe                                                                              *
+     * @brief Counts the category of a truck for the current tick.                          *
+     *                                                                                      *
+     * @param truck: The truck about to run.                                                *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void observe(Truck& truck);
+
+    /****************************************************************************************
+     * next_tick                                                                            *
+     * @brief Records the tick that just finished and decides whether to run another one.   *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: bool - False once the simulation has converged or hit the tick limit.       *
+     ****************************************************************************************/
+    bool next_tick();
+
+    /****************************************************************************************
+     * leap                                                                                 *
+     * @brief Never lets the tick loop skip a tick, every tick is a sample of the series.   *
+     *                                                                                      *
+     * @param ticks: The number of ticks the tick loop would like to skip.                  *
+     * @return: size_t - Always 0.                                                          *
+     ****************************************************************************************/
+    size_t leap(size_t ticks);
+
+    /****************************************************************************************
+     * get_report                                                                           *
+     * @brief Evaluates the recorded time series and reports the steady state estimate.     *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: SteadyStateReport - The warm-up, the steady state fractions and their       *
+     *          confidence intervals.                                                       *
+     ****************************************************************************************/
+    SteadyStateReport get_report();
+
+private:
+    /****************************************************************************************
+     * mser_warmup                                                                          *
+     * @brief Estimates the warm-up of one category's time series using MSER-5.             *
+     *                                                                                      *
+     * @param series: The fraction of the fleet in the category at every tick.              *
+     * @return: size_t - The number of ticks to discard from the start of the series.       *
+     ****************************************************************************************/
+    static size_t mser_warmup(const std::vector<double>& series);
+
+    /* Number of trucks in each category during the current tick                            */
+    std::array<size_t, 4> counts;
+
+    /* Fraction of the fleet in each category at every tick so far                          */
+    std::array<std::vector<double>, 4> series;
+
+    /* Number of trucks in the simulation                                                   */
+    double num_trucks;
+
+    /* Largest accepted half width of the confidence intervals                              */
+    double epsilon;
+
+    /* Tick limit of the simulation                                                         */
+    size_t max_ticks;
+
+    /* Number of ticks started so far                                                       */
+    size_t ticks;
+
+    /* Simulation whose statistics are reset after the warm-up, may be nullptr              */
+    Simulation* truncate;
+
+    /* Tick at which the statistics were reset, 0 if they have not been                     */
+    size_t truncated;
+};
+
+/********************************************************************************************
+ * Steady State Functions                                                                   *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * run_until_steady                                                                         *
+ * @brief Runs a simulation until its state fractions are at steady state +/- epsilon.      *
+ *                                                                                          *
+ * Afterwards the simulation's `total_time` is the number of ticks recorded after the       *
+ * warm-up, so its results can be logged as usual.                                          *
+ *                                                                                          *
+ * @param sim: The simulation to run.                                                       *
+ * @param epsilon: The largest accepted half width of the 95% confidence interval.          *
+ * @param max_ticks: The tick limit. Each category is recorded in 16 bits, so this is       *
+ *                   capped at 65535.                                                       *
+ * @return: SteadyStateReport - The warm-up, the steady state fractions and their           *
+ *          confidence intervals.                                                           *
+ ********************************************************************************************/
+SteadyStateReport run_until_steady(Simulation& sim, double epsilon, size_t max_ticks);
+
+/********************************************************************************************
+ * log_steady_state_report                                                                  *
+ * @brief Outputs a steady state report to the console.                                     *
+ *                                                                                          *
+ * @param report: The report to print.                                                      *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+void log_steady_state_report(const SteadyStateReport& report);
+
+/********************************************************************************************
+ * Inline Definitions                                                                       *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * SteadyStateDetector::observe                                                             *
+ * @brief Counts the category of a truck for the current tick.                              *
+ *                                                                                          *
+ * The categories are indexed in the order of `StateFractions`: waiting, unloading,         *
+ * traveling and mining. Both travel states count as traveling.                             *
+ *                                                                                          *
+ * @param truck: The truck about to run.                                                    *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+inline void SteadyStateDetector::observe(Truck& truck) {
+
+    /* Category of each TruckState, in the order the states are declared                    */
+    static constexpr size_t category[] = {3, 2, 0, 1, 2};
+
+    this->counts[category[static_cast<size_t>(truck.get_state())]]++;
+}
+
+/********************************************************************************************
+ * SteadyStateDetector::leap                                                                *
+ * @brief Never lets the tick loop skip a tick, every tick is a sample of the series.       *
+ *                                                                                          *
+ * @param ticks: The number of ticks the tick loop would like to skip.                      *
+ * @return: size_t - Always 0.                                                              *
+ ********************************************************************************************/
+inline size_t SteadyStateDetector::leap(size_t) {
+    return 0;
+}
+
+#endif // STEADY_STATE_HPP
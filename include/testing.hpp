@@ -14,10 +14,217 @@
 /********************************************************************************************
  * Includes                                                                                 *
  ********************************************************************************************/
+#include <atomic>
+#include <memory_resource>
+
 #ifndef MAIN_HPP
 #include "../include/main.hpp"
 #endif
 
+/********************************************************************************************
+ * Enumerations/Classes                                                                     *
+ ********************************************************************************************/
+enum class OutagePolicy;
+
+/********************************************************************************************
+ * CountingResource                                                                         *
+ * @brief Memory resource that counts the allocations passed through it to its upstream.    *
+ *                                                                                          *
+ * Used as the upstream of an arena to verify that the arena serves every allocation        *
+ * itself once it has grown to its steady state size. The counters are atomic, so one       *
+ * counter can sit below the arenas of several threads.                                     *
+ ********************************************************************************************/
+class CountingResource : public std::pmr::memory_resource {
+public:
+    /****************************************************************************************
+     * CountingResource Constructor                                                         *
+     * @brief Initializes the counters to zero.                                             *
+     *                                                                                      *
+     * @param upstream: The resource the allocations are passed to.                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    explicit CountingResource(std::pmr::memory_resource* upstream =
+                              std::pmr::new_delete_resource());
+
+    /****************************************************************************************
+     * get_allocations                                                                      *
+     * @brief Retrieves the number of allocations since construction or the last reset.     *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: size_t - The number of allocations.                                         *
+     ****************************************************************************************/
+    size_t get_allocations() const;
+
+    /****************************************************************************************
+     * get_bytes                                                                            *
+     * @brief Retrieves the bytes allocated since construction or the last reset.           *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: size_t - The number of bytes.                                               *
+     ****************************************************************************************/
+    size_t get_bytes() const;
+
+    /****************************************************************************************
+     * reset                                                                                *
+     * @brief Sets the counters back to zero, e.g. once the arenas have warmed up.          *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void reset();
+
+private:
+    /****************************************************************************************
+     * do_allocate                                                                          *
+     * @brief Counts the allocation and passes it upstream.                                 *
+     *                                                                                      *
+     * @param bytes: The size of the allocation.                                            *
+     * @param alignment: The alignment of the allocation.                                   *
+     * @return: void* - The allocated memory.                                               *
+     ****************************************************************************************/
+    void* do_allocate(size_t bytes, size_t alignment) override;
+
+    /****************************************************************************************
+     * do_deallocate                                                                        *
+     * @brief Returns memory upstream.                                                      *
+     *                                                                                      *
+     * @param p: The memory to return.                                                      *
+     * @param bytes: The size of the allocation.                                            *
+     * @param alignment: The alignment of the allocation.                                   *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+
+    /****************************************************************************************
+     * do_is_equal                                                                          *
+     * @brief Checks whether memory from one resource can be returned to the other.         *
+     *                                                                                      *
+     * @param other: The resource to compare against.                                       *
+     * @return: bool - True only for the same resource.                                     *
+     ****************************************************************************************/
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    /* Resource the allocations are passed to                                               */
+    std::pmr::memory_resource* upstream;
+
+    /* Allocations and bytes passed upstream                                                */
+    std::atomic<size_t> allocations;
+    std::atomic<size_t> bytes;
+};
+
+/********************************************************************************************
+ * NoChecks                                                                                 *
+ * @brief Check policy of the release tick loop, every check compiles to nothing.           *
+ *                                                                                          *
+ * The tick loops take the consistency checks as a policy, like the mining time, so the     *
+ * `debug` flag is read once per run by `select_checks` rather than once per truck, and     *
+ * the release instantiation contains no debug branches at all.                             *
+ ********************************************************************************************/
+struct NoChecks {
+
+    /****************************************************************************************
+     * check_selection                                                                      *
+     * @brief Skips verifying the station the selection policy picks next.                  *
+     *                                                                                      *
+     * @param stations: The stations of the simulation.                                     *
+     * @param tick: The number of ticks the simulation has run.                             *
+     * @param selector: The station selection policy of the simulation.                     *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename Selector>
+    void check_selection(std::pmr::vector<Station>& stations, uint32_t tick,
+                         const Selector& selector) const;
+
+    /****************************************************************************************
+     * check_total_time                                                                     *
+     * @brief Skips verifying the time recorded by a truck.                                 *
+     *                                                                                      *
+     * @param truck: The truck whose total time would be verified.                          *
+     * @param max_time: The expected total simulation time.                                 *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void check_total_time(Truck& truck, size_t max_time) const;
+
+    /****************************************************************************************
+     * check_fleet_size                                                                     *
+     * @brief Skips verifying the number of trucks a cohort simulation accounts for.        *
+     *                                                                                      *
+     * @param counted: The number of trucks in every cohort and queue.                      *
+     * @param num_trucks: The number of trucks in the fleet.                                *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void check_fleet_size(uint64_t counted, uint64_t num_trucks) const;
+
+    /****************************************************************************************
+     * check_station                                                                        *
+     * @brief Skips verifying the station a topology simulation's trees picked.             *
+     *                                                                                      *
+     * @param chosen: The index of the station the tree picked.                             *
+     * @param scan: Would return the index of the station a scan of the routes picks.       *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename Scan>
+    void check_station(size_t chosen, Scan&& scan) const;
+};
+
+/********************************************************************************************
+ * DebugChecks                                                                              *
+ * @brief Check policy of the debug tick loop, runs every consistency check.                *
+ ********************************************************************************************/
+struct DebugChecks {
+
+    /****************************************************************************************
+     * check_selection                                                                      *
+     * @brief Verifies that a policy meant to pick the shortest queue would pick one next,  *
+     *        see `compare_idx_val_to_actual_min`.                                          *
+     *                                                                                      *
+     * @param stations: The stations of the simulation.                                     *
+     * @param tick: The number of ticks the simulation has run.                             *
+     * @param selector: The station selection policy of the simulation.                     *
+     * @return: None                                                                        *
+     * @throws: std::runtime_error if the station picked next is not the shortest.          *
+     ****************************************************************************************/
+    template<typename Selector>
+    void check_selection(std::pmr::vector<Station>& stations, uint32_t tick,
+                         const Selector& selector) const;
+
+    /****************************************************************************************
+     * check_total_time                                                                     *
+     * @brief Verifies the time recorded by a truck, see `compare_total_time_to_max_time`.  *
+     *                                                                                      *
+     * @param truck: The truck whose total time is verified.                                *
+     * @param max_time: The expected total simulation time.                                 *
+     * @return: None                                                                        *
+     * @throws: std::runtime_error if the recorded time does not match `max_time`.          *
+     ****************************************************************************************/
+    void check_total_time(Truck& truck, size_t max_time) const;
+
+    /****************************************************************************************
+     * check_fleet_size                                                                     *
+     * @brief Verifies the number of trucks a cohort simulation accounts for, see           *
+     *        `compare_fleet_size_to_num_trucks`.                                           *
+     *                                                                                      *
+     * @param counted: The number of trucks in every cohort and queue.                      *
+     * @param num_trucks: The number of trucks in the fleet.                                *
+     * @return: None                                                                        *
+     * @throws: std::runtime_error if a truck has been lost or made up.                     *
+     ****************************************************************************************/
+    void check_fleet_size(uint64_t counted, uint64_t num_trucks) const;
+
+    /****************************************************************************************
+     * check_station                                                                        *
+     * @brief Verifies the station a topology simulation's trees picked, see                *
+     *        `compare_station_to_scan`.                                                    *
+     *                                                                                      *
+     * @param chosen: The index of the station the tree picked.                             *
+     * @param scan: Returns the index of the station a scan of the routes picks.            *
+     * @return: None                                                                        *
+     * @throws: std::runtime_error if the stations differ.                                  *
+     ****************************************************************************************/
+    template<typename Scan>
+    void check_station(size_t chosen, Scan&& scan) const;
+};
+
 /********************************************************************************************
  * Testing Functions                                                                        *
  ********************************************************************************************/
@@ -37,11 +244,13 @@
  *                  stations in the simulation.                                             *
  * @param curr_idx: A reference to the current index in the stations vector, which          *
  *                  is expected to point to the station with the shortest wait time.        *
+ * @param tick: The number of ticks the simulation has run, the queues are computed at it.  *
  * @return: None                                                                            *
  * @throws: std::runtime_error if the station at `curr_idx` does not have the               *
  *          shortest queue in the vector.                                                   *
  ********************************************************************************************/
-void compare_idx_val_to_actual_min(std::vector<Station>& stations, size_t& curr_idx);
+void compare_idx_val_to_actual_min(std::pmr::vector<Station>& stations, size_t& curr_idx,
+                                   uint32_t tick);
 
 /********************************************************************************************
  * compare_total_time_to_max_time                                                           *
@@ -63,4 +272,251 @@ void compare_idx_val_to_actual_min(std::vector<Station>& stations, size_t& curr_
  ********************************************************************************************/
 void compare_total_time_to_max_time(Truck& truck, size_t max_time);
 
+/********************************************************************************************
+ * compare_allocations_to_zero                                                              *
+ * @brief Verifies that nothing was allocated through a counting resource.                  *
+ *                                                                                          *
+ * This function checks the counters of a `CountingResource` that sits below a set of       *
+ * arenas. If anything was allocated since the counters were last reset, it logs an error   *
+ * message and throws a `std::runtime_error` exception. This is done to verify that the     *
+ * arenas serve every allocation of a batch of simulations once they have warmed up.        *
+ *                                                                                          *
+ * @param counter: The resource whose counters are checked.                                 *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if any allocation reached the counting resource.             *
+ ********************************************************************************************/
+void compare_allocations_to_zero(const CountingResource& counter);
+
+/********************************************************************************************
+ * compare_fleet_size_to_num_trucks                                                         *
+ * @brief Verifies that a cohort simulation accounts for every truck of its fleet.          *
+ *                                                                                          *
+ * This function compares the number of trucks in every cohort and station queue of a       *
+ * `CohortSimulation` to the size of its fleet. Cohorts only ever move trucks on, split     *
+ * or merge, so if the two differ, it logs an error message and throws a                    *
+ * `std::runtime_error` exception. This is done to verify that no split loses or makes      *
+ * up trucks.                                                                               *
+ *                                                                                          *
+ * @param counted: The number of trucks in every cohort and queue.                          *
+ * @param num_trucks: The number of trucks in the fleet.                                    *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if the counts differ.                                        *
+ ********************************************************************************************/
+void compare_fleet_size_to_num_trucks(uint64_t counted, uint64_t num_trucks);
+
+/********************************************************************************************
+ * compare_station_to_scan                                                                  *
+ * @brief Verifies that a topology simulation's trees pick the station a full scan of the   *
+ *        site's routes picks.                                                              *
+ *                                                                                          *
+ * This function compares the station a site's ExpectedWaitTree picked for a departing      *
+ * truck with the one found by scanning every route of the site. If the two differ, it      *
+ * logs an error message and throws a `std::runtime_error` exception. This is done to       *
+ * verify that the trees are kept up to date with the queues and inbound trucks.            *
+ *                                                                                          *
+ * @param chosen: The index of the station the tree picked.                                 *
+ * @param scanned: The index of the station the scan picked.                                *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if the stations differ.                                      *
+ ********************************************************************************************/
+void compare_station_to_scan(size_t chosen, size_t scanned);
+
+/********************************************************************************************
+ * compare_reset_run_to_fresh_run                                                           *
+ * @brief Verifies that a simulation reset to a seed reproduces a fresh simulation with     *
+ *        that seed.                                                                        *
+ *                                                                                          *
+ * This function runs a fresh `Simulation`, then runs a second one with another seed,       *
+ * resets it to the first seed and runs it again. If any truck of the two runs recorded     *
+ * a different time, it logs an error message and throws a `std::runtime_error`             *
+ * exception. This is done to verify that nothing the generator, the selector or the        *
+ * distribution keeps between draws survives a reset.                                       *
+ *                                                                                          *
+ * @param num_trucks: The number of trucks to be simulated.                                 *
+ * @param num_stations: The number of stations available in the simulation.                 *
+ * @param mining_time: The distribution of mining times of both simulations.                *
+ * @param seed: The seed of the fresh simulation and of the reset.                          *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if the two runs differ.                                      *
+ ********************************************************************************************/
+void compare_reset_run_to_fresh_run(uint16_t num_trucks, uint16_t num_stations,
+                                    const MiningTimeDistribution& mining_time,
+                                    uint32_t seed);
+
+/********************************************************************************************
+ * compare_outages_to_schedule                                                              *
+ * @brief Verifies that the maintenance windows take the stations down and bring them back  *
+ *        up on time, and that no truck loses or gains time to an outage.                   *
+ *                                                                                          *
+ * The first run has only the windows: the first half of the stations goes down for two     *
+ * hours, and every station for one hour in the middle of it, so the arriving trucks also   *
+ * have to wait at a station that is down. The second run adds random failures. Both are    *
+ * stepped one tick at a time. After each tick of the first run every station is compared   *
+ * to the windows, and after each tick of either run no truck may have started unloading    *
+ * at a station that is down. With the trucks rerouted, no truck may wait at a station      *
+ * that is down either while another station is up. If any of these fails, or a truck's     *
+ * time does not add up to the horizon, it logs an error message and throws a               *
+ * `std::runtime_error` exception.                                                          *
+ *                                                                                          *
+ * @param num_trucks: The number of trucks to be simulated.                                 *
+ * @param num_stations: The number of stations, the windows need at least two.              *
+ * @param policy: What the trucks queued at a station that goes down do.                    *
+ * @param seed: The seed of the simulations.                                                *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if a station is up or down outside of its windows, a truck   *
+ *          is at a station that is down, or a truck's recorded time does not match the     *
+ *          horizon.                                                                        *
+ ********************************************************************************************/
+void compare_outages_to_schedule(uint16_t num_trucks, uint16_t num_stations,
+                                 OutagePolicy policy, uint32_t seed);
+
+/********************************************************************************************
+ * select_checks                                                                            *
+ * @brief Calls `body` with the check policy matching the debug flag.                       *
+ *                                                                                          *
+ * @param debug: Whether the consistency checks are enabled.                                *
+ * @param body: Called with a `DebugChecks` or a `NoChecks` object.                         *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename Body>
+void select_checks(bool debug, Body&& body);
+
+/********************************************************************************************
+ * Template and Inline Definitions                                                          *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * NoChecks::check_selection                                                                *
+ * @brief Skips verifying the station the selection policy picks next.                      *
+ *                                                                                          *
+ * @param stations: The stations of the simulation.                                         *
+ * @param tick: The number of ticks the simulation has run.                                 *
+ * @param selector: The station selection policy of the simulation.                         *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename Selector>
+void NoChecks::check_selection(std::pmr::vector<Station>&, uint32_t, const Selector&) const {}
+
+/********************************************************************************************
+ * NoChecks::check_total_time                                                               *
+ * @brief Skips verifying the time recorded by a truck.                                     *
+ *                                                                                          *
+ * @param truck: The truck whose total time would be verified.                              *
+ * @param max_time: The expected total simulation time.                                     *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+inline void NoChecks::check_total_time(Truck&, size_t) const {}
+
+/********************************************************************************************
+ * NoChecks::check_fleet_size                                                               *
+ * @brief Skips verifying the number of trucks a cohort simulation accounts for.            *
+ *                                                                                          *
+ * @param counted: The number of trucks in every cohort and queue.                          *
+ * @param num_trucks: The number of trucks in the fleet.                                    *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+inline void NoChecks::check_fleet_size(uint64_t, uint64_t) const {}
+
+/********************************************************************************************
+ * NoChecks::check_station                                                                  *
+ * @brief Skips verifying the station a topology simulation's trees picked, without         *
+ *        running the scan.                                                                 *
+ *                                                                                          *
+ * @param chosen: The index of the station the tree picked.                                 *
+ * @param scan: Would return the index of the station a scan of the routes picks.           *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename Scan>
+void NoChecks::check_station(size_t, Scan&&) const {}
+
+/********************************************************************************************
+ * DebugChecks::check_selection                                                             *
+ * @brief Verifies that a policy meant to pick the shortest queue would pick one next, see  *
+ *        `compare_idx_val_to_actual_min`.                                                  *
+ *                                                                                          *
+ * Policies that only approximate the shortest queue, like `PowerOfTwoSelector`, have       *
+ * nothing to verify.                                                                       *
+ *                                                                                          *
+ * @param stations: The stations of the simulation.                                         *
+ * @param tick: The number of ticks the simulation has run.                                 *
+ * @param selector: The station selection policy of the simulation.                         *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if the station picked next is not the shortest.              *
+ ********************************************************************************************/
+template<typename Selector>
+void DebugChecks::check_selection(std::pmr::vector<Station>& stations, uint32_t tick,
+                                  const Selector& selector) const {
+
+    if constexpr(Selector::picks_shortest) {
+
+        size_t curr_idx = selector.peek();
+
+        compare_idx_val_to_actual_min(stations, curr_idx, tick);
+    }
+}
+
+/********************************************************************************************
+ * DebugChecks::check_total_time                                                            *
+ * @brief Verifies the time recorded by a truck, see `compare_total_time_to_max_time`.      *
+ *                                                                                          *
+ * @param truck: The truck whose total time is verified.                                    *
+ * @param max_time: The expected total simulation time.                                     *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if the recorded time does not match `max_time`.              *
+ ********************************************************************************************/
+inline void DebugChecks::check_total_time(Truck& truck, size_t max_time) const {
+    compare_total_time_to_max_time(truck, max_time);
+}
+
+/********************************************************************************************
+ * DebugChecks::check_fleet_size                                                            *
+ * @brief Verifies the number of trucks a cohort simulation accounts for, see               *
+ *        `compare_fleet_size_to_num_trucks`.                                               *
+ *                                                                                          *
+ * @param counted: The number of trucks in every cohort and queue.                          *
+ * @param num_trucks: The number of trucks in the fleet.                                    *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if a truck has been lost or made up.                         *
+ ********************************************************************************************/
+inline void DebugChecks::check_fleet_size(uint64_t counted, uint64_t num_trucks) const {
+    compare_fleet_size_to_num_trucks(counted, num_trucks);
+}
+
+/********************************************************************************************
+ * DebugChecks::check_station                                                               *
+ * @brief Verifies the station a topology simulation's trees picked, see                    *
+ *        `compare_station_to_scan`.                                                        *
+ *                                                                                          *
+ * @param chosen: The index of the station the tree picked.                                 *
+ * @param scan: Returns the index of the station a scan of the routes picks.                *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if the stations differ.                                      *
+ ********************************************************************************************/
+template<typename Scan>
+void DebugChecks::check_station(size_t chosen, Scan&& scan) const {
+    compare_station_to_scan(chosen, scan());
+}
+
+/********************************************************************************************
+ * select_checks                                                                            *
+ * @brief Calls `body` with the check policy matching the debug flag.                       *
+ *                                                                                          *
+ * The flag is only read here, so `body` is instantiated once per policy and neither        *
+ * instantiation branches on it.                                                            *
+ *                                                                                          *
+ * @param debug: Whether the consistency checks are enabled.                                *
+ * @param body: Called with a `DebugChecks` or a `NoChecks` object.                         *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename Body>
+void select_checks(bool debug, Body&& body) {
+
+    if(debug) {
+        body(DebugChecks{});
+    }
+    else {
+        body(NoChecks{});
+    }
+}
+
 #endif // TESTING_HPP
\ No newline at end of file
@@ -0,0 +1,444 @@
+/********************************************************************************************
+ * File: thread_pool.hpp                                                                    *
+ *                                                                                          *
+ * Description:                                                                             *
+ *  Contains the work-stealing thread pool of the Helium-3 Mining Simulator. Every parallel *
+ *  mode runs its work on one pool, so nested parallelism (e.g. a sweep running parallel    *
+ *  replications of parallel simulations) shares the same workers instead of starting       *
+ *  more threads than there are cores.                                                      *
+ *                                                                                          *
+ * Changes:                                                                                 *
+ *  10/16/2026 - Created                                                                    *
+ *                                                                                          *
+ ********************************************************************************************/
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+/********************************************************************************************
+ * Includes                                                                                 *
+ ********************************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/********************************************************************************************
+ * Defines/Macros                                                                           *
+ ********************************************************************************************/
+#define CACHE_LINE_SIZE         64u     /*Bytes, keeps data written by each thread apart    */
+#define TASKS_PER_WORKER        4u      /*Tasks per worker and loop, spare ones get stolen  */
+#define MIN_TASK_SIZE           1024u   /*Fewest trucks worth scheduling as a single task   */
+#define POOL_SPIN_COUNT         4096u   /*Failed steal rounds before a worker goes to sleep */
+
+/********************************************************************************************
+ * Enumerations/Classes                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * WorkerMetrics                                                                            *
+ * @brief Counters of one worker of a ThreadPool since it was created or last reset.        *
+ ********************************************************************************************/
+struct WorkerMetrics {
+
+    /* Tasks run by the worker, including the stolen ones                                   */
+    size_t tasks_run;
+
+    /* Tasks taken from the deque of another worker                                         */
+    size_t steals;
+
+    /* Rounds in which every other deque was empty too                                      */
+    size_t failed_steals;
+
+    /* Wall clock time spent without a task, spinning or asleep, in microseconds            */
+    double idle_us;
+
+    /* NUMA node the worker runs on, see `current_numa_node`                                */
+    int node;
+};
+
+/********************************************************************************************
+ * ThreadPool                                                                               *
+ * @brief Fixed set of worker threads that balance loops between them by work stealing.     *
+ *                                                                                          *
+ * Each worker owns a deque of tasks. A worker pushes and pops tasks at the back of its own *
+ * deque, which keeps recently split work on the core that split it, and when its deque     *
+ * is empty it steals from the front of the other workers' deques, which holds the oldest   *
+ * and largest pieces of work. Workers that find nothing to steal spin for a while and      *
+ * then sleep until new tasks are submitted.                                                *
+ *                                                                                          *
+ * Work is submitted with `parallel_for`, which splits a range into tasks and blocks until  *
+ * they are all done. The calling thread runs tasks while it waits, so a task can call      *
+ * `parallel_for` itself without deadlocking or needing extra threads.                      *
+ *                                                                                          *
+ * Loops whose chunks have to run on the same worker every time, e.g. so each worker keeps  *
+ * advancing the trucks it placed on its NUMA node, use `parallel_for_static` instead. It   *
+ * hands chunk i to worker i % size() and none of its chunks can be stolen.                 *
+ *                                                                                          *
+ * Workers can optionally be pinned to one CPU each, in order, so consecutive workers       *
+ * share a NUMA node and its caches.                                                        *
+ ********************************************************************************************/
+class ThreadPool {
+public:
+    /****************************************************************************************
+     * ThreadPool Constructor                                                               *
+     * @brief Starts the worker threads.                                                    *
+     *                                                                                      *
+     * @param num_workers: The number of worker threads, at least 1.                        *
+     * @param pin_workers: Whether to pin each worker to its own CPU.                       *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    explicit ThreadPool(size_t num_workers = std::thread::hardware_concurrency(),
+                        bool pin_workers = false);
+
+    /****************************************************************************************
+     * ThreadPool Destructor                                                                *
+     * @brief Waits for the queued tasks to finish and stops the worker threads.            *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /****************************************************************************************
+     * parallel_for                                                                         *
+     * @brief Runs `body(first, last)` over [begin, end) in tasks of `grain` indices and    *
+     *        waits for all of them.                                                        *
+     *                                                                                      *
+     * @param begin: The first index of the range.                                          *
+     * @param end: One past the last index of the range.                                    *
+     * @param grain: The number of indices per task, see `grain_size`.                      *
+     * @param body: Called with the bounds of each task, from any thread of the pool.       *
+     * @return: None                                                                        *
+     * @throws: The first exception thrown by `body`, once every task has finished.         *
+     ****************************************************************************************/
+    template<typename Body>
+    void parallel_for(size_t begin, size_t end, size_t grain, Body&& body);
+
+    /****************************************************************************************
+     * parallel_for_static                                                                  *
+     * @brief Runs `body(first, last)` over [begin, end) in tasks of `grain` indices, task  *
+     *        i always on worker i % size(), and waits for all of them.                     *
+     *                                                                                      *
+     * @param begin: The first index of the range.                                          *
+     * @param end: One past the last index of the range.                                    *
+     * @param grain: The number of indices per task, see `grain_size`.                      *
+     * @param body: Called with the bounds of each task, from the worker the task maps to.  *
+     * @return: None                                                                        *
+     * @throws: The first exception thrown by `body`, once every task has finished.         *
+     ****************************************************************************************/
+    template<typename Body>
+    void parallel_for_static(size_t begin, size_t end, size_t grain, Body&& body);
+
+    /****************************************************************************************
+     * grain_size                                                                           *
+     * @brief Picks the task size for a loop over `num_items` trucks.                       *
+     *                                                                                      *
+     * @param num_items: The number of indices in the loop.                                 *
+     * @return: size_t - The number of indices per task.                                    *
+     ****************************************************************************************/
+    size_t grain_size(size_t num_items) const;
+
+    /****************************************************************************************
+     * size                                                                                 *
+     * @brief Retrieves the number of worker threads.                                       *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: size_t - The number of workers.                                             *
+     ****************************************************************************************/
+    size_t size() const;
+
+    /****************************************************************************************
+     * get_metrics                                                                          *
+     * @brief Retrieves the counters of every worker.                                       *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: std::vector<WorkerMetrics> - One entry per worker.                          *
+     ****************************************************************************************/
+    std::vector<WorkerMetrics> get_metrics() const;
+
+    /****************************************************************************************
+     * reset_metrics                                                                        *
+     * @brief Sets the counters of every worker back to zero.                               *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void reset_metrics();
+
+    /****************************************************************************************
+     * current_worker                                                                       *
+     * @brief Retrieves the index of the calling thread in this pool.                       *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: size_t - The index of the calling worker, or `size()` for other threads.    *
+     ****************************************************************************************/
+    size_t current_worker() const;
+
+private:
+    /* A piece of a loop, type erased without allocating                                    */
+    struct Task {
+        void (*run)(void* context, size_t first, size_t last);
+        void* context;
+        size_t first;
+        size_t last;
+    };
+
+    /* Shared by the tasks of one loop, which point at it on the caller's stack             */
+    template<typename Body>
+    struct Loop {
+        Body& body;
+        std::atomic<size_t> remaining;
+        std::atomic<bool> failed;
+        std::exception_ptr error;
+
+        static void run(void* context, size_t first, size_t last);
+    };
+
+    /* Deques, thread and counters of one worker, on their own cache lines. `pinned` holds  *
+     * the tasks only this worker may run. `idle_since` is the steady clock time in         *
+     * nanoseconds at which the current idle period started, or 0 while the worker is       *
+     * running tasks                                                                        */
+    struct alignas(CACHE_LINE_SIZE) Worker {
+        std::mutex lock;
+        std::deque<Task> tasks;
+        std::deque<Task> pinned;
+        std::atomic<size_t> num_pinned{0};
+        std::thread thread;
+        std::atomic<size_t> tasks_run{0};
+        std::atomic<size_t> steals{0};
+        std::atomic<size_t> failed_steals{0};
+        std::atomic<uint64_t> idle_ns{0};
+        std::atomic<int64_t> idle_since{0};
+        std::atomic<int> node{0};
+    };
+
+    /****************************************************************************************
+     * submit                                                                               *
+     * @brief Queues a task on the calling worker's deque, or on the given worker's deque   *
+     *        when called from another thread, and wakes a sleeping worker.                 *
+     *                                                                                      *
+     * @param task: The task to queue.                                                      *
+     * @param target: The worker to queue the task on when called from another thread.      *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void submit(const Task& task, size_t target);
+
+    /****************************************************************************************
+     * submit_pinned                                                                        *
+     * @brief Queues a task that only the given worker may run, and wakes it.               *
+     *                                                                                      *
+     * @param task: The task to queue.                                                      *
+     * @param target: The worker that has to run the task.                                  *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void submit_pinned(const Task& task, size_t target);
+
+    /****************************************************************************************
+     * wait_for                                                                             *
+     * @brief Runs tasks on the calling thread until every task of a loop has finished.     *
+     *                                                                                      *
+     * @param loop: The loop to wait for.                                                   *
+     * @return: None                                                                        *
+     * @throws: The first exception thrown by the loop's body.                              *
+     ****************************************************************************************/
+    template<typename Body>
+    void wait_for(Loop<Body>& loop);
+
+    /****************************************************************************************
+     * try_run                                                                              *
+     * @brief Runs one task, taken from the own deques if possible and stolen otherwise.    *
+     *                                                                                      *
+     * @param self: The index of the calling worker, or `size()` for other threads.         *
+     * @return: bool - False if there was no task to run.                                   *
+     ****************************************************************************************/
+    bool try_run(size_t self);
+
+    /****************************************************************************************
+     * worker_loop                                                                          *
+     * @brief Runs tasks on a worker thread until the pool is destroyed.                    *
+     *                                                                                      *
+     * @param self: The index of the worker.                                                *
+     * @param pin: Whether to pin the worker to the CPU of the same index.                  *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void worker_loop(size_t self, bool pin);
+
+    /* Pool and index of the worker running on the calling thread, if any                   */
+    static thread_local const ThreadPool* worker_owner;
+    static thread_local size_t worker_idx;
+
+    /* Workers, each owning a deque                                                         */
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    /* Tasks queued but not started yet that any worker may run, used to decide whether a   *
+     * worker can sleep                                                                     */
+    std::atomic<size_t> queued;
+
+    /* Sleeping workers wait here for new tasks or for the pool to stop                     */
+    std::mutex sleep_lock;
+    std::condition_variable wake;
+    bool stopping;
+};
+
+/********************************************************************************************
+ * Thread Pool Functions                                                                    *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * log_pool_metrics                                                                         *
+ * @brief Outputs the counters of every worker of a pool to the console.                    *
+ *                                                                                          *
+ * @param pool: The pool to report on.                                                      *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+void log_pool_metrics(const ThreadPool& pool);
+
+/********************************************************************************************
+ * Template Definitions                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * ThreadPool::Loop::run                                                                    *
+ * @brief Runs the body of a loop over one task's bounds, unless another task has already   *
+ *        failed, and counts the task as done.                                              *
+ *                                                                                          *
+ * @param context: The `Loop` the task belongs to.                                          *
+ * @param first: The first index of the task.                                               *
+ * @param last: One past the last index of the task.                                        *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename Body>
+void ThreadPool::Loop<Body>::run(void* context, size_t first, size_t last) {
+
+    Loop& loop = *static_cast<Loop*>(context);
+
+    try {
+        if(!loop.failed.load(std::memory_order_relaxed)) {
+            loop.body(first, last);
+        }
+    }
+    catch(...) {
+        if(!loop.failed.exchange(true)) {
+            loop.error = std::current_exception();
+        }
+    }
+    loop.remaining.fetch_sub(1, std::memory_order_release);
+}
+
+/********************************************************************************************
+ * ThreadPool::wait_for                                                                     *
+ * @brief Runs tasks on the calling thread until every task of a loop has finished.         *
+ *                                                                                          *
+ * The loop state lives on the caller's stack, so the caller must not return before the     *
+ * last task is done. It helps out in the meantime, with any task it is allowed to run.     *
+ *                                                                                          *
+ * @param loop: The loop to wait for.                                                       *
+ * @return: None                                                                            *
+ * @throws: The first exception thrown by the loop's body.                                  *
+ ********************************************************************************************/
+template<typename Body>
+void ThreadPool::wait_for(Loop<Body>& loop) {
+
+    size_t self = this->current_worker();
+
+    while(loop.remaining.load(std::memory_order_acquire) > 0) {
+        if(!this->try_run(self)) {
+            std::this_thread::yield();
+        }
+    }
+
+    if(loop.error) {
+        std::rethrow_exception(loop.error);
+    }
+}
+
+/********************************************************************************************
+ * ThreadPool::parallel_for                                                                 *
+ * @brief Runs `body(first, last)` over [begin, end) in tasks of `grain` indices and waits  *
+ *        for all of them.                                                                  *
+ *                                                                                          *
+ * The tasks point at a loop state on the caller's stack, which stays alive since the       *
+ * caller does not return until every task has finished. While it waits, the caller runs    *
+ * tasks itself, its own or any other queued ones.                                          *
+ *                                                                                          *
+ * @param begin: The first index of the range.                                              *
+ * @param end: One past the last index of the range.                                        *
+ * @param grain: The number of indices per task, see `grain_size`.                          *
+ * @param body: Called with the bounds of each task, from any thread of the pool.           *
+ * @return: None                                                                            *
+ * @throws: The first exception thrown by `body`, once every task has finished.             *
+ ********************************************************************************************/
+template<typename Body>
+void ThreadPool::parallel_for(size_t begin, size_t end, size_t grain, Body&& body) {
+
+    if(begin >= end) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+
+    Loop<Body> loop{body, (end - begin + grain - 1) / grain, false, nullptr};
+
+    /* Queue every task but the first, which the caller runs straight away. Tasks from       *
+     * outside the pool are dealt out to the workers in order, so the same loop lands on     *
+     * the same workers every time and they keep finding its data in their caches           */
+    size_t target = 0;
+
+    for(size_t first = begin + grain; first < end; first += grain) {
+        this->submit(Task{Loop<Body>::run, &loop, first, std::min(first + grain, end)},
+                     target++ % this->size());
+    }
+    Loop<Body>::run(&loop, begin, std::min(begin + grain, end));
+
+    /* Help out until the other tasks are done                                              */
+    this->wait_for(loop);
+}
+
+/********************************************************************************************
+ * ThreadPool::parallel_for_static                                                          *
+ * @brief Runs `body(first, last)` over [begin, end) in tasks of `grain` indices, task i    *
+ *        always on worker i % size(), and waits for all of them.                           *
+ *                                                                                          *
+ * Unlike `parallel_for`, nothing is left to chance: the caller runs none of the tasks      *
+ * unless it is the worker they map to, and pinned tasks are never stolen. Two loops over   *
+ * the same range with the same grain therefore run every index on the same worker, which   *
+ * is what lets `FirstTouchResource` place the trucks on the node of the worker that will   *
+ * advance them. The price is that a worker that falls behind holds up the whole loop.      *
+ *                                                                                          *
+ * @param begin: The first index of the range.                                              *
+ * @param end: One past the last index of the range.                                        *
+ * @param grain: The number of indices per task, see `grain_size`.                          *
+ * @param body: Called with the bounds of each task, from the worker the task maps to.      *
+ * @return: None                                                                            *
+ * @throws: The first exception thrown by `body`, once every task has finished.             *
+ ********************************************************************************************/
+template<typename Body>
+void ThreadPool::parallel_for_static(size_t begin, size_t end, size_t grain, Body&& body) {
+
+    if(begin >= end) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+
+    Loop<Body> loop{body, (end - begin + grain - 1) / grain, false, nullptr};
+    size_t task = 0;
+
+    for(size_t first = begin; first < end; first += grain) {
+        this->submit_pinned(Task{Loop<Body>::run, &loop, first, std::min(first + grain, end)},
+                            task++ % this->size());
+    }
+
+    /* Wait for the workers, running the tasks mapped to the caller if it is one of them    */
+    this->wait_for(loop);
+}
+
+#endif // THREAD_POOL_HPP
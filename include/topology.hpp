@@ -0,0 +1,470 @@
+/********************************************************************************************
+ * File: topology.hpp                                                                       *
+ *                                                                                          *
+ * Description:                                                                             *
+ *  Contains the site topology of the Helium-3 Mining Simulator. Instead of a single mine   *
+ *  with every station the same distance away, the fleet is spread over several mine sites  *
+ *  and each pair of site and station has its own travel time. Trucks pick their station    *
+ *  when they leave the mines, weighing the travel time against the queue they expect to    *
+ *  find there.                                                                             *
+ *                                                                                          *
+ * Changes:                                                                                 *
+ *  10/16/2026 - Created                                                                    *
+ *                                                                                          *
+ ********************************************************************************************/
+#ifndef TOPOLOGY_HPP
+#define TOPOLOGY_HPP
+
+/********************************************************************************************
+ * Includes                                                                                 *
+ ********************************************************************************************/
+#include <istream>
+#include <optional>
+#include <vector>
+
+#ifndef MAIN_HPP
+#include "../include/main.hpp"
+#endif
+
+/********************************************************************************************
+ * Defines/Macros                                                                           *
+ ********************************************************************************************/
+#define NO_ROUTE                0xFFFFu /*Travel time of a station a site cannot reach      */
+#define DENSE_TRAVEL_ENTRIES    1048576u /*Largest matrix that is always stored dense       */
+
+/********************************************************************************************
+ * Enumerations/Classes                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * TravelRoute                                                                              *
+ * @brief Travel time between one mine site and one station, in either direction.           *
+ ********************************************************************************************/
+struct TravelRoute {
+    uint16_t mine;
+    uint16_t station;
+    uint16_t time;
+};
+
+/********************************************************************************************
+ * TravelTimes                                                                              *
+ * @brief Matrix of the travel times between M mine sites and S stations.                   *
+ *                                                                                          *
+ * Small matrices, and large ones where most sites reach most stations, are stored dense    *
+ * and row major, one 16 bit time per pair with NO_ROUTE where there is no road. Large      *
+ * sparse ones are stored as compressed sparse rows: each site's reachable stations and     *
+ * their times are kept in two separate arrays sorted by station. Either way the routes of  *
+ * one site are contiguous in memory, so the leaves of a site's station picking tree are    *
+ * laid out by scanning a single row front to back.                                         *
+ ********************************************************************************************/
+class TravelTimes {
+public:
+    /****************************************************************************************
+     * TravelTimes Constructor                                                              *
+     * @brief Builds the matrix from a list of routes, picking the dense or sparse layout.  *
+     *                                                                                      *
+     * @param num_mines: The number of mine sites.                                          *
+     * @param num_stations: The number of stations.                                         *
+     * @param routes: The travel time of every pair with a road between them.               *
+     * @return: None                                                                        *
+     * @throws: std::invalid_argument if a route is out of range, listed twice or takes 0   *
+     *          or NO_ROUTE ticks, or if a site cannot reach any station.                   *
+     ****************************************************************************************/
+    TravelTimes(uint16_t num_mines, uint16_t num_stations,
+                const std::vector<TravelRoute>& routes);
+
+    /****************************************************************************************
+     * get                                                                                  *
+     * @brief Retrieves the travel time between a mine site and a station.                  *
+     *                                                                                      *
+     * @param mine: The index of the mine site.                                             *
+     * @param station: The index of the station.                                            *
+     * @return: uint16_t - The travel time in ticks, NO_ROUTE if there is no road.          *
+     ****************************************************************************************/
+    uint16_t get(uint16_t mine, size_t station) const;
+
+    /****************************************************************************************
+     * for_each_route                                                                       *
+     * @brief Calls `visit(station, time)` for every station a mine site can reach, in      *
+     *        station order.                                                                *
+     *                                                                                      *
+     * @param mine: The index of the mine site.                                             *
+     * @param visit: Called with the index of each reachable station and its travel time.   *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename Visit>
+    void for_each_route(uint16_t mine, Visit&& visit) const;
+
+    /****************************************************************************************
+     * get_num_mines                                                                        *
+     * @brief Retrieves the number of mine sites.                                           *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: uint16_t - The number of mine sites.                                        *
+     ****************************************************************************************/
+    uint16_t get_num_mines() const;
+
+    /****************************************************************************************
+     * get_num_stations                                                                     *
+     * @brief Retrieves the number of stations.                                             *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: uint16_t - The number of stations.                                          *
+     ****************************************************************************************/
+    uint16_t get_num_stations() const;
+
+    /****************************************************************************************
+     * is_dense                                                                             *
+     * @brief Retrieves the layout picked for the matrix.                                   *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: bool - True if stored dense, false if stored as compressed sparse rows.     *
+     ****************************************************************************************/
+    bool is_dense() const;
+
+private:
+    /* Number of mine sites and stations                                                    */
+    uint16_t num_mines;
+    uint16_t num_stations;
+
+    /* Layout of the matrix                                                                 */
+    bool dense;
+
+    /* Dense layout, M rows of S times                                                      */
+    std::vector<uint16_t> times;
+
+    /* Sparse layout, the routes of site m are [row_offsets[m], row_offsets[m + 1]) of the   *
+     * station and time arrays, the times are kept in `times`                               */
+    std::vector<uint32_t> row_offsets;
+    std::vector<uint16_t> columns;
+};
+
+/********************************************************************************************
+ * TopologySimulation                                                                       *
+ * @brief Runs a fleet spread over several mine sites, with its own travel time between     *
+ *        every site and station.                                                           *
+ *                                                                                          *
+ * Trucks are dealt out to the sites in order and always return to their own. When a        *
+ * truck has finished mining it picks the station it will be unloaded at soonest, using     *
+ * `choose_station`, and travels there. Once unloaded it travels back to its site and       *
+ * draws a new mining time, like in a single site simulation.                               *
+ *                                                                                          *
+ * Each site keeps an ExpectedWaitTree over the stations it can reach, so picking a station *
+ * is O(log S). A station's queue or inbound trucks change when a truck departs for it or   *
+ * arrives at it, which updates its leaf in the tree of every site that reaches it.         *
+ *                                                                                          *
+ * The simulation keeps its own travel times, pass an rvalue to move a large matrix in      *
+ * rather than copy it.                                                                     *
+ ********************************************************************************************/
+class TopologySimulation {
+public:
+    /****************************************************************************************
+     * TopologySimulation Constructor                                                       *
+     * @brief Initializes a simulation of the given fleet over the sites and stations of    *
+     *        a travel time matrix.                                                         *
+     *                                                                                      *
+     * @param num_trucks: The number of trucks to be simulated.                             *
+     * @param travel_times: The travel times between the sites and the stations, moved into *
+     *                      the simulation.                                                 *
+     * @param debug: Optional parameter that enables debug mode if set to true.             *
+     * @param mining_time: Optional distribution of mining times, defaults to the uniform   *
+     *                     distribution between the site's mining time bounds.              *
+     * @param seed: Optional seed of the simulation's random number generator.              *
+     * @param memory: Optional resource the trucks and stations are stored in.              *
+     * @param site: Optional site the simulation runs at, defaults to the standard site.    *
+     *              Its travel time is replaced by the travel time matrix.                  *
+     * @return: None                                                                        *
+     * @throws: std::invalid_argument if the site is invalid.                               *
+     ****************************************************************************************/
+    TopologySimulation(uint16_t num_trucks,
+                       TravelTimes travel_times,
+                       bool debug = false,
+                       std::optional<MiningTimeDistribution> mining_time = std::nullopt,
+                       uint32_t seed = std::random_device{}(),
+                       std::pmr::memory_resource* memory = std::pmr::get_default_resource(),
+                       const SiteConfig& site = STANDARD_SITE);
+
+    /****************************************************************************************
+     * simulate                                                                             *
+     * @brief Runs the tick loop for `total_time` ticks.                                    *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void simulate();
+
+    /****************************************************************************************
+     * simulate                                                                             *
+     * @brief Runs the tick loop until the observer stops it.                               *
+     *                                                                                      *
+     * @param observer: The tick loop observer, see `Simulation::simulate`.                 *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename Observer>
+    void simulate(Observer& observer);
+
+    /****************************************************************************************
+     * choose_station                                                                       *
+     * @brief Picks the station a truck leaving a mine site would be unloaded at soonest.   *
+     *                                                                                      *
+     * @param mine: The index of the mine site the truck leaves from.                       *
+     * @return: size_t - The index of the station.                                          *
+     ****************************************************************************************/
+    size_t choose_station(uint16_t mine);
+
+    /****************************************************************************************
+     * scan_station                                                                         *
+     * @brief Picks the same station as `choose_station` by scanning every route of the     *
+     *        site, used to check the trees in debug mode.                                  *
+     *                                                                                      *
+     * @param mine: The index of the mine site the truck leaves from.                       *
+     * @return: size_t - The index of the station.                                          *
+     ****************************************************************************************/
+    size_t scan_station(uint16_t mine);
+
+    /****************************************************************************************
+     * logging                                                                              *
+     * @brief Outputs the statistics of every truck and station to the console.             *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void logging();
+
+    /****************************************************************************************
+     * get_state_fractions                                                                  *
+     * @brief Computes the fraction of time the fleet spent in each category.               *
+     *                                                                                      *
+     * @param: None                                                                         *
+     * @return: StateFractions - The fleet-wide fraction of time spent in each category.    *
+     ****************************************************************************************/
+    StateFractions get_state_fractions();
+
+    /* Store the total execution time of the simulation                                     */
+    uint16_t total_time;
+
+    /* Flag to determine whether to run additional consistency checks during the simulation */
+    bool debug;
+
+    /* Travel times between the sites and the stations                                      */
+    TravelTimes travel_times;
+
+    /* list of stations                                                                     */
+    std::pmr::vector<Station> stations;
+
+    /* Trucks travelling to each station, which will join its queue on arrival              */
+    std::pmr::vector<uint16_t> inbound;
+
+    /* list of trucks                                                                       */
+    std::pmr::vector<Truck> trucks;
+
+    /* Distribution the trucks draw their mining times from                                 */
+    MiningTimeDistribution mining_time;
+
+    /* Mersenne Twister pseudorandom number generator used for every draw                   */
+    std::mt19937 gen;
+
+    /* Site the simulation runs at, and the routed truck state machine built from it        */
+    SiteConfig site;
+    TruckTransitionTable transitions;
+
+    /* Number of ticks run since the simulation was set up, see `Station`                   */
+    uint32_t tick;
+
+private:
+    /****************************************************************************************
+     * update_station                                                                       *
+     * @brief Records the queue and inbound trucks of a station in the tree of every site   *
+     *        that reaches it.                                                              *
+     *                                                                                      *
+     * @param station: The index of the station.                                            *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    void update_station(size_t station);
+
+    /* Station picking tree of each site, with one leaf per station the site reaches        */
+    std::pmr::vector<ExpectedWaitTree> trees;
+
+    /* Station of each leaf, site m has the leaves [leaf_offsets[m], leaf_offsets[m + 1])   */
+    std::pmr::vector<uint32_t> leaf_offsets;
+    std::pmr::vector<uint16_t> leaf_stations;
+
+    /* Leaves of each station across the sites, station s has the global leaf indices       *
+     * [station_offsets[s], station_offsets[s + 1]) of `station_leaves`, with their sites   */
+    std::pmr::vector<uint32_t> station_offsets;
+    std::pmr::vector<uint32_t> station_leaves;
+    std::pmr::vector<uint16_t> station_mines;
+
+    /****************************************************************************************
+     * run_engine                                                                           *
+     * @brief Runs the tick loop with the mining time distribution, the observer and the    *
+     *        consistency checks fixed at compile time.                                     *
+     *                                                                                      *
+     * @param mining_time: The active mining time distribution policy.                      *
+     * @param observer: The tick loop observer.                                             *
+     * @param checks: The consistency check policy, see `select_checks`.                    *
+     * @return: None                                                                        *
+     ****************************************************************************************/
+    template<typename MiningTime, typename Observer, typename Checks>
+    void run_engine(MiningTime& mining_time, Observer& observer, Checks checks);
+};
+
+/********************************************************************************************
+ * Topology Functions                                                                       *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * make_routed_transitions                                                                  *
+ * @brief Builds the truck state machine of a simulation with several sites.                *
+ *                                                                                          *
+ * Unlike a single site, a truck's travel times depend on the station it uses, so trucks    *
+ * that finish mining raise `Depart` to have a station picked, and the return trip is       *
+ * timed when `Unload` is resolved.                                                         *
+ *                                                                                          *
+ * @param site: The site the trucks work at.                                                *
+ * @return: TruckTransitionTable - The transition of each state.                            *
+ ********************************************************************************************/
+constexpr TruckTransitionTable make_routed_transitions(const SiteConfig& site) {
+
+    TruckTransitionTable table = make_truck_transitions(site);
+
+    table[static_cast<size_t>(TruckState::Mining)] =
+        {MINING_INC, 1, 0, TruckState::Mining, TruckEvent::Depart};
+
+    table[static_cast<size_t>(TruckState::Unloading)].reload = 0;
+
+    return table;
+}
+
+/********************************************************************************************
+ * read_travel_times                                                                        *
+ * @brief Reads a travel time matrix from a stream of routes.                               *
+ *                                                                                          *
+ * Every line holds one route as `mine station time`, with zero based indices and the       *
+ * time in ticks. Empty lines and lines starting with '#' are skipped.                      *
+ *                                                                                          *
+ * @param input: The stream to read from.                                                   *
+ * @param num_mines: The number of mine sites.                                              *
+ * @param num_stations: The number of stations.                                             *
+ * @return: TravelTimes - The matrix of the routes read.                                    *
+ * @throws: std::runtime_error if a line is not a route.                                    *
+ * @throws: std::invalid_argument if the routes do not form a valid matrix.                 *
+ ********************************************************************************************/
+TravelTimes read_travel_times(std::istream& input, uint16_t num_mines, uint16_t num_stations);
+
+/********************************************************************************************
+ * Template Definitions                                                                     *
+ ********************************************************************************************/
+
+/********************************************************************************************
+ * TravelTimes::for_each_route                                                              *
+ * @brief Calls `visit(station, time)` for every station a mine site can reach, in station  *
+ *        order.                                                                            *
+ *                                                                                          *
+ * @param mine: The index of the mine site.                                                 *
+ * @param visit: Called with the index of each reachable station and its travel time.       *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename Visit>
+void TravelTimes::for_each_route(uint16_t mine, Visit&& visit) const {
+
+    if(this->dense) {
+
+        const uint16_t* row = this->times.data() + static_cast<size_t>(mine) * num_stations;
+
+        for(size_t station = 0; station < this->num_stations; station++) {
+            if(row[station] != NO_ROUTE) {
+                visit(station, row[station]);
+            }
+        }
+    }
+    else {
+        for(uint32_t i = this->row_offsets[mine]; i < this->row_offsets[mine + 1]; i++) {
+            visit(static_cast<size_t>(this->columns[i]), this->times[i]);
+        }
+    }
+}
+
+/********************************************************************************************
+ * TopologySimulation::simulate                                                             *
+ * @brief Runs the tick loop until the observer stops it.                                   *
+ *                                                                                          *
+ * @param observer: The tick loop observer, see `Simulation::simulate`.                     *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename Observer>
+void TopologySimulation::simulate(Observer& observer) {
+
+    /* Select the mining time distribution and the checks once, outside of the tick loop    */
+    std::visit([this, &observer](auto& dist) {
+        select_checks(this->debug, [&](auto checks) {
+            this->run_engine(dist, observer, checks);
+        });
+    }, this->mining_time);
+}
+
+/********************************************************************************************
+ * TopologySimulation::run_engine                                                           *
+ * @brief Runs the tick loop with the mining time distribution, the observer and the        *
+ *        consistency checks fixed at compile time.                                         *
+ *                                                                                          *
+ * Each truck runs its own part of the tick through the routed state machine, then the      *
+ * event it raised is applied to the stations here.                                         *
+ *                                                                                          *
+ * @param mining_time: The active mining time distribution policy.                          *
+ * @param observer: The tick loop observer.                                                 *
+ * @param checks: The consistency check policy, see `select_checks`.                        *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+template<typename MiningTime, typename Observer, typename Checks>
+void TopologySimulation::run_engine(MiningTime& mining_time, Observer& observer,
+                                    Checks checks) {
+
+    /* Each iteration is one tick, the observer decides when the simulation ends            */
+    while(observer.next_tick()) {
+
+        for(auto& truck : this->trucks) {
+
+            observer.observe(truck);
+
+            TruckEvent event = truck.run_local(this->transitions);
+
+            if(TruckEvent::Depart == event) {
+
+                /* Pick the station now, the travel time depends on it                      */
+                size_t station = this->choose_station(truck.get_mine_idx());
+
+                checks.check_station(station, [&]() {
+                    return this->scan_station(truck.get_mine_idx());
+                });
+
+                this->inbound[station]++;
+                this->update_station(station);
+                truck.depart(station, this->travel_times.get(truck.get_mine_idx(), station));
+            }
+            else if(TruckEvent::Arrive == event) {
+
+                size_t station = truck.get_station_idx();
+
+                this->inbound[station]--;
+                truck.join_queue(this->stations[station], this->tick);
+                this->update_station(station);
+            }
+            else if(TruckEvent::Unload == event) {
+
+                size_t station = truck.get_station_idx();
+
+                this->stations[station].increment_trucks_unloaded();
+                truck.head_home(this->travel_times.get(truck.get_mine_idx(), station));
+            }
+            else if(TruckEvent::Draw == event) {
+                truck.start_mining(mining_time(this->gen));
+            }
+        }
+
+        /* Every station unloaded a truck, which moves all the queues on at once            */
+        this->tick++;
+    }
+}
+
+#endif // TOPOLOGY_HPP
@@ -0,0 +1,129 @@
+#ifndef ANALYTIC_HPP
+#include "../include/analytic.hpp"
+#endif
+
+/****************************************************************************************
+ * estimate_state_fractions                                                             *
+ * @brief Predicts the fraction of time the fleet spends in each category without       *
+ *        running the simulation.                                                       *
+ *                                                                                      *
+ * See the header for the queueing model. The recursion over the population n is:       *
+ *   wait(n)  = queue(n - 1) - util(n - 1) / 2   arrival theorem, deterministic service *
+ *   cycle(n) = think + wait(n) + 1              think = mining + both travel legs      *
+ *   util(n)  = n / cycle(n) / S                 arrivals per tick at one station       *
+ *   queue(n) = util(n) * (wait(n) + 1)          Little's law at one station            *
+ *                                                                                      *
+ * @param num_trucks: The number of trucks in the fleet.                                *
+ * @param num_stations: The number of unloading stations.                               *
+ * @param mean_mining_time: The expected mining time in ticks.                          *
+ * @param site: The site the fleet works at, its travel time gives both travel legs.    *
+ * @return: StateFractions - The predicted fraction of time spent in each category.     *
+ ****************************************************************************************/
+StateFractions estimate_state_fractions(uint32_t num_trucks,
+                                        uint32_t num_stations,
+                                        double mean_mining_time,
+                                        const SiteConfig& site) {
+
+    double think = mean_mining_time + 2.0 * site.travel_time;
+    double queue = 0.0;
+    double util = 0.0;
+    double wait = 0.0;
+    double cycle = think + 1.0;
+
+    for(uint32_t n = 1; n <= num_trucks; n++) {
+
+        wait = std::max(queue - util / 2.0, 0.0);
+        cycle = think + wait + 1.0;
+        util = (n / cycle) / num_stations;
+        queue = util * (wait + 1.0);
+    }
+
+    return StateFractions{wait / cycle,
+                          1.0 / cycle,
+                          2.0 * site.travel_time / cycle,
+                          mean_mining_time / cycle};
+}
+
+/****************************************************************************************
+ * compare_estimate_to_simulation                                                       *
+ * @brief Runs both the analytic estimate and a full simulation of one configuration    *
+ *        and reports the approximation error.                                          *
+ *                                                                                      *
+ * @param num_trucks: The number of trucks in the fleet.                                *
+ * @param num_stations: The number of unloading stations.                               *
+ * @param mining_time: The mining time distribution shared by both models.              *
+ * @param seed: The seed of the simulation's random number generator.                   *
+ * @param site: The site both models run at.                                            *
+ * @return: ApproximationError - Both sets of fractions, their largest absolute         *
+ *          difference and the time each model took.                                    *
+ ****************************************************************************************/
+ApproximationError compare_estimate_to_simulation(uint16_t num_trucks,
+                                                  uint16_t num_stations,
+                                                  MiningTimeDistribution mining_time,
+                                                  uint32_t seed,
+                                                  const SiteConfig& site) {
+    ApproximationError error;
+
+    /* Time the analytic estimate                                                       */
+    auto start = std::chrono::steady_clock::now();
+
+    double mean_mining_time = std::visit([](auto& dist) {
+        return dist.mean();
+    }, mining_time);
+
+    error.estimate = estimate_state_fractions(num_trucks, num_stations, mean_mining_time,
+                                              site);
+
+    auto end = std::chrono::steady_clock::now();
+    error.estimate_us = std::chrono::duration<double, std::micro>(end - start).count();
+
+    /* Time the full simulation, including its construction                             */
+    start = std::chrono::steady_clock::now();
+
+    Simulation sim(num_trucks, num_stations, false, std::move(mining_time), seed,
+                   std::pmr::get_default_resource(), site);
+    sim.simulate();
+    error.simulated = sim.get_state_fractions();
+
+    end = std::chrono::steady_clock::now();
+    error.simulation_us = std::chrono::duration<double, std::micro>(end - start).count();
+
+    /* Keep the largest absolute difference across the categories                       */
+    const StateFractions& est = error.estimate;
+    const StateFractions& act = error.simulated;
+
+    error.max_error = std::max({std::abs(est.waiting - act.waiting),
+                                std::abs(est.unloading - act.unloading),
+                                std::abs(est.traveling - act.traveling),
+                                std::abs(est.mining - act.mining)});
+    return error;
+}
+
+/****************************************************************************************
+ * log_approximation_error                                                              *
+ * @brief Outputs the result of `compare_estimate_to_simulation` to the console.        *
+ *                                                                                      *
+ * @param error: The comparison to print.                                               *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void log_approximation_error(const ApproximationError& error) {
+
+    std::cout << "Estimate / Simulation" << std::endl;
+
+    std::cout << "Waiting: " << error.estimate.waiting * 100 << "% / "
+    << error.simulated.waiting * 100 << "%" << std::endl;
+
+    std::cout << "Unloading: " << error.estimate.unloading * 100 << "% / "
+    << error.simulated.unloading * 100 << "%" << std::endl;
+
+    std::cout << "Traveling: " << error.estimate.traveling * 100 << "% / "
+    << error.simulated.traveling * 100 << "%" << std::endl;
+
+    std::cout << "Mining: " << error.estimate.mining * 100 << "% / "
+    << error.simulated.mining * 100 << "%" << std::endl;
+
+    std::cout << "Max error: " << error.max_error * 100 << "%" << std::endl;
+
+    std::cout << "Time: " << error.estimate_us << "us / " << error.simulation_us << "us"
+    << std::endl << std::endl;
+}
@@ -0,0 +1,397 @@
+#ifndef BAYS_HPP
+#include "../include/bays.hpp"
+#endif
+
+/****************************************************************************************
+ * TruckQueue Constructor                                                               *
+ * @brief Initializes an empty queue.                                                   *
+ *                                                                                      *
+ * @param links: The links of every truck, one per truck of the simulation, which has   *
+ *               to outlive the queue.                                                  *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+TruckQueue::TruckQueue(uint16_t* links) : links(links), head(0), tail(0), count(0) {}
+
+/****************************************************************************************
+ * push                                                                                 *
+ * @brief Adds a truck to the back of the queue.                                        *
+ *                                                                                      *
+ * @param truck_idx: The index of the truck, not queued anywhere else.                  *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void TruckQueue::push(uint16_t truck_idx) {
+
+    /* Chain the truck behind the back, or start the queue with it                      */
+    if(this->count) {
+        this->links[this->tail] = truck_idx;
+    }
+    else {
+        this->head = truck_idx;
+    }
+
+    this->tail = truck_idx;
+    this->count++;
+}
+
+/****************************************************************************************
+ * pop                                                                                  *
+ * @brief Removes the truck at the front of the queue.                                  *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: uint16_t - The index of the truck, the queue must not be empty.             *
+ ****************************************************************************************/
+uint16_t TruckQueue::pop() {
+
+    uint16_t truck_idx = this->head;
+
+    this->head = this->links[truck_idx];
+    this->count--;
+
+    return truck_idx;
+}
+
+/****************************************************************************************
+ * size                                                                                 *
+ * @brief Retrieves the number of trucks in the queue.                                  *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: size_t - The number of trucks.                                              *
+ ****************************************************************************************/
+size_t TruckQueue::size() const {
+    return this->count;
+}
+
+/****************************************************************************************
+ * BayStation Constructor                                                               *
+ * @brief Initializes a station with every bay free and nobody waiting.                 *
+ *                                                                                      *
+ * @param config: The bays and the unload times of the station.                         *
+ * @param links: The links the station's queue is chained through, see `TruckQueue`.    *
+ * @return: None                                                                        *
+ * @throws: std::invalid_argument if there are no bays or the unload times are empty    *
+ *          or contain zero.                                                            *
+ ****************************************************************************************/
+BayStation::BayStation(const BayConfig& config, uint16_t* links)
+                       : queue(links),
+                         bays(config.bays),
+                         busy(0),
+                         min_unload(config.min_unload),
+                         max_unload(config.max_unload),
+                         num_trucks_unloaded(0) {
+
+    if(!config.bays) {
+        throw std::invalid_argument("A station needs at least one bay");
+    }
+    if(!config.min_unload || (config.min_unload > config.max_unload)) {
+        throw std::invalid_argument("The unload times of a station must be a non-empty "
+                                    "range of at least one tick");
+    }
+}
+
+/****************************************************************************************
+ * arrive                                                                               *
+ * @brief Takes a free bay for an arriving truck, or queues it if there is none.        *
+ *                                                                                      *
+ * @param truck_idx: The index of the truck.                                            *
+ * @return: bool - Whether the truck got a bay.                                         *
+ ****************************************************************************************/
+bool BayStation::arrive(uint16_t truck_idx) {
+
+    if(this->busy < this->bays) {
+        this->busy++;
+        return true;
+    }
+
+    this->queue.push(truck_idx);
+
+    return false;
+}
+
+/****************************************************************************************
+ * release                                                                              *
+ * @brief Frees the bay of a truck that has finished unloading, and hands it straight   *
+ *        to the truck at the front of the queue, if any.                               *
+ *                                                                                      *
+ * @param next: Receives the truck that got the bay.                                    *
+ * @return: bool - Whether a waiting truck got the bay.                                 *
+ ****************************************************************************************/
+bool BayStation::release(uint16_t& next) {
+
+    /* The bay stays busy when it goes straight to the next truck                       */
+    if(this->queue.size()) {
+        next = this->queue.pop();
+        return true;
+    }
+
+    this->busy--;
+
+    return false;
+}
+
+/****************************************************************************************
+ * hold                                                                                 *
+ * @brief Queues an arriving truck without giving it a bay, even if one is free.        *
+ *                                                                                      *
+ * @param truck_idx: The index of the truck.                                            *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void BayStation::hold(uint16_t truck_idx) {
+    this->queue.push(truck_idx);
+}
+
+/****************************************************************************************
+ * free_bay                                                                             *
+ * @brief Frees the bay of a truck that has finished unloading, leaving the queue as it *
+ *        is.                                                                           *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void BayStation::free_bay() {
+    this->busy--;
+}
+
+/****************************************************************************************
+ * admit                                                                                *
+ * @brief Gives a free bay to the truck at the front of the queue.                      *
+ *                                                                                      *
+ * @param next: Receives the truck that got the bay.                                    *
+ * @return: bool - Whether there was both a free bay and a truck waiting for it.        *
+ ****************************************************************************************/
+bool BayStation::admit(uint16_t& next) {
+
+    if((this->busy == this->bays) || !this->queue.size()) {
+        return false;
+    }
+
+    this->busy++;
+    next = this->queue.pop();
+
+    return true;
+}
+
+/****************************************************************************************
+ * evict                                                                                *
+ * @brief Removes the truck at the front of the queue without giving it a bay.          *
+ *                                                                                      *
+ * @param truck_idx: Receives the truck removed.                                        *
+ * @return: bool - Whether there was a truck waiting.                                   *
+ ****************************************************************************************/
+bool BayStation::evict(uint16_t& truck_idx) {
+
+    if(!this->queue.size()) {
+        return false;
+    }
+
+    truck_idx = this->queue.pop();
+
+    return true;
+}
+
+/****************************************************************************************
+ * draw_unload_time                                                                     *
+ * @brief Draws the ticks a truck takes to unload at the station.                       *
+ *                                                                                      *
+ * A station with a single unload time draws nothing from the generator, so stations    *
+ * with fixed unload times leave the mining times the same as they would be without.    *
+ *                                                                                      *
+ * @param gen: The random number generator owned by the simulation.                     *
+ * @return: uint16_t - The unload time, between the station's shortest and longest.     *
+ ****************************************************************************************/
+uint16_t BayStation::draw_unload_time(std::mt19937& gen) {
+
+    if(this->min_unload == this->max_unload) {
+        return this->min_unload;
+    }
+
+    std::uniform_int_distribution<uint16_t> dist(this->min_unload, this->max_unload);
+
+    return dist(gen);
+}
+
+/****************************************************************************************
+ * get_queue                                                                            *
+ * @brief Retrieves the number of trucks waiting for a bay.                             *
+ *                                                                                      *
+ * @param tick: The number of ticks the simulation has run, unused.                     *
+ * @return: uint16_t - The number of trucks waiting.                                    *
+ ****************************************************************************************/
+uint16_t BayStation::get_queue(uint32_t) {
+    return static_cast<uint16_t>(this->queue.size());
+}
+
+/****************************************************************************************
+ * get_busy_bays                                                                        *
+ * @brief Retrieves the number of bays unloading a truck.                               *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: uint16_t - The number of busy bays.                                         *
+ ****************************************************************************************/
+uint16_t BayStation::get_busy_bays() {
+    return this->busy;
+}
+
+/****************************************************************************************
+ * increment_trucks_unloaded                                                            *
+ * @brief Counts another truck unloaded at the station.                                 *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void BayStation::increment_trucks_unloaded() {
+    this->num_trucks_unloaded++;
+}
+
+/****************************************************************************************
+ * get_trucks_unloaded                                                                  *
+ * @brief Retrieves the count of trucks that have been unloaded at the station.         *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: uint16_t - The number of trucks unloaded.                                   *
+ ****************************************************************************************/
+uint16_t BayStation::get_trucks_unloaded() {
+    return this->num_trucks_unloaded;
+}
+
+/****************************************************************************************
+ * logging                                                                              *
+ * @brief Outputs the number of trucks unloaded at the station to the console.          *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void BayStation::logging() {
+
+    std::cout << "Number of bays: " << this->bays << std::endl;
+    std::cout << "Number of trucks unloaded: " << this->num_trucks_unloaded << std::endl
+    << std::endl;
+}
+
+/****************************************************************************************
+ * BaySimulation Constructor                                                            *
+ * @brief Initializes a simulation of the given fleet and stations, with every truck    *
+ *        mining.                                                                       *
+ *                                                                                      *
+ * The selector is reset and the first mining times are drawn in the same order as      *
+ * `Simulation::reset`, so a run with a single bay and a one tick unload at every       *
+ * station matches `Simulation` with the same seed.                                     *
+ *                                                                                      *
+ * @param num_trucks: The number of trucks to be simulated.                             *
+ * @param configs: The bays and unload times of every station.                          *
+ * @param debug: Optional parameter that enables debug mode if set to true.             *
+ * @param mining_time: Optional distribution of mining times, defaults to the uniform   *
+ *                     distribution between the site's mining time bounds.              *
+ * @param seed: Optional seed of the simulation's random number generator.              *
+ * @param memory: Optional resource the trucks, stations and queues are stored in.      *
+ * @param site: Optional site the simulation runs at, defaults to the standard site.    *
+ * @param selection: Optional station selection policy, defaults to round robin.        *
+ * @return: None                                                                        *
+ * @throws: std::invalid_argument if there are no stations, a station or the site is    *
+ *          invalid or the selection policy mirrors the queues.                         *
+ ****************************************************************************************/
+BaySimulation::BaySimulation(uint16_t num_trucks,
+                             const std::vector<BayConfig>& configs,
+                             bool debug,
+                             std::optional<MiningTimeDistribution> mining_time,
+                             uint32_t seed,
+                             std::pmr::memory_resource* memory,
+                             const SiteConfig& site,
+                             SelectionPolicy selection)
+                             : total_time(site.max_time),
+                               debug(debug),
+                               stations(memory),
+                               trucks(memory),
+                               selector(make_selector(selection, memory,
+                                                      site.travel_time)),
+                               mining_time(mining_time ? std::move(*mining_time)
+                                                       : site_mining_time(site)),
+                               gen(seed),
+                               site(site),
+                               transitions(make_bay_transitions(site)),
+                               tick(0),
+                               released(memory),
+                               links(num_trucks, 0, memory) {
+
+    validate_site(site);
+
+    if(configs.empty() || (configs.size() > UINT16_MAX)) {
+        throw std::invalid_argument("A bay simulation needs between 1 and 65535 "
+                                    "stations");
+    }
+    if((SelectionPolicy::ShortestQueue == selection) ||
+       (SelectionPolicy::ShortestWait == selection)) {
+        throw std::invalid_argument("The shortest queue and wait policies do not support "
+                                    "stations with several bays");
+    }
+
+    uint16_t num_stations = static_cast<uint16_t>(configs.size());
+
+    this->stations.reserve(num_stations);
+
+    for(const BayConfig& config : configs) {
+        this->stations.emplace_back(config, this->links.data());
+    }
+
+    /* Every truck frees at most one bay a tick                                         */
+    this->released.reserve(num_trucks);
+
+    std::visit([seed, num_stations](auto& selector) {
+        selector.reset(num_stations, seed);
+    }, this->selector);
+
+    this->trucks.reserve(num_trucks);
+
+    /* Every truck starts out mining, draw its first mining time from the distribution  */
+    std::visit([this, num_trucks](auto& dist) {
+        for(uint16_t i = 0; i < num_trucks; i++) {
+            this->trucks.emplace_back(dist(this->gen));
+        }
+    }, this->mining_time);
+}
+
+/****************************************************************************************
+ * simulate                                                                             *
+ * @brief Runs the tick loop for `total_time` ticks.                                    *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void BaySimulation::simulate() {
+
+    FixedHorizon horizon(this->total_time);
+
+    this->simulate(horizon);
+}
+
+/****************************************************************************************
+ * logging                                                                              *
+ * @brief Outputs the statistics of every truck and station to the console.             *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void BaySimulation::logging() {
+
+    select_checks(this->debug, [this](auto checks) {
+        for(auto& truck : this->trucks) {
+
+            truck.logging(this->total_time);
+
+            checks.check_total_time(truck, this->total_time);
+        }
+    });
+    for(auto& station : this->stations) {
+        station.logging();
+    }
+}
+
+/****************************************************************************************
+ * get_state_fractions                                                                  *
+ * @brief Computes the fraction of time the fleet spent in each category.               *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: StateFractions - The fleet-wide fraction of time spent in each category.    *
+ ****************************************************************************************/
+StateFractions BaySimulation::get_state_fractions() {
+    return fleet_state_fractions(this->trucks, this->total_time);
+}
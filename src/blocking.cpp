@@ -0,0 +1,276 @@
+#ifndef BLOCKING_HPP
+#include "../include/blocking.hpp"
+#endif
+
+#if defined(HAVE_PERF_EVENTS)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(HAVE_PERF_EVENTS)
+/****************************************************************************************
+ * open_counter                                                                         *
+ * @brief Opens a stopped hardware cache counter of the calling thread.                 *
+ *                                                                                      *
+ * @param type: The kind of event `config` selects.                                     *
+ * @param config: The event to count, see perf_event_open(2).                           *
+ * @return: int - The file descriptor of the counter, -1 if it could not be opened.     *
+ ****************************************************************************************/
+static int open_counter(uint32_t type, uint64_t config) {
+
+    perf_event_attr attr = {};
+
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+/****************************************************************************************
+ * read_counter                                                                         *
+ * @brief Reads the count of an open counter.                                           *
+ *                                                                                      *
+ * @param fd: The file descriptor of the counter.                                       *
+ * @return: uint64_t - The count, 0 if it could not be read.                            *
+ ****************************************************************************************/
+static uint64_t read_counter(int fd) {
+
+    uint64_t count = 0;
+
+    if(read(fd, &count, sizeof(count)) != sizeof(count)) {
+        return 0;
+    }
+    return count;
+}
+#endif
+
+/****************************************************************************************
+ * CacheMissCounter Constructor                                                         *
+ * @brief Opens the counters of the calling thread, stopped.                            *
+ *                                                                                      *
+ * Both counters have to open, a report with only one of them would be misleading.      *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+CacheMissCounter::CacheMissCounter() : l1_fd(-1), l2_fd(-1) {
+
+#if defined(HAVE_PERF_EVENTS)
+    this->l1_fd = open_counter(PERF_TYPE_HW_CACHE,
+                               PERF_COUNT_HW_CACHE_L1D |
+                               (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                               (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    this->l2_fd = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES);
+
+    if((this->l1_fd < 0) || (this->l2_fd < 0)) {
+        for(int* fd : {&this->l1_fd, &this->l2_fd}) {
+            if(*fd >= 0) {
+                close(*fd);
+            }
+            *fd = -1;
+        }
+    }
+#endif
+}
+
+/****************************************************************************************
+ * CacheMissCounter Destructor                                                          *
+ * @brief Closes the counters.                                                          *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+CacheMissCounter::~CacheMissCounter() {
+
+#if defined(HAVE_PERF_EVENTS)
+    for(int fd : {this->l1_fd, this->l2_fd}) {
+        if(fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+/****************************************************************************************
+ * is_available                                                                         *
+ * @brief Retrieves whether the hardware counters could be opened.                      *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: bool - True if `stop` reports real counts.                                  *
+ ****************************************************************************************/
+bool CacheMissCounter::is_available() const {
+    return this->l1_fd >= 0;
+}
+
+/****************************************************************************************
+ * start                                                                                *
+ * @brief Clears the counters and starts counting.                                      *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void CacheMissCounter::start() {
+
+#if defined(HAVE_PERF_EVENTS)
+    if(this->is_available()) {
+        for(int fd : {this->l1_fd, this->l2_fd}) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+/****************************************************************************************
+ * stop                                                                                 *
+ * @brief Stops counting and reads the counters.                                        *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: CacheMisses - The misses since `start`, all zero if unavailable.            *
+ ****************************************************************************************/
+CacheMisses CacheMissCounter::stop() {
+
+    CacheMisses misses = {0, 0};
+
+#if defined(HAVE_PERF_EVENTS)
+    if(this->is_available()) {
+        for(int fd : {this->l1_fd, this->l2_fd}) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+        misses.l1 = read_counter(this->l1_fd);
+        misses.l2 = read_counter(this->l2_fd);
+    }
+#endif
+
+    return misses;
+}
+
+/****************************************************************************************
+ * simulate_blocked                                                                     *
+ * @brief Runs the tick loop of a simulation for its fixed horizon in windows of ticks. *
+ *                                                                                      *
+ * This is the blocked counterpart of `Simulation::simulate`, including the warm-up,    *
+ * and produces exactly the same results for the same seed.                             *
+ *                                                                                      *
+ * @param sim: The simulation to run.                                                   *
+ * @return: None                                                                        *
+ * @throws: std::runtime_error if a debug check fails.                                  *
+ ****************************************************************************************/
+void simulate_blocked(Simulation& sim) {
+
+    /* Run through the warm-up first and discard what was recorded during it            */
+    if(sim.get_warmup_time()) {
+
+        FixedHorizon warmup(sim.get_warmup_time());
+
+        simulate_blocked(sim, warmup);
+        sim.reset_statistics();
+    }
+
+    /* Run for the total simulation time                                                */
+    FixedHorizon horizon(sim.total_time);
+
+    simulate_blocked(sim, horizon);
+}
+
+/****************************************************************************************
+ * benchmark_blocking                                                                   *
+ * @brief Measures the throughput and the cache misses of the serial and the blocked    *
+ *        tick loop on the same simulation.                                             *
+ *                                                                                      *
+ * @param num_trucks: The number of trucks in the simulation.                           *
+ * @param num_stations: The number of stations in the simulation.                       *
+ * @return: BlockingReport - The metrics of both tick loops.                            *
+ * @throws: std::runtime_error if the two tick loops do not produce the same trucks.    *
+ ****************************************************************************************/
+BlockingReport benchmark_blocking(uint16_t num_trucks, uint16_t num_stations) {
+
+    BlockingReport report = {num_trucks, num_stations, false, {}, {}};
+    uint32_t seed = std::random_device{}();
+    double updates = std::max(static_cast<double>(num_trucks) * MAX_TIME, 1.0);
+
+    CacheMissCounter counter;
+    report.counted = counter.is_available();
+
+    Simulation serial(num_trucks, num_stations, false,
+                      UniformMiningTime(ONE_HOUR, FIVE_HOUR), seed);
+    Simulation blocked(num_trucks, num_stations, false,
+                       UniformMiningTime(ONE_HOUR, FIVE_HOUR), seed);
+
+    /* Runs one tick loop over its simulation and counts what it cost                   */
+    auto run = [&](auto&& tick_loop) {
+
+        counter.start();
+        auto start = std::chrono::steady_clock::now();
+
+        tick_loop();
+
+        auto end = std::chrono::steady_clock::now();
+        CacheMisses misses = counter.stop();
+
+        return EngineMetrics{updates / std::chrono::duration<double>(end - start).count(),
+                             misses.l1 / updates,
+                             misses.l2 / updates};
+    };
+
+    report.serial = run([&]() { serial.simulate(); });
+    report.blocked = run([&]() { simulate_blocked(blocked); });
+
+    /* Both loops did the same work, so every truck and station has to agree            */
+    bool diverged = (serial.tick != blocked.tick);
+
+    for(size_t i = 0; i < serial.trucks.size(); i++) {
+        diverged |= (serial.trucks[i].get_total_time() !=
+                     blocked.trucks[i].get_total_time());
+        diverged |= (serial.trucks[i].get_state() != blocked.trucks[i].get_state());
+    }
+    for(size_t i = 0; i < serial.stations.size(); i++) {
+        diverged |= (serial.stations[i].get_queue(serial.tick) !=
+                     blocked.stations[i].get_queue(blocked.tick));
+    }
+
+    if(diverged) {
+        throw std::runtime_error("The blocked tick loop diverged from the serial one");
+    }
+
+    return report;
+}
+
+/****************************************************************************************
+ * log_blocking_report                                                                  *
+ * @brief Outputs the result of `benchmark_blocking` to the console.                    *
+ *                                                                                      *
+ * @param report: The benchmark result to print.                                        *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void log_blocking_report(const BlockingReport& report) {
+
+    /* Prints one tick loop's line                                                      */
+    auto log = [&report](const char* name, const EngineMetrics& metrics) {
+
+        std::cout << name << ": " << metrics.update_rate << " updates/s";
+
+        if(report.counted) {
+            std::cout << ", " << metrics.l1_misses << " L1 misses/update, "
+            << metrics.l2_misses << " L2 misses/update";
+        }
+        std::cout << std::endl;
+    };
+
+    std::cout << "Temporal blocking over " << report.num_trucks << " trucks and "
+    << report.num_stations << " stations" << std::endl;
+    log("Serial", report.serial);
+    log("Blocked", report.blocked);
+
+    if(!report.counted) {
+        std::cout << "Cache misses not counted, the hardware counters are unavailable"
+        << std::endl;
+    }
+    std::cout << std::endl;
+}
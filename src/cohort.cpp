@@ -0,0 +1,408 @@
+#ifndef COHORT_HPP
+#include "../include/cohort.hpp"
+#endif
+
+#include <bit>
+
+/****************************************************************************************
+ * CohortSimulation Constructor                                                         *
+ * @brief Initializes a simulation of the given fleet, with every truck mining.         *
+ *                                                                                      *
+ * Works out the odds `draw` splits cohorts with, sizes the cohort rings to the longest *
+ * timer and deals the fleet out over its first mining times.                           *
+ *                                                                                      *
+ * @param num_trucks: The number of trucks to be simulated.                             *
+ * @param num_stations: The number of stations available in the simulation.             *
+ * @param debug: Optional parameter that enables debug mode if set to true.             *
+ * @param mining_time: Optional distribution of mining times, defaults to the uniform   *
+ *                     distribution between the site's mining time bounds.              *
+ * @param seed: Optional seed of the simulation's random number generator.              *
+ * @param memory: Optional resource the cohorts and stations are stored in.             *
+ * @param site: Optional site the simulation runs at, defaults to the standard site.    *
+ * @return: None                                                                        *
+ * @throws: std::invalid_argument if there are no trucks or no stations, or the site is *
+ *          invalid.                                                                    *
+ ****************************************************************************************/
+CohortSimulation::CohortSimulation(uint32_t num_trucks,
+                                   uint16_t num_stations,
+                                   bool debug,
+                                   std::optional<MiningTimeDistribution> mining_time,
+                                   uint32_t seed,
+                                   std::pmr::memory_resource* memory,
+                                   const SiteConfig& site)
+                                   : num_trucks(num_trucks),
+                                     total_time(site.max_time),
+                                     debug(debug),
+                                     mining_time(mining_time ? std::move(*mining_time)
+                                                             : site_mining_time(site)),
+                                     gen(seed),
+                                     site(site),
+                                     transitions(make_truck_transitions(site)),
+                                     tick(0),
+                                     cohorts(memory),
+                                     cohort_mask(0),
+                                     population{},
+                                     state_ticks{},
+                                     station_runs(memory),
+                                     num_stations(num_stations),
+                                     unload_changes(memory),
+                                     unloading(0),
+                                     queued(0),
+                                     split_odds(memory),
+                                     min_mining_time(0),
+                                     wait_changes(COHORT_WAIT_BINS + 1, 0, memory),
+                                     num_waits(0),
+                                     total_wait(0.0),
+                                     max_wait(0) {
+
+    validate_site(site);
+
+    if((num_trucks == 0) || (num_stations == 0)) {
+        throw std::invalid_argument("A fleet needs at least one truck and one station");
+    }
+
+    /* The queues start out empty, the ring grows once they reach past it               */
+    this->station_runs.push_back(StationRun{num_stations, 0, 0});
+    this->unload_changes.assign(std::bit_ceil(site.travel_time + 1u), 0);
+
+    std::visit([this](auto& dist) {
+
+        this->min_mining_time = dist.get_min_time();
+
+        /* Odds of each mining time among the ones left after the shorter ones          */
+        double left = 1.0;
+
+        for(uint32_t t = dist.get_min_time(); t <= dist.get_max_time(); t++) {
+
+            double chance = dist.probability(static_cast<uint16_t>(t));
+
+            this->split_odds.push_back((left > chance) ? chance / left : 1.0);
+            left -= chance;
+        }
+
+        /* Whatever rounding leaves over goes to the longest mining time                */
+        this->split_odds.back() = 1.0;
+
+        /* Every timer expires less than one ring ahead of the current tick             */
+        uint32_t longest = std::max<uint32_t>(dist.get_max_time(),
+                                              this->site.travel_time);
+
+        this->cohort_mask = std::bit_ceil(longest + 1) - 1;
+        this->cohorts.assign(this->population.size() * (this->cohort_mask + 1), 0);
+
+        /* Every truck starts out mining on the first tick                              */
+        this->draw(dist, 0, this->num_trucks);
+
+    }, this->mining_time);
+}
+
+/****************************************************************************************
+ * simulate                                                                             *
+ * @brief Runs the tick loop for `total_time` ticks.                                    *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void CohortSimulation::simulate() {
+
+    FixedHorizon horizon(this->total_time);
+
+    this->simulate(horizon);
+}
+
+/****************************************************************************************
+ * schedule                                                                             *
+ * @brief Adds trucks to the cohort of a state whose timer expires at the given tick.   *
+ *                                                                                      *
+ * @param state: The state the trucks are in.                                           *
+ * @param expiry: The tick their timer expires at, less than a ring ahead.              *
+ * @param count: The number of trucks.                                                  *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void CohortSimulation::schedule(TruckState state, uint32_t expiry, uint32_t count) {
+
+    size_t ring = static_cast<size_t>(state) * (this->cohort_mask + 1);
+
+    this->cohorts[ring + (expiry & this->cohort_mask)] += count;
+    this->population[static_cast<size_t>(state)] += count;
+}
+
+/****************************************************************************************
+ * expire                                                                               *
+ * @brief Removes the cohort of a state whose timer expires this tick.                  *
+ *                                                                                      *
+ * @param state: The state of the cohort.                                               *
+ * @return: uint32_t - The number of trucks in the cohort.                              *
+ ****************************************************************************************/
+uint32_t CohortSimulation::expire(TruckState state) {
+
+    size_t ring = static_cast<size_t>(state) * (this->cohort_mask + 1);
+    uint32_t& cohort = this->cohorts[ring + (this->tick & this->cohort_mask)];
+    uint32_t count = cohort;
+
+    cohort = 0;
+    this->population[static_cast<size_t>(state)] -= count;
+
+    return count;
+}
+
+/****************************************************************************************
+ * arrive                                                                               *
+ * @brief Deals a cohort arriving at the stations out round robin and queues it.        *
+ *                                                                                      *
+ * Every station gets the same share and the next `count % S` stations one more, so     *
+ * only the run holding that boundary is split. The runs given the extra truck move to  *
+ * the back, so the front run always holds the station the next truck is sent to.       *
+ *                                                                                      *
+ * @param count: The number of trucks in the cohort.                                    *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void CohortSimulation::arrive(uint32_t count) {
+
+    uint32_t share = count / this->num_stations;
+    uint32_t extra = count % this->num_stations;
+    size_t moved = 0;
+
+    /* The stations getting one more truck move from the front to the back              */
+    while(extra > 0) {
+
+        StationRun run = this->station_runs.front();
+
+        this->station_runs.pop_front();
+
+        if(run.num_stations > extra) {
+
+            StationRun rest = run;
+
+            rest.num_stations -= extra;
+            run.num_stations = extra;
+            this->station_runs.push_front(rest);
+        }
+
+        extra -= run.num_stations;
+        this->join_queue(run, share + 1);
+        this->station_runs.push_back(run);
+        moved++;
+    }
+
+    /* The other stations only get the share, which touches every run                   */
+    size_t others = this->station_runs.size() - moved;
+
+    if(share > 0) {
+        for(size_t i = 0; i < others; i++) {
+            this->join_queue(this->station_runs[i], share);
+        }
+    }
+
+    this->merge_runs((share > 0) ? 0 : others - 1);
+}
+
+/****************************************************************************************
+ * join_queue                                                                           *
+ * @brief Queues trucks at every station of a run behind the trucks already there.      *
+ *                                                                                      *
+ * The trucks unload one per tick right after the stations' last queued truck, or from  *
+ * the next tick on if they have none, which only moves the ticks the stations start    *
+ * and stop unloading at.                                                               *
+ *                                                                                      *
+ * @param run: The run of stations.                                                     *
+ * @param count: The number of trucks joining each station, they unload on consecutive  *
+ *               ticks.                                                                 *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void CohortSimulation::join_queue(StationRun& run, uint32_t count) {
+
+    uint64_t first = std::max<uint64_t>(run.empty_tick, this->tick) + 1;
+    uint64_t end = first + count;
+
+    run.empty_tick = end - 1;
+    run.assigned += count;
+    this->queued += static_cast<uint64_t>(count) * run.num_stations;
+
+    this->record_waits(first - this->tick - 1, count, run.num_stations);
+
+    /* Grow the ring once the queue reaches past it, keeping every tick where it is     */
+    size_t size = this->unload_changes.size();
+
+    if(end - this->tick >= size) {
+
+        std::pmr::vector<int32_t> grown(std::bit_ceil<size_t>(end - this->tick + 1), 0,
+                                        this->unload_changes.get_allocator());
+
+        for(uint64_t t = this->tick; t != this->tick + size; t++) {
+            grown[t & (grown.size() - 1)] = this->unload_changes[t & (size - 1)];
+        }
+        this->unload_changes.swap(grown);
+    }
+
+    size_t mask = this->unload_changes.size() - 1;
+
+    this->unload_changes[first & mask] += run.num_stations;
+    this->unload_changes[end & mask] -= run.num_stations;
+}
+
+/****************************************************************************************
+ * merge_runs                                                                           *
+ * @brief Merges neighbouring runs that run empty at the same tick and were sent the    *
+ *        same number of trucks.                                                        *
+ *                                                                                      *
+ * @param first: The index of the first run that may be merged with the one after it.   *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void CohortSimulation::merge_runs(size_t first) {
+
+    std::pmr::deque<StationRun>& runs = this->station_runs;
+    size_t last = first;
+
+    for(size_t i = first + 1; i < runs.size(); i++) {
+
+        if((runs[i].empty_tick == runs[last].empty_tick) &&
+           (runs[i].assigned == runs[last].assigned)) {
+            runs[last].num_stations += runs[i].num_stations;
+        }
+        else {
+            runs[++last] = runs[i];
+        }
+    }
+
+    runs.resize(last + 1);
+}
+
+/****************************************************************************************
+ * record_waits                                                                         *
+ * @brief Adds the waits first, first + 1, ..., first + count - 1 of every station of a *
+ *        run to the distribution.                                                      *
+ *                                                                                      *
+ * The distribution is kept as the change in count from each bin to the next, so a run  *
+ * of waits costs two updates however long it is.                                       *
+ *                                                                                      *
+ * @param first: The wait of the first truck in ticks.                                  *
+ * @param count: The number of trucks joining each station.                             *
+ * @param num_stations: The number of stations in the run.                              *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void CohortSimulation::record_waits(uint64_t first, uint32_t count,
+                                    uint32_t num_stations) {
+
+    uint64_t last = first + count - 1;
+    uint64_t last_bin = COHORT_WAIT_BINS - 1;
+
+    this->num_waits += static_cast<uint64_t>(count) * num_stations;
+    this->total_wait += num_stations * (static_cast<double>(first) + last) * count / 2.0;
+    this->max_wait = std::max(this->max_wait, last);
+
+    /* One truck per station for every bin the run covers                               */
+    if(first < last_bin) {
+        this->wait_changes[first] += num_stations;
+        this->wait_changes[std::min(last, last_bin - 1) + 1] -= num_stations;
+    }
+
+    /* Everything from the last bin on is counted in it                                 */
+    if(last >= last_bin) {
+
+        int64_t overflow = (last - std::max(first, last_bin) + 1) * num_stations;
+
+        this->wait_changes[last_bin] += overflow;
+        this->wait_changes[last_bin + 1] -= overflow;
+    }
+}
+
+/****************************************************************************************
+ * get_wait_percentile                                                                  *
+ * @brief Computes a percentile of the wait of every truck that joined a queue.         *
+ *                                                                                      *
+ * @param fraction: The percentile as a fraction, between 0.0 and 1.0.                  *
+ * @return: uint32_t - The wait in ticks, at most COHORT_WAIT_BINS - 1.                 *
+ ****************************************************************************************/
+uint32_t CohortSimulation::get_wait_percentile(double fraction) {
+
+    uint64_t target = std::max<uint64_t>(std::ceil(fraction * this->num_waits), 1);
+    int64_t count = 0;
+    uint64_t seen = 0;
+
+    for(uint32_t bin = 0; bin < COHORT_WAIT_BINS; bin++) {
+
+        count += this->wait_changes[bin];
+        seen += count;
+
+        if(seen >= target) {
+            return bin;
+        }
+    }
+    return COHORT_WAIT_BINS - 1;
+}
+
+/****************************************************************************************
+ * get_state_fractions                                                                  *
+ * @brief Computes the fraction of time the fleet spent in each category.               *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: StateFractions - The fleet-wide fraction of time spent in each category.    *
+ ****************************************************************************************/
+StateFractions CohortSimulation::get_state_fractions() {
+
+    auto ticks = [this](TruckState state) {
+        return static_cast<double>(this->state_ticks[static_cast<size_t>(state)]);
+    };
+
+    /* Normalize by the time available to the whole fleet                               */
+    double fleet_time = static_cast<double>(this->total_time) * this->num_trucks;
+
+    return StateFractions{ticks(TruckState::Waiting) / fleet_time,
+                          ticks(TruckState::Unloading) / fleet_time,
+                          (ticks(TruckState::TravelStation) +
+                           ticks(TruckState::TravelMining)) / fleet_time,
+                          ticks(TruckState::Mining) / fleet_time};
+}
+
+/****************************************************************************************
+ * logging                                                                              *
+ * @brief Outputs the fleet's state fractions and the wait and unload distributions to  *
+ *        the console.                                                                  *
+ *                                                                                      *
+ * A station's trucks still queued at the end have not been unloaded, those are the     *
+ * trucks sent to it that unload from the current tick on.                              *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void CohortSimulation::logging() {
+
+    StateFractions fractions = this->get_state_fractions();
+
+    std::cout << "Fleet of " << this->num_trucks << " trucks at "
+    << this->num_stations << " stations" << std::endl;
+    std::cout << "Waiting: " << fractions.waiting * 100 << "%" << std::endl;
+    std::cout << "Unloading: " << fractions.unloading * 100 << "%" << std::endl;
+    std::cout << "Traveling: " << fractions.traveling * 100 << "%" << std::endl;
+    std::cout << "Mining: " << fractions.mining * 100 << "%" << std::endl;
+
+    /* Wait of every truck that joined a queue                                          */
+    double mean = this->num_waits ? this->total_wait / this->num_waits : 0.0;
+
+    std::cout << "Wait per station visit: " << mean << " mean, "
+    << this->get_wait_percentile(0.5) << " median, "
+    << this->get_wait_percentile(0.9) << " p90, "
+    << this->get_wait_percentile(0.99) << " p99, "
+    << this->max_wait << " max ticks" << std::endl;
+
+    /* Trucks unloaded by each station                                                  */
+    uint64_t fewest = UINT64_MAX;
+    uint64_t most = 0;
+    uint64_t unloaded = 0;
+
+    for(const StationRun& run : this->station_runs) {
+
+        uint64_t pending = (run.empty_tick >= this->tick) ?
+                           run.empty_tick - this->tick + 1 : 0;
+        uint64_t count = run.assigned - std::min(pending, run.assigned);
+
+        fewest = std::min(fewest, count);
+        most = std::max(most, count);
+        unloaded += count * run.num_stations;
+    }
+
+    std::cout << "Trucks unloaded per station: " << fewest << " min, "
+    << static_cast<double>(unloaded) / this->num_stations << " mean, "
+    << most << " max" << std::endl << std::endl;
+}
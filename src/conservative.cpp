@@ -0,0 +1,138 @@
+#ifndef CONSERVATIVE_HPP
+#include "../include/conservative.hpp"
+#endif
+
+#ifndef PARALLEL_HPP
+#include "../include/parallel.hpp"
+#endif
+
+/****************************************************************************************
+ * simulate_conservative                                                                *
+ * @brief Runs the tick loop of a simulation for its fixed horizon on several threads,  *
+ *        synchronizing them once per travel time.                                      *
+ *                                                                                      *
+ * This is the windowed counterpart of `simulate_parallel`, including the warm-up. It   *
+ * produces the same results for the same seed on any pool, see                         *
+ * `run_conservative_engine`.                                                           *
+ *                                                                                      *
+ * @param sim: The simulation to run.                                                   *
+ * @param pool: The pool advancing the trucks, every truck on a fixed worker.           *
+ * @return: size_t - The number of times the threads synchronized.                      *
+ * @throws: std::runtime_error if a debug check fails.                                  *
+ ****************************************************************************************/
+size_t simulate_conservative(Simulation& sim, ThreadPool& pool) {
+
+    size_t barriers = 0;
+
+    /* Run through the warm-up first and discard what was recorded during it            */
+    if(sim.get_warmup_time()) {
+
+        FixedHorizon warmup(sim.get_warmup_time());
+
+        barriers += simulate_conservative(sim, warmup, pool);
+        sim.reset_statistics();
+    }
+
+    /* Run for the total simulation time                                                */
+    FixedHorizon horizon(sim.total_time);
+
+    return barriers + simulate_conservative(sim, horizon, pool);
+}
+
+/****************************************************************************************
+ * benchmark_conservative                                                               *
+ * @brief Measures the throughput and the synchronizations of the per-tick and the      *
+ *        windowed parallel tick loop on the same simulation.                           *
+ *                                                                                      *
+ * The per-tick loop waits for its threads once every tick. The windowed loop draws     *
+ * its mining times per partition, so it is checked against a second windowed run on a  *
+ * single worker rather than against the per-tick loop.                                 *
+ *                                                                                      *
+ * @param num_trucks: The number of trucks in the simulation.                           *
+ * @param num_stations: The number of stations in the simulation.                       *
+ * @param pool: The pool running both simulations, which should have several workers.   *
+ * @return: ConservativeReport - The metrics of both tick loops.                        *
+ * @throws: std::runtime_error if the two windowed runs do not produce the same trucks. *
+ ****************************************************************************************/
+ConservativeReport benchmark_conservative(uint16_t num_trucks, uint16_t num_stations,
+                                          ThreadPool& pool) {
+
+    ConservativeReport report = {num_trucks, num_stations, pool.size(), {}, {}};
+    uint32_t seed = std::random_device{}();
+    double updates = std::max(static_cast<double>(num_trucks) * MAX_TIME, 1.0);
+
+    Simulation per_tick(num_trucks, num_stations, false,
+                        UniformMiningTime(ONE_HOUR, FIVE_HOUR), seed);
+    Simulation windowed(num_trucks, num_stations, false,
+                        UniformMiningTime(ONE_HOUR, FIVE_HOUR), seed);
+    Simulation replayed(num_trucks, num_stations, false,
+                        UniformMiningTime(ONE_HOUR, FIVE_HOUR), seed);
+
+    /* Runs one tick loop over its simulation, in seconds                               */
+    auto run = [](auto&& tick_loop) {
+
+        auto start = std::chrono::steady_clock::now();
+        tick_loop();
+        auto end = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double>(end - start).count();
+    };
+
+    report.per_tick.update_rate = updates / run([&]() {
+        simulate_parallel(per_tick, pool);
+    });
+    report.per_tick.barriers = per_tick.tick;
+
+    report.windowed.update_rate = updates / run([&]() {
+        report.windowed.barriers = simulate_conservative(windowed, pool);
+    });
+
+    /* Both windowed runs started from the same seed, so every truck and station has to  *
+     * agree whatever the number of workers, and both loops have to have run the same   *
+     * ticks                                                                            */
+    ThreadPool single(1);
+    simulate_conservative(replayed, single);
+
+    bool diverged = (per_tick.tick != windowed.tick) || (replayed.tick != windowed.tick);
+
+    for(size_t i = 0; i < windowed.trucks.size(); i++) {
+        diverged |= (replayed.trucks[i].get_total_time() !=
+                     windowed.trucks[i].get_total_time());
+        diverged |= (replayed.trucks[i].get_state() != windowed.trucks[i].get_state());
+    }
+    for(size_t i = 0; i < windowed.stations.size(); i++) {
+        diverged |= (replayed.stations[i].get_queue(replayed.tick) !=
+                     windowed.stations[i].get_queue(windowed.tick));
+        diverged |= (replayed.stations[i].get_trucks_unloaded() !=
+                     windowed.stations[i].get_trucks_unloaded());
+    }
+
+    if(diverged) {
+        throw std::runtime_error("The windowed parallel tick loop is not deterministic across thread counts");
+    }
+
+    return report;
+}
+
+/****************************************************************************************
+ * log_conservative_report                                                              *
+ * @brief Outputs the result of `benchmark_conservative` to the console.                *
+ *                                                                                      *
+ * @param report: The benchmark result to print.                                        *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void log_conservative_report(const ConservativeReport& report) {
+
+    /* Prints one tick loop's line                                                      */
+    auto log = [](const char* name, const SyncMetrics& metrics) {
+        std::cout << name << ": " << metrics.update_rate << " updates/s, "
+        << metrics.barriers << " barriers" << std::endl;
+    };
+
+    std::cout << "Conservative synchronization over " << report.num_trucks << " trucks, "
+    << report.num_stations << " stations and " << report.num_threads << " threads"
+    << std::endl;
+    log("Per tick", report.per_tick);
+    log("Per travel time", report.windowed);
+    std::cout << std::endl;
+}
@@ -0,0 +1,440 @@
+#ifndef DISTRIBUTION_HPP
+#include "../include/distribution.hpp"
+#endif
+
+/****************************************************************************************
+ * validate_range                                                                       *
+ * @brief Verifies that a range of mining times can be stored in a truck's timer.       *
+ *                                                                                      *
+ * A mining time of zero would underflow the truck's timer on its first decrement, so   *
+ * every range has to start at one tick or later.                                       *
+ *                                                                                      *
+ * @param min_time: The shortest mining time in ticks.                                  *
+ * @param max_time: The longest mining time in ticks.                                   *
+ * @return: None                                                                        *
+ * @throws: std::invalid_argument if the range is empty or contains zero.               *
+ ****************************************************************************************/
+static void validate_range(uint32_t min_time, uint32_t max_time) {
+
+    if((min_time == 0) || (max_time < min_time) || (max_time > UINT16_MAX)) {
+        throw std::invalid_argument("Mining times must be between 1 and 65535 ticks");
+    }
+}
+
+/****************************************************************************************
+ * lognormal_cdf                                                                        *
+ * @brief Computes the lognormal CDF, Phi((ln x - m) / s).                              *
+ *                                                                                      *
+ * @param x: The value in ticks.                                                        *
+ * @param m: The mean of the underlying normal distribution.                            *
+ * @param s: The standard deviation of the underlying normal distribution.              *
+ * @return: double - The probability of a draw below `x`.                               *
+ ****************************************************************************************/
+static double lognormal_cdf(double x, double m, double s) {
+    return (x <= 0.0) ? 0.0 : 0.5 * std::erfc(-(std::log(x) - m) / (s * std::sqrt(2.0)));
+}
+
+/****************************************************************************************
+ * UniformMiningTime Constructor                                                        *
+ * @brief Initializes the distribution with an inclusive range of mining times.         *
+ *                                                                                      *
+ * @param min_time: The shortest mining time in ticks, must be at least 1.              *
+ * @param max_time: The longest mining time in ticks, must be at least `min_time`.      *
+ * @return: None                                                                        *
+ * @throws: std::invalid_argument if the range is empty or contains zero.               *
+ ****************************************************************************************/
+UniformMiningTime::UniformMiningTime(uint16_t min_time, uint16_t max_time)
+                                    : dist(min_time, max_time),
+                                      expected((min_time + max_time) / 2.0) {
+    validate_range(min_time, max_time);
+}
+
+/****************************************************************************************
+ * LognormalMiningTime Constructor                                                      *
+ * @brief Initializes the distribution with its log-space parameters and a clamp range. *
+ *                                                                                      *
+ * @param m: The mean of the underlying normal distribution (log of ticks).             *
+ * @param s: The standard deviation of the underlying normal distribution.              *
+ * @param min_time: The shortest mining time in ticks, must be at least 1.              *
+ * @param max_time: The longest mining time in ticks, must be at least `min_time`.      *
+ * @return: None                                                                        *
+ * @throws: std::invalid_argument if the clamp range is empty or contains zero.         *
+ ****************************************************************************************/
+LognormalMiningTime::LognormalMiningTime(double m,
+                                         double s,
+                                         uint16_t min_time,
+                                         uint16_t max_time) : dist(m, s),
+                                                              min_time(min_time),
+                                                              max_time(max_time),
+                                                              expected(0.0) {
+    validate_range(min_time, max_time);
+
+    /* Sum t * P(t) over the clamp range, see `probability`                             */
+    for(uint32_t t = min_time; t <= max_time; t++) {
+        this->expected += t * this->probability(static_cast<uint16_t>(t));
+    }
+}
+
+/****************************************************************************************
+ * EmpiricalMiningTime Constructor                                                      *
+ * @brief Builds the alias table for the given histogram.                               *
+ *                                                                                      *
+ * The table is built with Vose's alias method. Every weight is scaled so the average   *
+ * bin holds exactly 1.0, then bins are split into a "small" (< 1.0) and a "large"      *
+ * (>= 1.0) worklist. Each small bin is topped up to 1.0 by borrowing from a large      *
+ * bin, which becomes its alias. A bin that drops below 1.0 after lending moves to the  *
+ * small list. Whatever is left over at the end is exactly 1.0 up to rounding error.    *
+ *                                                                                      *
+ * @param histogram: Non-negative weights, one per tick starting at `min_time`. The     *
+ *                   weights do not need to be normalized.                              *
+ * @param min_time: The mining time in ticks of the first bin, must be at least 1.      *
+ * @return: None                                                                        *
+ * @throws: std::invalid_argument if the histogram is empty, has negative weights,      *
+ *          sums to zero, or does not fit in the 16 bit timer.                          *
+ ****************************************************************************************/
+EmpiricalMiningTime::EmpiricalMiningTime(const std::vector<double>& histogram,
+                                         uint16_t min_time) : prob(histogram.size()),
+                                                              alias(histogram.size()),
+                                                              bin(0, 0),
+                                                              coin(0.0, 1.0),
+                                                              weights(histogram.size()),
+                                                              min_time(min_time),
+                                                              expected(0.0) {
+    if(histogram.empty()) {
+        throw std::invalid_argument("The mining time histogram is empty");
+    }
+    validate_range(min_time, min_time + histogram.size() - 1);
+
+    double sum = 0.0;
+
+    for(double weight : histogram) {
+        if(weight < 0.0) {
+            throw std::invalid_argument("The mining time histogram has a negative weight");
+        }
+        sum += weight;
+    }
+    if(sum <= 0.0) {
+        throw std::invalid_argument("The mining time histogram has no weight");
+    }
+
+    for(size_t i = 0; i < histogram.size(); i++) {
+        this->weights[i] = histogram[i] / sum;
+        this->expected += (min_time + i) * this->weights[i];
+    }
+
+    /* Scale the weights so that the average bin holds exactly 1.0                      */
+    size_t n = histogram.size();
+    std::vector<double> scaled(n);
+    std::vector<uint16_t> small;
+    std::vector<uint16_t> large;
+
+    small.reserve(n);
+    large.reserve(n);
+
+    for(size_t i = 0; i < n; i++) {
+        scaled[i] = histogram[i] * n / sum;
+        ((scaled[i] < 1.0) ? small : large).push_back(static_cast<uint16_t>(i));
+    }
+
+    /* Top up each small bin with the excess of a large bin                             */
+    while(!small.empty() && !large.empty()) {
+
+        uint16_t less = small.back();
+        uint16_t more = large.back();
+        small.pop_back();
+
+        this->prob[less] = scaled[less];
+        this->alias[less] = more;
+
+        scaled[more] -= (1.0 - scaled[less]);
+
+        if(scaled[more] < 1.0) {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+
+    /* The remaining bins are full, only rounding error keeps them off 1.0              */
+    for(uint16_t idx : large) {
+        this->prob[idx] = 1.0;
+        this->alias[idx] = idx;
+    }
+    for(uint16_t idx : small) {
+        this->prob[idx] = 1.0;
+        this->alias[idx] = idx;
+    }
+
+    this->bin = std::uniform_int_distribution<size_t>(0, n - 1);
+}
+
+/****************************************************************************************
+ * EmpiricalMiningTime Constructor                                                      *
+ * @brief Copies a distribution, allocating the tables of the copy from `memory`.       *
+ *                                                                                      *
+ * @param other: The distribution to copy.                                              *
+ * @param memory: The resource the alias table and the weights are stored in.           *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+EmpiricalMiningTime::EmpiricalMiningTime(const EmpiricalMiningTime& other,
+                                         std::pmr::memory_resource* memory)
+                                         : prob(other.prob, memory),
+                                           alias(other.alias, memory),
+                                           bin(other.bin),
+                                           coin(other.coin),
+                                           weights(other.weights, memory),
+                                           min_time(other.min_time),
+                                           expected(other.expected) {}
+
+/****************************************************************************************
+ * UniformMiningTime::reset                                                             *
+ * @brief Discards any state the distribution carries over from one draw to the next.   *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void UniformMiningTime::reset() {
+    this->dist.reset();
+}
+
+/****************************************************************************************
+ * LognormalMiningTime::reset                                                           *
+ * @brief Discards any state the distribution carries over from one draw to the next.   *
+ *                                                                                      *
+ * The underlying normal distribution draws its values in pairs and keeps the second    *
+ * one for the next draw, which would otherwise leak into the next run.                 *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void LognormalMiningTime::reset() {
+    this->dist.reset();
+}
+
+/****************************************************************************************
+ * EmpiricalMiningTime::reset                                                           *
+ * @brief Discards any state the distribution carries over from one draw to the next.   *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void EmpiricalMiningTime::reset() {
+    this->bin.reset();
+    this->coin.reset();
+}
+
+/****************************************************************************************
+ * UniformMiningTime::mean                                                              *
+ * @brief Retrieves the expected mining time in ticks of this distribution.             *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: double - The mean of the distribution after rounding and clamping.          *
+ ****************************************************************************************/
+double UniformMiningTime::mean() const {
+    return this->expected;
+}
+
+/****************************************************************************************
+ * LognormalMiningTime::mean                                                            *
+ * @brief Retrieves the expected mining time in ticks of this distribution.             *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: double - The mean of the distribution after rounding and clamping.          *
+ ****************************************************************************************/
+double LognormalMiningTime::mean() const {
+    return this->expected;
+}
+
+/****************************************************************************************
+ * EmpiricalMiningTime::mean                                                            *
+ * @brief Retrieves the expected mining time in ticks of this distribution.             *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: double - The mean of the distribution after rounding and clamping.          *
+ ****************************************************************************************/
+double EmpiricalMiningTime::mean() const {
+    return this->expected;
+}
+
+/****************************************************************************************
+ * UniformMiningTime::get_min_time                                                      *
+ * @brief Retrieves the shortest mining time the distribution can draw.                 *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: uint16_t - The shortest mining time in ticks.                               *
+ ****************************************************************************************/
+uint16_t UniformMiningTime::get_min_time() const {
+    return static_cast<uint16_t>(this->dist.a());
+}
+
+/****************************************************************************************
+ * UniformMiningTime::get_max_time                                                      *
+ * @brief Retrieves the longest mining time the distribution can draw.                  *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: uint16_t - The longest mining time in ticks.                                *
+ ****************************************************************************************/
+uint16_t UniformMiningTime::get_max_time() const {
+    return static_cast<uint16_t>(this->dist.b());
+}
+
+/****************************************************************************************
+ * UniformMiningTime::probability                                                       *
+ * @brief Computes the probability of drawing a mining time.                            *
+ *                                                                                      *
+ * @param time: The mining time in ticks.                                               *
+ * @return: double - The probability of a draw of exactly `time` ticks.                 *
+ ****************************************************************************************/
+double UniformMiningTime::probability(uint16_t time) const {
+
+    if((time < this->dist.a()) || (time > this->dist.b())) {
+        return 0.0;
+    }
+    return 1.0 / (this->dist.b() - this->dist.a() + 1);
+}
+
+/****************************************************************************************
+ * LognormalMiningTime::get_min_time                                                    *
+ * @brief Retrieves the shortest mining time the distribution can draw.                 *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: uint16_t - The shortest mining time in ticks.                               *
+ ****************************************************************************************/
+uint16_t LognormalMiningTime::get_min_time() const {
+    return static_cast<uint16_t>(this->min_time);
+}
+
+/****************************************************************************************
+ * LognormalMiningTime::get_max_time                                                    *
+ * @brief Retrieves the longest mining time the distribution can draw.                  *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: uint16_t - The longest mining time in ticks.                                *
+ ****************************************************************************************/
+uint16_t LognormalMiningTime::get_max_time() const {
+    return static_cast<uint16_t>(this->max_time);
+}
+
+/****************************************************************************************
+ * LognormalMiningTime::probability                                                     *
+ * @brief Computes the probability of drawing a mining time.                            *
+ *                                                                                      *
+ * A draw rounds to tick t when it falls in [t - 0.5, t + 0.5), and everything below or *
+ * above the clamp range collapses onto the end points.                                 *
+ *                                                                                      *
+ * @param time: The mining time in ticks.                                               *
+ * @return: double - The probability of a draw of exactly `time` ticks.                 *
+ ****************************************************************************************/
+double LognormalMiningTime::probability(uint16_t time) const {
+
+    if((time < this->min_time) || (time > this->max_time)) {
+        return 0.0;
+    }
+
+    double m = this->dist.m();
+    double s = this->dist.s();
+    double below = (time == this->min_time) ? 0.0 : lognormal_cdf(time - 0.5, m, s);
+    double above = (time == this->max_time) ? 1.0 : lognormal_cdf(time + 0.5, m, s);
+
+    return above - below;
+}
+
+/****************************************************************************************
+ * EmpiricalMiningTime::get_min_time                                                    *
+ * @brief Retrieves the shortest mining time the distribution can draw.                 *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: uint16_t - The shortest mining time in ticks.                               *
+ ****************************************************************************************/
+uint16_t EmpiricalMiningTime::get_min_time() const {
+    return this->min_time;
+}
+
+/****************************************************************************************
+ * EmpiricalMiningTime::get_max_time                                                    *
+ * @brief Retrieves the longest mining time the distribution can draw.                  *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: uint16_t - The longest mining time in ticks.                                *
+ ****************************************************************************************/
+uint16_t EmpiricalMiningTime::get_max_time() const {
+    return static_cast<uint16_t>(this->min_time + this->weights.size() - 1);
+}
+
+/****************************************************************************************
+ * EmpiricalMiningTime::probability                                                     *
+ * @brief Computes the probability of drawing a mining time.                            *
+ *                                                                                      *
+ * @param time: The mining time in ticks.                                               *
+ * @return: double - The probability of a draw of exactly `time` ticks.                 *
+ ****************************************************************************************/
+double EmpiricalMiningTime::probability(uint16_t time) const {
+
+    if((time < this->min_time) || (time > this->get_max_time())) {
+        return 0.0;
+    }
+    return this->weights[time - this->min_time];
+}
+
+/****************************************************************************************
+ * EmpiricalMiningTime::storage_bytes                                                   *
+ * @brief Computes the memory a copy of the distribution allocates from its resource.   *
+ *                                                                                      *
+ * The alias table and the weights are each allocated once, at their exact size.        *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: size_t - The bytes needed, including the worst case alignment padding.      *
+ ****************************************************************************************/
+size_t EmpiricalMiningTime::storage_bytes() const {
+
+    size_t n = this->prob.size();
+
+    return 2 * (n * sizeof(double) + alignof(double)) +
+           n * sizeof(uint16_t) + alignof(uint16_t);
+}
+
+/****************************************************************************************
+ * copy_distribution                                                                    *
+ * @brief Copies a mining time distribution, allocating any table it has from `memory`. *
+ *                                                                                      *
+ * @param dist: The distribution to copy.                                               *
+ * @param memory: The resource the tables of the copy are stored in.                    *
+ * @return: MiningTimeDistribution - The copy.                                          *
+ ****************************************************************************************/
+MiningTimeDistribution copy_distribution(const MiningTimeDistribution& dist,
+                                         std::pmr::memory_resource* memory) {
+
+    return std::visit([memory](const auto& policy) -> MiningTimeDistribution {
+
+        using Policy = std::decay_t<decltype(policy)>;
+
+        if constexpr(std::is_same_v<Policy, EmpiricalMiningTime>) {
+            return EmpiricalMiningTime(policy, memory);
+        }
+        else {
+            return policy;
+        }
+    }, dist);
+}
+
+/****************************************************************************************
+ * distribution_storage_bytes                                                           *
+ * @brief Computes the memory `copy_distribution` allocates from its resource.          *
+ *                                                                                      *
+ * @param dist: The distribution to be copied.                                          *
+ * @return: size_t - The bytes needed, zero for the uniform and lognormal               *
+ *                   distributions.                                                     *
+ ****************************************************************************************/
+size_t distribution_storage_bytes(const MiningTimeDistribution& dist) {
+
+    return std::visit([](const auto& policy) -> size_t {
+
+        using Policy = std::decay_t<decltype(policy)>;
+
+        if constexpr(std::is_same_v<Policy, EmpiricalMiningTime>) {
+            return policy.storage_bytes();
+        }
+        else {
+            return 0;
+        }
+    }, dist);
+}
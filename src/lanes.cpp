@@ -0,0 +1,263 @@
+#ifndef LANES_HPP
+#include "../include/lanes.hpp"
+#endif
+
+/****************************************************************************************
+ * LaneSimulation Constructor                                                           *
+ * @brief Initializes every lane the way `Simulation` with the lane's seed would.       *
+ *                                                                                      *
+ * A lane resets its selector before drawing the first mining times of its trucks in    *
+ * index order, as `Simulation::reset` does, so every generator starts where the scalar *
+ * simulation's would.                                                                  *
+ *                                                                                      *
+ * @param num_trucks: The number of trucks in every replication.                        *
+ * @param num_stations: The number of stations in every replication.                    *
+ * @param first_seed: The seed of the first lane, the others follow consecutively.      *
+ * @param mining_time: The distribution of mining times, copied into every lane, the    *
+ *                     uniform distribution between the site's mining time bounds if    *
+ *                     empty.                                                           *
+ * @param memory: The resource the trucks, stations and selectors are stored in.        *
+ * @param site: The site the replications run at.                                       *
+ * @param selection: The station selection policy.                                      *
+ * @return: None                                                                        *
+ * @throws: std::invalid_argument if the site is invalid.                               *
+ ****************************************************************************************/
+LaneSimulation::LaneSimulation(uint16_t num_trucks,
+                               uint16_t num_stations,
+                               uint32_t first_seed,
+                               std::optional<MiningTimeDistribution> mining_time,
+                               std::pmr::memory_resource* memory,
+                               const SiteConfig& site,
+                               SelectionPolicy selection)
+                               : num_trucks(num_trucks),
+                                 num_stations(num_stations),
+                                 total_time(site.max_time),
+                                 site(site),
+                                 transitions(make_truck_transitions(site)),
+                                 tick(0),
+                                 trucks(num_trucks, TruckLanes{}, memory),
+                                 stations(num_stations * REPLICATION_LANES, Station(),
+                                          memory),
+                                 selectors(memory),
+                                 gens(memory),
+                                 mining_times(REPLICATION_LANES,
+                                              mining_time ? std::move(*mining_time)
+                                                          : site_mining_time(site),
+                                              memory) {
+
+    validate_site(site);
+
+    const TruckTransition& mining =
+        this->transitions[static_cast<size_t>(TruckState::Mining)];
+
+    this->selectors.reserve(REPLICATION_LANES);
+    this->gens.reserve(REPLICATION_LANES);
+
+    for(size_t l = 0; l < REPLICATION_LANES; l++) {
+
+        uint32_t seed = first_seed + static_cast<uint32_t>(l);
+
+        this->selectors.push_back(make_selector(selection, memory, site.travel_time));
+        this->gens.emplace_back(seed);
+
+        std::visit([num_stations, seed](auto& selector) {
+            selector.reset(num_stations, seed);
+        }, this->selectors[l]);
+
+        /* Every truck starts out mining (state zero), draw its first mining time       */
+        std::visit([this, l, &mining](auto& dist) {
+            for(size_t i = 0; i < this->num_trucks; i++) {
+                this->trucks[i].timers[l] = dist(this->gens[l]);
+                this->trucks[i].increments[l] = mining.increment;
+                this->trucks[i].countdowns[l] = mining.countdown;
+            }
+        }, this->mining_times[l]);
+    }
+}
+
+/****************************************************************************************
+ * simulate                                                                             *
+ * @brief Runs the tick loop of every lane for `total_time` ticks.                      *
+ *                                                                                      *
+ * The distribution and the selection policy are the same in every lane, so they are    *
+ * resolved once from the first lane and the tick loop is specialized for them.         *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void LaneSimulation::simulate() {
+
+    std::visit([this](auto& dist, auto& selector) {
+        this->run_engine<std::decay_t<decltype(dist)>,
+                         std::decay_t<decltype(selector)>>();
+    }, this->mining_times[0], this->selectors[0]);
+}
+
+/****************************************************************************************
+ * get_state_fractions                                                                  *
+ * @brief Computes the fraction of time the fleet of one lane spent in each category.   *
+ *                                                                                      *
+ * @param lane: The lane, less than REPLICATION_LANES.                                  *
+ * @return: StateFractions - The fleet-wide fraction of time spent in each category.    *
+ ****************************************************************************************/
+StateFractions LaneSimulation::get_state_fractions(size_t lane) {
+
+    StateFractions fractions = {0.0, 0.0, 0.0, 0.0};
+
+    for(size_t i = 0; i < this->num_trucks; i++) {
+
+        uint64_t time = this->trucks[i].total_times[lane];
+
+        fractions.waiting   += RETRIEVE_TIME(time, WAITING_MASK, 0);
+        fractions.unloading += RETRIEVE_TIME(time, UNLOADING_MASK, 16);
+        fractions.traveling += RETRIEVE_TIME(time, TRAVELING_MASK, 32);
+        fractions.mining    += RETRIEVE_TIME(time, MINING_MASK, 48);
+    }
+
+    /* Normalize by the time available to the whole fleet                               */
+    double fleet_time = static_cast<double>(this->total_time) * this->num_trucks;
+
+    fractions.waiting   /= fleet_time;
+    fractions.unloading /= fleet_time;
+    fractions.traveling /= fleet_time;
+    fractions.mining    /= fleet_time;
+
+    return fractions;
+}
+
+/****************************************************************************************
+ * get_total_time                                                                       *
+ * @brief Retrieves the packed time a truck of one lane recorded.                       *
+ *                                                                                      *
+ * @param truck_idx: The index of the truck.                                            *
+ * @param lane: The lane, less than REPLICATION_LANES.                                  *
+ * @return: uint64_t - The total time recorded for the truck across all states.         *
+ ****************************************************************************************/
+uint64_t LaneSimulation::get_total_time(size_t truck_idx, size_t lane) {
+    return this->trucks[truck_idx].total_times[lane];
+}
+
+/****************************************************************************************
+ * get_trucks_unloaded                                                                  *
+ * @brief Retrieves the number of trucks a station of one lane has unloaded.            *
+ *                                                                                      *
+ * @param station_idx: The index of the station.                                        *
+ * @param lane: The lane, less than REPLICATION_LANES.                                  *
+ * @return: uint16_t - The number of trucks unloaded.                                   *
+ ****************************************************************************************/
+uint16_t LaneSimulation::get_trucks_unloaded(size_t station_idx, size_t lane) {
+    return this->stations[lane * this->num_stations + station_idx].get_trucks_unloaded();
+}
+
+/****************************************************************************************
+ * run_lane_replications                                                                *
+ * @brief Runs one replication per entry of `results` for the fixed horizon, seeded     *
+ *        `first_seed`, `first_seed + 1`, ..., and stores their state fractions.        *
+ *                                                                                      *
+ * @param num_trucks: The number of trucks in every replication.                        *
+ * @param num_stations: The number of stations in every replication.                    *
+ * @param mining_time: The mining time distribution of every replication.               *
+ * @param first_seed: The seed of the first replication.                                *
+ * @param results: Receives the state fractions of each replication, in seed order.     *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void run_lane_replications(uint16_t num_trucks,
+                           uint16_t num_stations,
+                           const MiningTimeDistribution& mining_time,
+                           uint32_t first_seed,
+                           std::span<StateFractions> results) {
+
+    for(size_t first = 0; first < results.size(); first += REPLICATION_LANES) {
+
+        LaneSimulation sim(num_trucks, num_stations,
+                           first_seed + static_cast<uint32_t>(first), mining_time);
+
+        sim.simulate();
+
+        size_t lanes = std::min<size_t>(REPLICATION_LANES, results.size() - first);
+
+        for(size_t l = 0; l < lanes; l++) {
+            results[first + l] = sim.get_state_fractions(l);
+        }
+    }
+}
+
+/****************************************************************************************
+ * benchmark_lanes                                                                      *
+ * @brief Measures the throughput of running LANE_REPLICATIONS replications one after   *
+ *        the other with `Simulation` and REPLICATION_LANES at a time with              *
+ *        `LaneSimulation`.                                                             *
+ *                                                                                      *
+ * @param num_trucks: The number of trucks in every replication.                        *
+ * @param num_stations: The number of stations in every replication.                    *
+ * @return: LaneReport - The replication rate of both engines.                          *
+ * @throws: std::runtime_error if a lane does not produce the scalar engine's results.  *
+ ****************************************************************************************/
+LaneReport benchmark_lanes(uint16_t num_trucks, uint16_t num_stations) {
+
+    LaneReport report = {num_trucks, num_stations, LANE_REPLICATIONS, 0.0, 0.0};
+    uint32_t first_seed = std::random_device{}();
+
+    std::vector<StateFractions> scalar(LANE_REPLICATIONS);
+    std::vector<StateFractions> lanes(LANE_REPLICATIONS);
+
+    /* Runs one engine over every replication, in seconds                               */
+    auto run = [](auto&& engine) {
+
+        auto start = std::chrono::steady_clock::now();
+        engine();
+        auto end = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double>(end - start).count();
+    };
+
+    report.scalar_rate = LANE_REPLICATIONS / run([&]() {
+        for(size_t i = 0; i < scalar.size(); i++) {
+
+            Simulation sim(num_trucks, num_stations, false,
+                           UniformMiningTime(ONE_HOUR, FIVE_HOUR),
+                           first_seed + static_cast<uint32_t>(i));
+
+            sim.simulate();
+            scalar[i] = sim.get_state_fractions();
+        }
+    });
+
+    report.lane_rate = LANE_REPLICATIONS / run([&]() {
+        run_lane_replications(num_trucks, num_stations,
+                              UniformMiningTime(ONE_HOUR, FIVE_HOUR), first_seed, lanes);
+    });
+
+    /* Both engines ran the same seeds, so every replication has to agree               */
+    for(size_t i = 0; i < scalar.size(); i++) {
+
+        if(scalar[i].waiting != lanes[i].waiting ||
+           scalar[i].unloading != lanes[i].unloading ||
+           scalar[i].traveling != lanes[i].traveling ||
+           scalar[i].mining != lanes[i].mining) {
+            throw std::runtime_error("A replication of the vectorized engine diverged "
+                                     "from the scalar one");
+        }
+    }
+
+    return report;
+}
+
+/****************************************************************************************
+ * log_lane_report                                                                      *
+ * @brief Outputs the result of `benchmark_lanes` to the console.                       *
+ *                                                                                      *
+ * @param report: The benchmark result to print.                                        *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void log_lane_report(const LaneReport& report) {
+
+    std::cout << "Replication lanes over " << report.replications << " replications of "
+    << report.num_trucks << " trucks and " << report.num_stations << " stations"
+    << std::endl;
+    std::cout << "One at a time: " << report.scalar_rate << " replications/s"
+    << std::endl;
+    std::cout << REPLICATION_LANES << " lanes: " << report.lane_rate << " replications/s"
+    << std::endl;
+    std::cout << std::endl;
+}
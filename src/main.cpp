@@ -6,9 +6,59 @@
 #include "../include/testing.hpp"
 #endif
 
-/* Mersenne Twister and pyseudorandom number generator and a uniform distribution       */
-static std::mt19937 gen(std::random_device{}());
-static std::uniform_int_distribution<> rmt(ONE_HOUR, FIVE_HOUR);
+#ifndef ANALYTIC_HPP
+#include "../include/analytic.hpp"
+#endif
+
+#ifndef STEADY_STATE_HPP
+#include "../include/steady_state.hpp"
+#endif
+
+#ifndef PARALLEL_HPP
+#include "../include/parallel.hpp"
+#endif
+
+#ifndef NUMA_HPP
+#include "../include/numa.hpp"
+#endif
+
+#ifndef REPLICATION_HPP
+#include "../include/replication.hpp"
+#endif
+
+#ifndef TOPOLOGY_HPP
+#include "../include/topology.hpp"
+#endif
+
+#ifndef COHORT_HPP
+#include "../include/cohort.hpp"
+#endif
+
+#ifndef BLOCKING_HPP
+#include "../include/blocking.hpp"
+#endif
+
+#ifndef CONSERVATIVE_HPP
+#include "../include/conservative.hpp"
+#endif
+
+#ifndef LANES_HPP
+#include "../include/lanes.hpp"
+#endif
+
+#ifndef PROCESS_HPP
+#include "../include/process.hpp"
+#endif
+
+#ifndef BAYS_HPP
+#include "../include/bays.hpp"
+#endif
+
+#ifndef OUTAGES_HPP
+#include "../include/outages.hpp"
+#endif
+
+#include <fstream>
 
 /****************************************************************************************
  * Station Constructor                                                                  *
@@ -17,7 +67,7 @@ static std::uniform_int_distribution<> rmt(ONE_HOUR, FIVE_HOUR);
  * The constructor initializes the station's queue and the number of trucks             *
  * unloaded to zero.                                                                    *
  ****************************************************************************************/
-Station::Station() : queue(0), num_trucks_unloaded(0) {}
+Station::Station() : empty_tick(0), num_trucks_unloaded(0) {}
 
 /****************************************************************************************
  * ~Station                                                                             *
@@ -51,56 +101,69 @@ void Station::logging() {
  * get_queue                                                                            *
  * @brief Retrieves the current number of trucks in the station's queue.                *
  *                                                                                      *
- * This function returns the current value of the station's queue, which represents     *
- * the number of trucks waiting at the station.                                         *
+ * This function returns the number of trucks waiting at the station at the given       *
+ * tick. Every tick one truck is unloaded, so the queue is the number of ticks left     *
+ * until it runs empty, or zero once it has.                                            *
  *                                                                                      *
- * @param: None                                                                         *
+ * @param tick: The number of ticks the simulation has run.                             *
  * @return: uint16_t - The number of trucks currently in the station's queue.           *
  ****************************************************************************************/
-uint16_t Station::get_queue() {
-    return this->queue;
+uint16_t Station::get_queue(uint32_t tick) {
+    return static_cast<uint16_t>((this->empty_tick > tick) ? this->empty_tick - tick : 0);
 }
 
 /****************************************************************************************
  * increment_queue                                                                      *
  * @brief Increases the station's queue count by one.                                   *
  *                                                                                      *
- * This function increments the `queue` variable by one, representing the arrival of    *
- * a new truck at the station.                                                          *
+ * This function pushes the tick at which the queue runs empty back by one tick,        *
+ * representing the arrival of a new truck at the station. If the queue has already     *
+ * run empty, the new truck's turn starts at the given tick.                            *
  *                                                                                      *
- * @param: None                                                                         *
+ * @param tick: The number of ticks the simulation has run.                             *
  * @return: None                                                                        *
  ****************************************************************************************/
-void Station::increment_queue() {
-    this->queue++;
+void Station::increment_queue(uint32_t tick) {
+    this->empty_tick = std::max(this->empty_tick, tick) + 1;
 }
 
 /****************************************************************************************
- * decrement_queue                                                                      *
- * @brief Decreases the station's queue count by one, ensuring it doesn't go below zero.*
+ * increment_trucks_unloaded                                                            *
+ * @brief Increments the count of trucks that have been unloaded at the station.        *
  *                                                                                      *
- * This function decrements the `queue` variable by one, representing the departure of  *
- * a truck from the station. If the queue is already at zero, it remains unchanged.     *
+ * This function increments the `num_trucks_unloaded` variable by one, representing     *
+ * another truck that has successfully unloaded at the station.                         *
  *                                                                                      *
  * @param: None                                                                         *
  * @return: None                                                                        *
  ****************************************************************************************/
-void Station::decrement_queue() {
-    this->queue -= (this->queue > 0);
+void Station::increment_trucks_unloaded() {
+    this->num_trucks_unloaded++;
 }
 
 /****************************************************************************************
- * increment_trucks_unloaded                                                            *
- * @brief Increments the count of trucks that have been unloaded at the station.        *
+ * get_trucks_unloaded                                                                  *
+ * @brief Retrieves the count of trucks that have been unloaded at the station.         *
  *                                                                                      *
- * This function increments the `num_trucks_unloaded` variable by one, representing     *
- * another truck that has successfully unloaded at the station.                         *
+ * @param: None                                                                         *
+ * @return: uint16_t - The number of trucks unloaded.                                   *
+ ****************************************************************************************/
+uint16_t Station::get_trucks_unloaded() {
+    return this->num_trucks_unloaded;
+}
+
+/****************************************************************************************
+ * reset_trucks_unloaded                                                                *
+ * @brief Resets the count of trucks that have been unloaded at the station.            *
+ *                                                                                      *
+ * Used to discard the statistics gathered during the warm-up of a simulation. The      *
+ * queue is left untouched since it is part of the simulation's state.                  *
  *                                                                                      *
  * @param: None                                                                         *
  * @return: None                                                                        *
  ****************************************************************************************/
-void Station::increment_trucks_unloaded() {
-    this->num_trucks_unloaded++;
+void Station::reset_trucks_unloaded() {
+    this->num_trucks_unloaded = 0;
 }
 
 /****************************************************************************************
@@ -117,17 +180,19 @@ void Station::increment_trucks_unloaded() {
  *   Unloading, Waiting) during the simulation.                                         *
  * - `station_idx`: Initialized to 0, used to track which station the truck             *
  *    is unloading/queued at.                                                           *
- * - `timer`: This value is initialized by drawing a random time duration from          *
- *   a uniform distribution between 1 and 5 hours with a scaling of 5 mins/bit          *
- *   using the `rmt` distribution and `gen` random number generator.                    *
+ * - `timer`: Initialized to the first mining time, which the owning simulation         *
+ *   draws from its mining time distribution.                                           *
+ * - `mine_idx`: The mine site the truck works at, only used with several sites.        *
  *                                                                                      *
- * @param: None                                                                         *
+ * @param mining_time: The number of ticks the truck spends in its first Mining state.  *
+ * @param mine_idx: Optional index of the truck's mine site, defaults to the only one.  *
  * @return: None                                                                        *
  ****************************************************************************************/
-Truck::Truck() : state(TruckState::Mining),
-                    total_time(0),
-                    station_idx(0),
-                    timer(rmt(gen)) {}
+Truck::Truck(uint16_t mining_time, uint16_t mine_idx) : state(TruckState::Mining),
+                                                        timer(mining_time),
+                                                        mine_idx(mine_idx),
+                                                        total_time(0),
+                                                        station_idx(0) {}
 
 /****************************************************************************************
  * ~Truck                                                                               *
@@ -178,136 +243,6 @@ void Truck::logging(uint16_t total_sim_time) {
     << "%" << std::endl << std::endl;
 }
 
-/****************************************************************************************
- * run                                                                                  *
- * @brief Simulates the operations of a truck as it transitions through                 *
- *        different states (Mining, Traveling, Waiting, Unloading).                     *
- *                                                                                      *
- * This function updates the state of the truck based on its current activity           *
- * (e.g., mining, traveling to a station, waiting at a station, or unloading).          *
- * The truck's state and timers are adjusted accordingly, with each state               *
- * decrementing its associated timer and updating the truck's cumulative time           *
- * (`total_time`) using predefined bitwise increments.                                  *
- *                                                                                      *
- * The truck can transition between the following states:                               *
- * - `Mining`: Decrements mining time and switches to traveling to a station            *
- *   when mining is complete.                                                           *
- * - `TravelStation`: Decrements travel time to the station and determines              *
- *   whether the truck should wait or unload upon arrival.                              *
- * - `Waiting`: Decrements the waiting time before the truck can begin unloading.       *
- * - `Unloading`: Increments unloading time, updates the station's unloaded             *
- *   truck count, and then transitions back to traveling towards the mining             *
- *   area.                                                                              *
- * - `TravelMining`: Decrements travel time to the mining area, then returns            *
- *   the truck to the mining state.                                                     *
- *                                                                                      *
- * The function also manages the station queue by updating the queue count              *
- * when a truck arrives and increments the number of trucks unloaded after              *
- * unloading.                                                                           *
- *                                                                                      *
- * @param stations: A reference to a vector of Station objects, which represent         *
- *                  the stations where trucks can wait and unload.                      *
- * @param curr_idx: A reference to the current index in the stations vector,            *
- *                  used to track which station the truck is interacting with.          *
- *                                                                                      *
- * @return: None                                                                        *
- * @throws: std::runtime_error if an unexpected state is encountered.                   *
- ****************************************************************************************/
-void Truck::run(std::vector<Station>& stations, size_t& curr_idx) {
-
-    if(TruckState::Mining == this->state) {
-
-        /* Decrement the remaining mining time and increment the total                  */
-        this->timer--;
-        this->total_time += MINING_INC;
-        
-        /* Once the truck has finished mining, proceed back to the unloading station    */
-        if(this->timer == 0) {
-            
-            /* Set the travel time                                                      */
-            this->timer = TRAVEL_TIME;
-
-            /* Proceed to the TravelStation State                                       */
-            this->state = TruckState::TravelStation;
-        }
-    }
-    else if(TruckState::TravelStation == this->state) {
-
-        /* Decrement the remaining travel time to the station and increment the total   */
-        this->timer--;
-        this->total_time += TRAVELING_INC;
-
-        /* Once the truck has arrived, determine whether to wait or unload              */
-        if(this->timer == 0) {
-
-            /* Keep track of this station's index for when we have finished unloading   */
-            this->station_idx = curr_idx;
-            
-            /* Set the wait time to the number of the trucks queued ahead of this truck */
-            this->timer = stations[curr_idx].get_queue();
-
-            /* Add this truck to the station's queue and move the index to the next     *
-             * station, which will have the lowest wait time (See the Shortest Wait     *
-             * Time Allocation strategy in the Notes section of the header file)        */
-            stations[curr_idx++].increment_queue();
-            curr_idx %= stations.size();
-
-            /* If there are trucks ahead of this one proceed to the Waiting State.      *
-             * Otherwise proceed to the Unloading state                                 */
-            this->state = (this->timer) ? TruckState::Waiting : TruckState::Unloading;
-        }
-    }
-    else if(TruckState::Waiting == this->state) { 
-
-        /* Decrement the remaining waiting time in the queue and increment the total    */
-        this->timer--;
-        this->total_time += WAITING_INC;
-
-        /* Once the queue is empty, the truck will start to be unloaded                 */
-        if(this->timer == 0) {
-
-            /* Proceed to the Unloading State                                           */
-            this->state = TruckState::Unloading;
-        }
-    }
-    else if(TruckState::Unloading == this->state) {
-
-        /* Increment the total, there is no timer since the truck only takes one loop   * 
-         * i.e. 5 minutes to unload                                                     */
-        this->total_time += UNLOADING_INC;
-
-        /* Once the unloading has completed, then increment the Station's trucks        *
-         * unloaded count                                                               */
-        stations[this->station_idx].increment_trucks_unloaded();
-
-        /* Set the timer to the travel time to the mines                                */
-        this->timer = TRAVEL_TIME;
-
-        /* Proceed to the TravelMining State                                            */
-        this->state = TruckState::TravelMining;
-    }
-    else if(TruckState::TravelMining == this->state) {
-
-        /* Decrement the remaining mining time and increment the total                  */
-        this->timer--;
-        this->total_time += TRAVELING_INC;
-
-        /* Once the truck has arrived, calculate the time it will take to mine          */
-        if(this->timer == 0) {
-            
-            /* Use the global RNG to determine the time that the truck will be mining   */
-            this->timer = rmt(gen);
-
-            /* Proceed to the Mining State                                              */
-            this->state = TruckState::Mining;
-        }
-    }        
-    else {
-        /* This state should not be reached                                             */
-        throw std::runtime_error("Error Occured, this state should not be reached");
-    }
-}
-
 /****************************************************************************************
  * get_total_time                                                                       *
  * @brief Retrieves the total recorded time the truck has spent across all states.      *
@@ -324,29 +259,114 @@ uint64_t Truck::get_total_time() {
     return this->total_time;
 }
 
+/****************************************************************************************
+ * get_state                                                                            *
+ * @brief Retrieves the state the truck is currently in.                                *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: TruckState - The truck's current state.                                     *
+ ****************************************************************************************/
+TruckState Truck::get_state() {
+    return this->state;
+}
+
+/****************************************************************************************
+ * get_station_idx                                                                      *
+ * @brief Retrieves the station the truck is heading to, queued at or last unloaded at. *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: size_t - The index of the station.                                          *
+ ****************************************************************************************/
+size_t Truck::get_station_idx() {
+    return this->station_idx;
+}
+
+/****************************************************************************************
+ * get_mine_idx                                                                         *
+ * @brief Retrieves the mine site the truck works at.                                   *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: uint16_t - The index of the mine site.                                      *
+ ****************************************************************************************/
+uint16_t Truck::get_mine_idx() {
+    return this->mine_idx;
+}
+
+/****************************************************************************************
+ * reset_total_time                                                                     *
+ * @brief Clears the time recorded in every category.                                   *
+ *                                                                                      *
+ * Used to discard the statistics gathered during the warm-up of a simulation. The      *
+ * truck's state and timer are left untouched, so it carries on where it was.           *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void Truck::reset_total_time() {
+    this->total_time = 0;
+}
+
+/****************************************************************************************
+ * FixedHorizon Constructor                                                             *
+ * @brief Initializes the observer with the number of ticks to run.                     *
+ *                                                                                      *
+ * @param ticks: The number of ticks the simulation runs for.                           *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+FixedHorizon::FixedHorizon(size_t ticks) : remaining(ticks) {}
+
 /****************************************************************************************
  * Simulation Constructor                                                               *
  * @brief Initializes a Simulation object with a specified number of trucks and         *
  *        stations, and sets up the initial simulation parameters.                      *
  *                                                                                      *
  * This constructor initializes the Simulation with a specified number of trucks and    *
- * stations. It also sets the initial station index and the total simulation time.      *
- * Optionally, debugging mode can be enabled to perform additional checks during the    *
- * simulation.                                                                          *
+ * stations. It also sets up the station selection policy and the total simulation      *
+ * time. Optionally, debugging mode can be enabled to perform additional checks         *
+ * during the simulation.                                                               *
  *                                                                                      *
  * @param num_trucks: The number of trucks to be simulated.                             *
  * @param num_stations: The number of stations available in the simulation.             *
  * @param debug: Optional parameter that enables debug mode if set to true. Debug mode  *
  *               performs additional consistency checks during the simulation.          *
+ * @param mining_time: Optional distribution of mining times, defaults to the uniform   *
+ *                     distribution between the site's mining time bounds.              *
+ * @param seed: Optional seed of the simulation's random number generator, defaults     *
+ *              to a non-deterministic seed.                                            *
+ * @param memory: Optional resource the trucks and stations are stored in, e.g. an      *
+ *                arena reused across replications, or a FirstTouchResource to place    *
+ *                the trucks on the NUMA nodes of the workers that run them.            *
+ * @param site: Optional site the simulation runs at, defaults to the standard site.    *
+ * @param selection: Optional station selection policy, defaults to round robin.        *
  * @return: None                                                                        *
+ * @throws: std::invalid_argument if the site is invalid.                               *
  ****************************************************************************************/
 Simulation::Simulation( uint16_t num_trucks, 
                         uint16_t num_stations, 
-                        bool debug) : trucks(num_trucks), 
-                                      stations(num_stations),
-                                      curr_station_idx(0),  
-                                      debug(debug),  
-                                      total_time(MAX_TIME)  {}
+                        bool debug,
+                        std::optional<MiningTimeDistribution> mining_time,
+                        uint32_t seed,
+                        std::pmr::memory_resource* memory,
+                        const SiteConfig& site,
+                        SelectionPolicy selection)
+                        : selector(make_selector(selection, memory, site.travel_time)),
+                          tick(0),
+                          total_time(site.max_time),
+                          debug(debug),
+                          stations(memory),
+                          trucks(memory),
+                          mining_time(mining_time ? std::move(*mining_time)
+                                                  : site_mining_time(site)),
+                          gen(seed),
+                          site(site),
+                          transitions(make_truck_transitions(site)),
+                          warmup_time(0) {
+
+    validate_site(site);
+
+    /* Set up the stations and trucks the same way a later reset does                   */
+    this->reset(seed, num_trucks, num_stations);
+}
 
 /****************************************************************************************
  * ~Simulation                                                                          *
@@ -361,6 +381,35 @@ Simulation::Simulation( uint16_t num_trucks,
  ****************************************************************************************/
 Simulation::~Simulation() {}
 
+/****************************************************************************************
+ * storage_bytes                                                                        *
+ * @brief Computes the memory a simulation allocates from its memory resource.          *
+ *                                                                                      *
+ * The stations and trucks are each allocated once, at their exact size, and so is the  *
+ * selector's state, so an arena of this size holds a whole simulation without going    *
+ * back to its upstream resource.                                                       *
+ *                                                                                      *
+ * @param num_trucks: The number of trucks to be simulated.                             *
+ * @param num_stations: The number of stations available in the simulation.             *
+ * @param selection: The station selection policy of the simulation.                    *
+ * @return: size_t - The bytes needed, including the worst case alignment padding.      *
+ ****************************************************************************************/
+size_t Simulation::storage_bytes(uint16_t num_trucks, uint16_t num_stations,
+                                 SelectionPolicy selection) {
+
+    size_t selector_bytes = 0;
+
+    if(SelectionPolicy::ShortestQueue == selection) {
+        selector_bytes = ShortestQueueSelector::storage_bytes(num_stations);
+    }
+    else if(SelectionPolicy::ShortestWait == selection) {
+        selector_bytes = ShortestWaitSelector::storage_bytes(num_stations);
+    }
+
+    return num_trucks * sizeof(Truck) + alignof(Truck) +
+           num_stations * sizeof(Station) + alignof(Station) + selector_bytes;
+}
+
 /****************************************************************************************
  * run_sim                                                                              *
  * @brief Executes the simulation, running all trucks through their respective states   *
@@ -373,11 +422,11 @@ Simulation::~Simulation() {}
  *    various states (Mining, Traveling, Waiting, Unloading).                           *
  *                                                                                      *
  * 3. If debugging mode is enabled, consistency checks are performed after each truck   *
- *    runs, ensuring the current station index matches the station with the minimum     *
- *    queue size.                                                                       *
+ *    runs, ensuring the station the selection policy picks next is the station with    *
+ *    the minimum queue size.                                                           *
  *                                                                                      *
- * 4. After processing all trucks, decrements the queue count for each station,         *
- *    ensuring that no queue falls below zero.                                          *
+ * 4. After processing all trucks, moves the tick on, which shortens the queue of       *
+ *    every station by one without touching the stations (see `Station`).               *
  *                                                                                      *
  * 5. Decrements the simulation time and repeats until the simulation time reaches zero.*
  *                                                                                      *
@@ -392,44 +441,276 @@ Simulation::~Simulation() {}
  ****************************************************************************************/
 void Simulation::run_sim() {
 
-    /* Initialize a local variable with the max sim time                                */
-    size_t sim_time = this->total_time;
+    /* Run the tick loop                                                                */
+    this->simulate();
 
-    while(sim_time) {
+    /* Perform logging                                                                  */
+    this->logging();
+}
+
+/****************************************************************************************
+ * logging                                                                              *
+ * @brief Logs the operational statistics of every truck and station.                   *
+ *                                                                                      *
+ * If debugging mode is enabled, additional checks are performed to verify that the     *
+ * total time recorded for each truck matches the total simulation time.                *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void Simulation::logging() {
 
-        /* Run through all the trucks                                                   */
-        for(auto& truck: trucks) {
+    select_checks(this->debug, [this](auto checks) {
+        for(auto& truck : trucks) {
 
-            truck.run(stations, curr_station_idx);
+            truck.logging(this->total_time);
 
-            if(this->debug) {
-                compare_idx_val_to_actual_min(stations, curr_station_idx);
-            }
+            checks.check_total_time(truck, this->total_time);
         }
+    });
+    for(auto& station : stations) {
+        station.logging();
+    }
+}
+
+/****************************************************************************************
+ * simulate                                                                             *
+ * @brief Runs the tick loop of the simulation without logging the results.             *
+ *                                                                                      *
+ * This is the part of `run_sim` that advances the trucks and stations. It is used on   *
+ * its own when the results are consumed programmatically, e.g. when comparing the      *
+ * simulation against the analytic estimate.                                            *
+ *                                                                                      *
+ * If a warm-up is set, the simulation first runs for that many ticks and then resets   *
+ * its statistics, so the results only cover the following `total_time` ticks.          *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void Simulation::simulate() {
+
+    /* Run through the warm-up first and discard what was recorded during it            */
+    if(this->warmup_time) {
 
-        /* Decrement all the queues for each station if the queue is greater than zero  */
-        std::for_each(stations.begin(), stations.end(), [](Station& station) {
-            station.decrement_queue();
-        });
+        FixedHorizon warmup(this->warmup_time);
 
-        /* Decrement the counter, each step represents 5 minutes                        */
-        sim_time--;
+        this->simulate(warmup);
+        this->reset_statistics();
     }
 
-    /* Perform logging                                                                  */
-    for(auto& truck : trucks) {
+    /* Run for the total simulation time                                                */
+    FixedHorizon horizon(this->total_time);
 
-        truck.logging(MAX_TIME);
+    this->simulate(horizon);
+}
 
-        if(this->debug) {
-            compare_total_time_to_max_time(truck, MAX_TIME);
+/****************************************************************************************
+ * reset                                                                                *
+ * @brief Puts the simulation back to its initial state for a new replication,          *
+ *        reusing the storage of the current one.                                       *
+ *                                                                                      *
+ * Clearing a vector keeps its capacity, so the stations are refilled and the trucks    *
+ * re-emplaced in place. The stations are refilled with one store per station. The      *
+ * trucks are set up in a single pass that draws their first mining times in order,     *
+ * after the distribution has dropped whatever it kept from the last run, which keeps   *
+ * the results identical to those of a fresh Simulation.                                *
+ *                                                                                      *
+ * @param seed: The seed of the new replication.                                        *
+ * @param num_trucks: The number of trucks to be simulated.                             *
+ * @param num_stations: The number of stations available in the simulation.             *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void Simulation::reset(uint32_t seed, uint16_t num_trucks, uint16_t num_stations) {
+
+    this->gen.seed(seed);
+    this->tick = 0;
+
+    std::visit([seed, num_stations](auto& selector) {
+        selector.reset(num_stations, seed);
+    }, this->selector);
+
+    /* Drop the value the lognormal distribution keeps from the previous run            */
+    std::visit([](auto& dist) {
+        dist.reset();
+    }, this->mining_time);
+
+    /* Only grows the storage, and then to the exact size, see storage_bytes            */
+    this->stations.assign(num_stations, Station());
+
+    this->trucks.clear();
+    this->trucks.reserve(num_trucks);
+
+    /* Every truck starts out mining, draw its first mining time from the distribution  */
+    std::visit([this, num_trucks](auto& dist) {
+        for(uint16_t i = 0; i < num_trucks; i++) {
+            this->trucks.emplace_back(dist(this->gen));
         }
+    }, this->mining_time);
+}
+
+/****************************************************************************************
+ * reset_statistics                                                                     *
+ * @brief Discards the time recorded by every truck and the unload count of every       *
+ *        station, without changing the state of the simulation.                        *
+ *                                                                                      *
+ * Every truck starts out mining with a freshly drawn timer, so the first hours of a    *
+ * simulation are a transient that biases the reported percentages. Resetting the       *
+ * statistics once that transient has passed leaves only steady state behavior in       *
+ * the results.                                                                         *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void Simulation::reset_statistics() {
+
+    for(auto& truck : trucks) {
+        truck.reset_total_time();
     }
     for(auto& station : stations) {
-        station.logging();
+        station.reset_trucks_unloaded();
+    }
+}
+
+/****************************************************************************************
+ * leap                                                                                 *
+ * @brief Advances the trucks and the stations by several ticks at once, none of which  *
+ *        expire a truck's timer.                                                       *
+ *                                                                                      *
+ * @param ticks: The number of ticks, less than the ticks left of every truck.          *
+ * @param transitions: The state machine of the site, see `make_truck_transitions`.     *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void Simulation::leap(uint16_t ticks, const TruckTransitionTable& transitions) {
+
+    for(auto& truck : trucks) {
+        truck.leap(ticks, transitions);
+    }
+
+    /* The queues move on with the tick, as they do after every tick of the loop        */
+    this->tick += ticks;
+}
+
+/****************************************************************************************
+ * get_next_expiry                                                                      *
+ * @brief Retrieves the number of ticks until the first truck's timer expires.          *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: uint16_t - The fewest ticks left of any truck, UINT16_MAX without trucks.   *
+ ****************************************************************************************/
+uint16_t Simulation::get_next_expiry() {
+
+    uint16_t next_expiry = UINT16_MAX;
+
+    for(auto& truck : trucks) {
+        next_expiry = std::min(next_expiry, truck.get_ticks_left());
+    }
+    return next_expiry;
+}
+
+/****************************************************************************************
+ * get_state_fractions                                                                  *
+ * @brief Computes the fraction of time the fleet spent in each category.               *
+ *                                                                                      *
+ * Unpacks the time recorded by every truck and averages it across the fleet,           *
+ * relative to the total simulation time.                                               *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: StateFractions - The fleet-wide fraction of time spent in each category.    *
+ ****************************************************************************************/
+StateFractions Simulation::get_state_fractions() {
+    return fleet_state_fractions(this->trucks, this->total_time);
+}
+
+/****************************************************************************************
+ * set_warmup_time                                                                      *
+ * @brief Sets the number of ticks run before `total_time` whose statistics are         *
+ *        discarded.                                                                    *
+ *                                                                                      *
+ * @param ticks: The warm-up in ticks, 0 for none.                                      *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void Simulation::set_warmup_time(uint16_t ticks) {
+    this->warmup_time = ticks;
+}
+
+/****************************************************************************************
+ * get_warmup_time                                                                      *
+ * @brief Retrieves the number of ticks run before `total_time` whose statistics are    *
+ *        discarded.                                                                    *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: uint16_t - The warm-up in ticks, 0 for none.                                *
+ ****************************************************************************************/
+uint16_t Simulation::get_warmup_time() const {
+    return this->warmup_time;
+}
+
+/****************************************************************************************
+ * fleet_state_fractions                                                                *
+ * @brief Computes the fraction of time a fleet spent in each category.                 *
+ *                                                                                      *
+ * Unpacks the time recorded by every truck and averages it across the fleet,           *
+ * relative to the time the statistics were recorded over.                              *
+ *                                                                                      *
+ * @param trucks: The trucks of the fleet.                                              *
+ * @param total_time: The ticks the statistics were recorded over.                      *
+ * @return: StateFractions - The fleet-wide fraction of time spent in each category.    *
+ ****************************************************************************************/
+StateFractions fleet_state_fractions(std::pmr::vector<Truck>& trucks,
+                                     uint16_t total_time) {
+
+    StateFractions fractions = {0.0, 0.0, 0.0, 0.0};
+
+    for(auto& truck : trucks) {
+
+        uint64_t time = truck.get_total_time();
+
+        fractions.waiting   += RETRIEVE_TIME(time, WAITING_MASK, 0);
+        fractions.unloading += RETRIEVE_TIME(time, UNLOADING_MASK, 16);
+        fractions.traveling += RETRIEVE_TIME(time, TRAVELING_MASK, 32);
+        fractions.mining    += RETRIEVE_TIME(time, MINING_MASK, 48);
+    }
+
+    /* Normalize by the time available to the whole fleet                               */
+    double fleet_time = static_cast<double>(total_time) * trucks.size();
+
+    fractions.waiting   /= fleet_time;
+    fractions.unloading /= fleet_time;
+    fractions.traveling /= fleet_time;
+    fractions.mining    /= fleet_time;
+
+    return fractions;
+}
+
+/****************************************************************************************
+ * validate_site                                                                        *
+ * @brief Verifies that a site can be simulated.                                        *
+ *                                                                                      *
+ * @param site: The site to verify.                                                     *
+ * @return: None                                                                        *
+ * @throws: std::invalid_argument if the travel time or the horizon is zero.            *
+ ****************************************************************************************/
+void validate_site(const SiteConfig& site) {
+
+    if(!site.travel_time || !site.max_time) {
+        throw std::invalid_argument("A site needs a travel time and a horizon of at "
+                                    "least one tick");
     }
 }
 
+/****************************************************************************************
+ * site_mining_time                                                                     *
+ * @brief Creates the default mining time distribution of a site.                       *
+ *                                                                                      *
+ * @param site: The site whose mining time bounds are used.                             *
+ * @return: MiningTimeDistribution - The uniform distribution between the site's        *
+ *                                   bounds.                                            *
+ * @throws: std::invalid_argument if the bounds are empty or contain zero.              *
+ ****************************************************************************************/
+MiningTimeDistribution site_mining_time(const SiteConfig& site) {
+    return UniformMiningTime(site.min_mining_time, site.max_mining_time);
+}
+
 /****************************************************************************************
  * get_command_line_input                                                               *
  * @brief Prompts the user to enter a value between 1 and 65535, validates the input,   *
@@ -472,6 +753,49 @@ static void get_command_line_input(uint16_t& value, const std::string prompt) {
     std::cout << "Success" << std::endl;
 }
 
+/****************************************************************************************
+ * get_command_line_input                                                               *
+ * @brief Prompts the user to enter a value between 1 and 4294967295, validates the     *
+ *        input, and assigns it to the provided `uint32_t` reference.                   *
+ *                                                                                      *
+ * This function continuously prompts the user until a valid numeric input within the   *
+ * range of 1 to 4294967295 is entered. The input is validated to ensure it contains    *
+ * only digits and at most 10 of them, and is converted to an integer using             *
+ * `std::stoull`. If the input is valid, the value is assigned to the provided          *
+ * reference.                                                                           *
+ *                                                                                      *
+ * @param value: Reference to a `uint32_t` variable where the validated input will be   *
+ *               stored.                                                                *
+ * @param prompt: The message displayed to the user when prompting for input.           *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+static void get_command_line_input(uint32_t& value, const std::string prompt) {
+
+    std::string input;
+
+    while(true) {
+
+        std::cout << prompt;
+        std::getline(std::cin, input);
+
+        /* Check that all the characters are numeric, and few enough to convert */
+        if(!input.empty() && (input.size() <= 10) &&
+           std::find_if(input.begin(), input.end(), [](char c) {
+            return !(isdigit(c));
+            }) == input.end())
+        {
+            uint64_t num = std::stoull(input);
+
+            if((num > 0) && (num <= UINT32_MAX)) {
+                value = static_cast<uint32_t>(num);
+                break;
+            }
+        }
+        std::cout << "Invalid input" << std::endl;
+    }
+    std::cout << "Success" << std::endl;
+}
+
 /****************************************************************************************
  * get_command_line_input                                                               *
  * @brief Prompts the user to enter a value of 0 or 1, validates the input, and assigns *
@@ -517,6 +841,47 @@ static void get_command_line_input(bool& value, const std::string prompt) {
     std::cout << "Success" << std::endl;
 }
 
+/****************************************************************************************
+ * get_travel_times_input                                                               *
+ * @brief Prompts the user for a file of routes until one can be read as the travel     *
+ *        times between the given sites and stations.                                   *
+ *                                                                                      *
+ * See `read_travel_times` for the format of the file. Files that cannot be opened or   *
+ * read are reported and the user is prompted again.                                    *
+ *                                                                                      *
+ * @param num_mines: The number of mine sites.                                          *
+ * @param num_stations: The number of stations.                                         *
+ * @param prompt: The message displayed to the user when prompting for input.           *
+ * @return: TravelTimes - The travel times read from the file.                          *
+ ****************************************************************************************/
+static TravelTimes get_travel_times_input(uint16_t num_mines, uint16_t num_stations,
+                                          const std::string prompt) {
+
+    std::string input;
+
+    while(true) {
+
+        std::cout << prompt;
+        std::getline(std::cin, input);
+
+        std::ifstream file(input);
+
+        if(file) {
+            try {
+                TravelTimes travel_times = read_travel_times(file, num_mines,
+                                                             num_stations);
+
+                std::cout << "Success" << std::endl;
+                return travel_times;
+            }
+            catch(const std::exception& error) {
+                std::cout << error.what() << std::endl;
+            }
+        }
+        std::cout << "Invalid input" << std::endl;
+    }
+}
+
 /****************************************************************************************
  * prompt_to_continue                                                                   *
  * @brief Prompts the user to decide whether to run another simulation or exit the      *
@@ -561,32 +926,273 @@ bool prompt_to_continue() {
  *        simulations in a loop, based on user input.                                   *
  *                                                                                      *
  * The `main` function continuously prompts the user for input to configure the         *
- * simulation (number of trucks, number of stations, and debug mode). After setting     *
- * up the simulation, it runs the simulation and, upon completion, asks the user        *
- * if they would like to run another simulation. If the user chooses to exit, the       *
- * loop breaks and the program terminates.                                              *
+ * simulation (number of trucks, number of stations, debug mode, mine sites, bays per   *
+ * station, analytic mode, the horizon and the warm-up). After setting up the           *
+ * simulation, it runs the simulation for 72 hours or until it reaches steady state     *
+ * (or in analytic mode, the analytic estimate compared against the simulation, or      *
+ * with several mine sites, the 72 hour simulation of the sites, or with several bays   *
+ * per station, the 72 hour simulation of the bays and their outages, or with more      *
+ * than 65535 trucks, the 72 hour simulation of the fleet's cohorts) and, upon          *
+ * completion, asks the user if they would like to run another simulation. If the user  *
+ * chooses to exit, the loop breaks and the program terminates.                         *
  *                                                                                      *
- * @param: None                                                                         *
+ * A specified warm-up is run before the horizon and left out of the results. Without   *
+ * one, steady state mode detects the warm-up with MSER-5.                              *
+ *                                                                                      *
+ * Debug mode only adds correctness checks that take about as long as the simulation.   *
+ * The benchmarks, which run many simulations and heavily contended queues, only run    *
+ * after a multi-threaded simulation when the program is started with `--benchmark`.    *
+ *                                                                                      *
+ * @param argc: The number of command line arguments.                                   *
+ * @param argv: The command line arguments, `--benchmark` enables the benchmarks.       *
  * @return: int - Returns 0 upon successful completion of the program.                  *
  ****************************************************************************************/
-int main() {
+int main(int argc, char* argv[]) {
+
+    bool benchmark = false;
+
+    for(int i = 1; i < argc; i++) {
+        benchmark |= (std::string(argv[i]) == "--benchmark");
+    }
 
-    uint16_t num_trucks;
+    uint32_t num_trucks;
     uint16_t num_stations;
     bool debug;
+    bool analytic;
+    bool steady_state;
+    bool fixed_warmup;
+    uint16_t warmup_time;
+    uint16_t num_threads;
+    uint16_t num_mines;
+    uint16_t num_bays;
+    uint16_t max_unload;
+    bool outages;
+    uint16_t failures_per_day;
+    bool hold;
 
     while(true) {
 
         /* Get the values from user input                                               */
-        get_command_line_input(num_trucks, "Number of trucks: (1 - 65535) ");
+        get_command_line_input(num_trucks, "Number of trucks: (1 - 4294967295) ");
         get_command_line_input(num_stations, "Number of stations: (1 - 65535) ");
         get_command_line_input(debug, "Debug mode: (0: Debug Off, 1 : Debug On) ");
 
-        /* Populate the simulation                                                      */
-        Simulation mining_sim(num_trucks, num_stations, debug);
+        if(num_trucks > UINT16_MAX) {
+
+            /* Too many trucks to simulate one by one, simulate their cohorts instead   */
+            std::cout << "Simulating the fleet in cohorts" << std::endl;
+
+            CohortSimulation mining_sim(num_trucks, num_stations, debug);
 
-        /* Run the simulation                                                           */
-        mining_sim.run_sim();
+            mining_sim.simulate();
+            mining_sim.logging();
+
+            /* Ask the user if they want to run another simulation                      */
+            if(!prompt_to_continue()) {
+                break;
+            }
+            continue;
+        }
+        get_command_line_input(num_mines, "Mine sites: (1 - 65535) ");
+
+        if(num_mines > 1) {
+
+            /* Load the distances between the sites and the stations, then simulate     */
+            TravelTimes travel_times = get_travel_times_input(num_mines, num_stations,
+                                                              "Travel time file: ");
+
+            TopologySimulation mining_sim(num_trucks, std::move(travel_times), debug);
+
+            mining_sim.simulate();
+            mining_sim.logging();
+
+            /* Ask the user if they want to run another simulation                      */
+            if(!prompt_to_continue()) {
+                break;
+            }
+            continue;
+        }
+        get_command_line_input(num_bays, "Bays per station: (1 - 65535) ");
+
+        if(num_bays > 1) {
+
+            get_command_line_input(max_unload, "Longest unload: (1 - 65535) ");
+
+            /* Every station gets the same bays, unloading in 1 tick up to the longest  */
+            std::vector<BayConfig> configs(num_stations, {num_bays, 1, max_unload});
+
+            get_command_line_input(outages, "Station outages: (0: None, 1 : Random) ");
+
+            if(outages) {
+
+                get_command_line_input(failures_per_day,
+                                       "Failures per station per day: (1 - 65535) ");
+                get_command_line_input(hold, "Queued trucks: (0: Reroute, 1 : Hold) ");
+
+                /* Failed stations take 1 to 5 hours to repair, rerouting takes a trip  */
+                OutageConfig config = {{}, static_cast<double>(failures_per_day),
+                                       ONE_HOUR, FIVE_HOUR,
+                                       hold ? OutagePolicy::Hold : OutagePolicy::Reroute,
+                                       TRAVEL_TIME};
+
+                OutageSimulation mining_sim(num_trucks, configs, config, debug);
+
+                mining_sim.simulate();
+                mining_sim.logging();
+            }
+            else {
+
+                BaySimulation mining_sim(num_trucks, configs, debug);
+
+                mining_sim.simulate();
+                mining_sim.logging();
+            }
+
+            /* Ask the user if they want to run another simulation                      */
+            if(!prompt_to_continue()) {
+                break;
+            }
+            continue;
+        }
+
+        get_command_line_input(analytic, "Analytic mode: (0: Simulate, 1 : Estimate) ");
+
+        if(analytic) {
+
+            /* Estimate the results and report the error against a full simulation      */
+            ApproximationError error = compare_estimate_to_simulation(
+                num_trucks, num_stations, UniformMiningTime(ONE_HOUR, FIVE_HOUR),
+                std::random_device{}());
+
+            log_approximation_error(error);
+        }
+        else {
+
+            get_command_line_input(steady_state, "Horizon: (0: 72 Hours, 1 : Steady State) ");
+            get_command_line_input(fixed_warmup, steady_state
+                                                 ? "Warm-up: (0: Detect, 1 : Specify) "
+                                                 : "Warm-up: (0: None, 1 : Specify) ");
+
+            /* Without a specified warm-up, steady state mode detects one               */
+            warmup_time = 0;
+
+            if(fixed_warmup) {
+                get_command_line_input(warmup_time, "Warm-up ticks: (1 - 65535) ");
+            }
+
+            if(steady_state) {
+
+                /* Populate the simulation                                              */
+                Simulation mining_sim(num_trucks, num_stations, debug);
+                mining_sim.set_warmup_time(warmup_time);
+
+                /* Run until the results are within tolerance, then log them            */
+                SteadyStateReport report = run_until_steady(mining_sim,
+                                                            STEADY_STATE_EPSILON,
+                                                            UINT16_MAX);
+                mining_sim.logging();
+                log_steady_state_report(report);
+            }
+            else {
+
+                get_command_line_input(num_threads, "Threads: (1 - 65535) ");
+
+                /* Run the simulation, splitting the trucks across the threads          */
+                if(num_threads > 1) {
+
+                    /* The trucks are dealt out to the workers only, one per thread     */
+                    ThreadPool pool(num_threads, true);
+
+                    /* Populate the simulation, storing the trucks on the NUMA nodes of  *
+                     * the workers that run them                                        */
+                    FirstTouchResource first_touch(pool, sizeof(Truck));
+                    Simulation mining_sim(num_trucks, num_stations, debug,
+                                          UniformMiningTime(ONE_HOUR, FIVE_HOUR),
+                                          std::random_device{}(), &first_touch);
+                    mining_sim.set_warmup_time(warmup_time);
+
+                    /* Keep the serial tick loop's results, the windowed loop draws its  *
+                     * mining times per partition and is only benchmarked               */
+                    simulate_parallel(mining_sim, pool);
+                    mining_sim.logging();
+
+                    /* Check the arrival queue holds up under heavy contention, compare  *
+                     * the truck placements, the serial and blocked tick loops and the   *
+                     * per-tick and windowed parallel tick loops, see whether            *
+                     * replications are faster side by side and what writing the trucks  *
+                     * as coroutines costs                                              */
+                    if(benchmark) {
+                        log_contention_report(benchmark_arrival_queue(CONTENTION_THREADS,
+                                                                      CONTENTION_PUSHES));
+                        log_placement_report(benchmark_placement(num_trucks, num_stations,
+                                                                 pool));
+                        log_selection_report(benchmark_selectors(num_stations,
+                                                                 SELECTION_ASSIGNMENTS));
+                        log_blocking_report(benchmark_blocking(num_trucks, num_stations));
+                        log_conservative_report(benchmark_conservative(num_trucks,
+                                                                       num_stations, pool));
+                        log_lane_report(benchmark_lanes(num_trucks, num_stations));
+                        log_process_report(benchmark_processes(num_trucks,
+                                                               num_stations));
+                    }
+
+                    /* Also report the load balance and run the cheap correctness        *
+                     * checks                                                           */
+                    if(debug) {
+                        log_pool_metrics(pool);
+
+                        /* A reset has to reproduce a fresh run whatever state the       *
+                         * distribution keeps between draws                             */
+                        uint32_t seed = std::random_device{}();
+                        std::vector<double> histogram(FIVE_HOUR - ONE_HOUR + 1, 1.0);
+
+                        LognormalMiningTime lognormal(std::log(3.0 * ONE_HOUR), 0.5,
+                                                      ONE_HOUR, FIVE_HOUR);
+                        EmpiricalMiningTime empirical(histogram, ONE_HOUR);
+
+                        compare_reset_run_to_fresh_run(num_trucks, num_stations,
+                                                       lognormal, seed);
+                        compare_reset_run_to_fresh_run(num_trucks, num_stations,
+                                                       empirical, seed);
+
+                        /* Outages must follow their windows whatever the trucks do     */
+                        compare_outages_to_schedule(num_trucks, num_stations,
+                                                    OutagePolicy::Hold, seed);
+                        compare_outages_to_schedule(num_trucks, num_stations,
+                                                    OutagePolicy::Reroute, seed);
+
+                        /* Replications must not allocate once the arenas warmed up     */
+                        CountingResource counter;
+                        ReplicationRunner runner(pool, &counter);
+                        std::vector<StateFractions> results(2 * (pool.size() + 1));
+
+                        runner.run(num_trucks, num_stations, mining_sim.mining_time, 0,
+                                   results);
+                        counter.reset();
+                        runner.run(num_trucks, num_stations, mining_sim.mining_time,
+                                   results.size(), results);
+                        compare_allocations_to_zero(counter);
+
+                        /* Nor when the distribution has tables to copy                 */
+                        runner.run(num_trucks, num_stations, empirical, 0, results);
+                        counter.reset();
+                        runner.run(num_trucks, num_stations, empirical, results.size(),
+                                   results);
+                        compare_allocations_to_zero(counter);
+                    }
+                }
+                else {
+
+                    /* Populate the simulation                                          */
+                    Simulation mining_sim(num_trucks, num_stations, debug);
+                    mining_sim.set_warmup_time(warmup_time);
+
+                    /* Run the trucks through windows of ticks, see run_blocked_engine  */
+                    simulate_blocked(mining_sim);
+                    mining_sim.logging();
+                }
+            }
+        }
 
         /* Ask the user if they want to run another simulation                          */ 
         if (!prompt_to_continue()) {
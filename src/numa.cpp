@@ -0,0 +1,204 @@
+#ifndef NUMA_HPP
+#include "../include/numa.hpp"
+#endif
+
+#ifndef PARALLEL_HPP
+#include "../include/parallel.hpp"
+#endif
+
+#if defined(HAVE_LIBNUMA)
+#include <numa.h>
+#include <sched.h>
+#endif
+
+/****************************************************************************************
+ * FirstTouchResource Constructor                                                       *
+ * @brief Initializes the resource for storage of one kind of item.                     *
+ *                                                                                      *
+ * @param pool: The pool whose workers touch the storage.                               *
+ * @param item_size: The size in bytes of the items stored, e.g. sizeof(Truck).         *
+ * @param upstream: The resource the memory is allocated from.                          *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+FirstTouchResource::FirstTouchResource(ThreadPool& pool,
+                                       size_t item_size,
+                                       std::pmr::memory_resource* upstream)
+                                       : pool(pool),
+                                         item_size(std::max<size_t>(item_size, 1)),
+                                         upstream(upstream) {}
+
+/****************************************************************************************
+ * do_allocate                                                                          *
+ * @brief Allocates from upstream and touches every page of large allocations from the  *
+ *        worker that will use it.                                                      *
+ *                                                                                      *
+ * Large allocations are mapped fresh by the operating system, so none of their pages   *
+ * have been placed on a node yet. Each task writes one byte to every page that starts  *
+ * in its chunk, which places the page on the node of the worker running the task. The  *
+ * chunks are dealt out with `ThreadPool::parallel_for_static`, the same way the        *
+ * parallel engines deal out the trucks, so that worker is the one advancing them. With *
+ * libnuma the chunk is also bound to that node, so the placement holds even if the     *
+ * memory is later written to by another thread first.                                  *
+ *                                                                                      *
+ * @param bytes: The size of the allocation.                                            *
+ * @param alignment: The alignment of the allocation.                                   *
+ * @return: void* - The allocated memory.                                               *
+ ****************************************************************************************/
+void* FirstTouchResource::do_allocate(size_t bytes, size_t alignment) {
+
+    void* memory = this->upstream->allocate(bytes, alignment);
+
+    if(bytes < FIRST_TOUCH_MIN_BYTES) {
+        return memory;
+    }
+
+    unsigned char* base = static_cast<unsigned char*>(memory);
+    size_t num_items = bytes / this->item_size;
+
+    /* Touches the pages of one chunk from the worker the chunk maps to                  */
+    auto touch = [this, base, bytes, num_items](size_t first, size_t last) {
+
+        unsigned char* begin = base + first * this->item_size;
+        unsigned char* end = (last == num_items) ? base + bytes
+                                                 : base + last * this->item_size;
+
+        /* A page straddling two chunks belongs to the chunk it starts in, except        *
+         * for the first page of the allocation                                         */
+        size_t offset = reinterpret_cast<uintptr_t>(begin) % PAGE_SIZE;
+        unsigned char* page = (offset && first) ? begin + (PAGE_SIZE - offset) : begin;
+
+#if defined(HAVE_LIBNUMA)
+        if((numa_available() >= 0) && (page < end)) {
+
+            size_t page_offset = reinterpret_cast<uintptr_t>(page) % PAGE_SIZE;
+
+            numa_setlocal_memory(page - page_offset, (end - page) + page_offset);
+        }
+#endif
+
+        for(; page < end; page += PAGE_SIZE) {
+            *static_cast<volatile unsigned char*>(page) = 0;
+        }
+    };
+
+    this->pool.parallel_for_static(0, num_items, this->pool.grain_size(num_items), touch);
+
+    return memory;
+}
+
+/****************************************************************************************
+ * do_deallocate                                                                        *
+ * @brief Returns memory to upstream.                                                   *
+ *                                                                                      *
+ * @param p: The memory to return.                                                      *
+ * @param bytes: The size of the allocation.                                            *
+ * @param alignment: The alignment of the allocation.                                   *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void FirstTouchResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    this->upstream->deallocate(p, bytes, alignment);
+}
+
+/****************************************************************************************
+ * do_is_equal                                                                          *
+ * @brief Checks whether memory from one resource can be returned to the other.         *
+ *                                                                                      *
+ * @param other: The resource to compare against.                                       *
+ * @return: bool - True only for the same resource.                                     *
+ ****************************************************************************************/
+bool FirstTouchResource::do_is_equal(const std::pmr::memory_resource& other) const
+                                                                            noexcept {
+    return this == &other;
+}
+
+/****************************************************************************************
+ * current_numa_node                                                                    *
+ * @brief Retrieves the NUMA node of the CPU the calling thread is running on.          *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: int - The node, always 0 without HAVE_LIBNUMA.                              *
+ ****************************************************************************************/
+int current_numa_node() {
+
+#if defined(HAVE_LIBNUMA)
+    if(numa_available() >= 0) {
+        return std::max(numa_node_of_cpu(sched_getcpu()), 0);
+    }
+#endif
+
+    return 0;
+}
+
+/****************************************************************************************
+ * benchmark_placement                                                                  *
+ * @brief Measures the throughput of a parallel simulation with its trucks placed by    *
+ *        the constructing thread, and with them placed by first touch.                 *
+ *                                                                                      *
+ * Only the trucks are placed by first touch, see `FirstTouchResource`.                 *
+ *                                                                                      *
+ * @param num_trucks: The number of trucks in the simulation.                           *
+ * @param num_stations: The number of stations in the simulation.                       *
+ * @param pool: The pool running both simulations, its workers should be pinned.        *
+ * @return: PlacementReport - The throughput of both runs and of each node.             *
+ ****************************************************************************************/
+PlacementReport benchmark_placement(uint16_t num_trucks, uint16_t num_stations,
+                                    ThreadPool& pool) {
+
+    PlacementReport report = {0.0, 0.0, {}};
+    uint32_t seed = std::random_device{}();
+    double updates = static_cast<double>(num_trucks) * MAX_TIME;
+
+    /* Runs the same simulation with its trucks stored in `memory`, in seconds          */
+    auto run = [&](std::pmr::memory_resource* memory) {
+
+        Simulation sim(num_trucks, num_stations, false,
+                       UniformMiningTime(ONE_HOUR, FIVE_HOUR), seed, memory);
+
+        pool.reset_metrics();
+
+        auto start = std::chrono::steady_clock::now();
+        simulate_parallel(sim, pool);
+        auto end = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double>(end - start).count();
+    };
+
+    report.serial_touch_rate = updates / run(std::pmr::new_delete_resource());
+
+    /* Only the trucks are placed on the workers' nodes, the stations of all but the     *
+     * largest sites are passed upstream and stay with the constructing thread          */
+    FirstTouchResource first_touch(pool, sizeof(Truck));
+    double seconds = run(&first_touch);
+
+    report.first_touch_rate = updates / seconds;
+
+    /* Split the updates between the nodes by the tasks their workers ran               */
+    size_t grain = pool.grain_size(num_trucks);
+
+    for(const WorkerMetrics& worker : pool.get_metrics()) {
+
+        double worker_share = std::min<double>(worker.tasks_run * grain, updates);
+
+        report.node_rates[worker.node] += worker_share / seconds;
+    }
+
+    return report;
+}
+
+/****************************************************************************************
+ * log_placement_report                                                                 *
+ * @brief Outputs the result of `benchmark_placement` to the console.                   *
+ *                                                                                      *
+ * @param report: The benchmark result to print.                                        *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void log_placement_report(const PlacementReport& report) {
+
+    std::cout << "Placement: " << report.serial_touch_rate << " updates/s serial touch, "
+    << report.first_touch_rate << " updates/s first touch" << std::endl;
+
+    for(const auto& [node, rate] : report.node_rates) {
+        std::cout << "Node " << node << ": " << rate << " updates/s" << std::endl;
+    }
+    std::cout << std::endl;
+}
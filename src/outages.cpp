@@ -0,0 +1,390 @@
+#ifndef OUTAGES_HPP
+#include "../include/outages.hpp"
+#endif
+
+/****************************************************************************************
+ * StationAvailability Constructor                                                      *
+ * @brief Initializes the structure, `reset` sets it up for a number of stations.       *
+ *                                                                                      *
+ * @param memory: The resource the counts and the bitmaps are stored in.                *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+StationAvailability::StationAvailability(std::pmr::memory_resource* memory)
+                                         : holds(memory),
+                                           words(memory),
+                                           summary(memory),
+                                           num_stations(0),
+                                           num_up(0) {}
+
+/****************************************************************************************
+ * reset                                                                                *
+ * @brief Brings every station up, reusing the storage.                                 *
+ *                                                                                      *
+ * The bits past the last station stay clear, so no search ever returns one of them.    *
+ *                                                                                      *
+ * @param num_stations: The number of stations.                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void StationAvailability::reset(size_t num_stations) {
+
+    size_t num_words = (num_stations + 63) / 64;
+
+    this->num_stations = num_stations;
+    this->num_up = num_stations;
+
+    this->holds.assign(num_stations, 0);
+    this->words.assign(num_words, ~uint64_t{0});
+    this->summary.assign((num_words + 63) / 64, 0);
+
+    if(num_stations % 64) {
+        this->words.back() = (uint64_t{1} << (num_stations % 64)) - 1;
+    }
+
+    for(size_t word = 0; word < num_words; word++) {
+        this->summary[word / 64] |= uint64_t{1} << (word % 64);
+    }
+}
+
+/****************************************************************************************
+ * get_num_up                                                                           *
+ * @brief Retrieves the number of stations that are up.                                 *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: size_t - The number of stations up.                                         *
+ ****************************************************************************************/
+size_t StationAvailability::get_num_up() const {
+    return this->num_up;
+}
+
+/****************************************************************************************
+ * next_up                                                                              *
+ * @brief Finds the first station that is up at or after the given one, wrapping around *
+ *        after the last station.                                                       *
+ *                                                                                      *
+ * @param station: The index of the station to start at.                                *
+ * @return: size_t - The index of the station, NO_STATION if every station is down.     *
+ ****************************************************************************************/
+size_t StationAvailability::next_up(size_t station) const {
+
+    if(!this->num_up) {
+        return NO_STATION;
+    }
+
+    size_t up = this->find_up(station);
+
+    return (NO_STATION == up) ? this->find_up(0) : up;
+}
+
+/****************************************************************************************
+ * find_up                                                                              *
+ * @brief Finds the first station that is up at or after the given one.                 *
+ *                                                                                      *
+ * Looks at the rest of the station's own word first, then for the next word with any   *
+ * station up in the summary.                                                           *
+ *                                                                                      *
+ * @param station: The index of the station to start at.                                *
+ * @return: size_t - The index of the station, NO_STATION if there is none.             *
+ ****************************************************************************************/
+size_t StationAvailability::find_up(size_t station) const {
+
+    size_t word = station / 64;
+    uint64_t bits = this->words[word] & (~uint64_t{0} << (station % 64));
+
+    if(bits) {
+        return word * 64 + std::countr_zero(bits);
+    }
+
+    /* The summary words from the one holding the next word on                          */
+    size_t next = word + 1;
+
+    for(size_t block = next / 64; block < this->summary.size(); block++) {
+
+        uint64_t words_up = this->summary[block];
+
+        if(block == next / 64) {
+            words_up &= ~uint64_t{0} << (next % 64);
+        }
+
+        if(words_up) {
+
+            size_t found = block * 64 + std::countr_zero(words_up);
+
+            return found * 64 + std::countr_zero(this->words[found]);
+        }
+    }
+
+    return NO_STATION;
+}
+
+/****************************************************************************************
+ * OutageSimulation Constructor                                                         *
+ * @brief Initializes a simulation of the given fleet, stations and outages, with every *
+ *        truck mining and every station up.                                            *
+ *                                                                                      *
+ * The trucks and the stations are set up by `BaySimulation`, so the two draw the same  *
+ * mining times. The scheduled windows are put on the calendar, and the first random    *
+ * failure is drawn from the outage generator.                                          *
+ *                                                                                      *
+ * @param num_trucks: The number of trucks to be simulated.                             *
+ * @param configs: The bays and unload times of every station.                          *
+ * @param outages: The scheduled and random outages of the stations.                    *
+ * @param debug: Optional parameter that enables debug mode if set to true.             *
+ * @param mining_time: Optional distribution of mining times, defaults to the uniform   *
+ *                     distribution between the site's mining time bounds.              *
+ * @param seed: Optional seed of the simulation's random number generator.              *
+ * @param memory: Optional resource the trucks, stations and outages are stored in.     *
+ * @param site: Optional site the simulation runs at, defaults to the standard site.    *
+ * @param selection: Optional station selection policy, defaults to round robin.        *
+ * @return: None                                                                        *
+ * @throws: std::invalid_argument if a station, a window, the outages or the site are   *
+ *          invalid, or the selection policy mirrors the queues.                        *
+ ****************************************************************************************/
+OutageSimulation::OutageSimulation(uint16_t num_trucks,
+                                   const std::vector<BayConfig>& configs,
+                                   const OutageConfig& outages,
+                                   bool debug,
+                                   std::optional<MiningTimeDistribution> mining_time,
+                                   uint32_t seed,
+                                   std::pmr::memory_resource* memory,
+                                   const SiteConfig& site,
+                                   SelectionPolicy selection)
+                                   : BaySimulation(num_trucks, configs, debug,
+                                                   std::move(mining_time), seed, memory,
+                                                   site, selection),
+                                     availability(memory),
+                                     outages(outages),
+                                     calendar(memory),
+                                     repaired(memory),
+                                     outage_gen(seed),
+                                     next_failure(
+                                         std::numeric_limits<double>::infinity()),
+                                     num_outages(0),
+                                     num_rerouted(0) {
+
+    if(!(outages.failures_per_day >= 0.0) || !outages.min_repair ||
+       (outages.min_repair > outages.max_repair) || !outages.reroute_time) {
+        throw std::invalid_argument("Outages need a non-negative failure rate and repair "
+                                    "and reroute times of at least one tick");
+    }
+
+    uint16_t num_stations = static_cast<uint16_t>(configs.size());
+
+    for(const OutageWindow& window : outages.windows) {
+        if((window.first_station >= window.last_station) ||
+           (window.last_station > num_stations) || (window.start >= window.end)) {
+            throw std::invalid_argument("An outage window must cover a non-empty range "
+                                        "of stations and ticks");
+        }
+    }
+
+    this->availability.reset(num_stations);
+    this->repaired.reserve(num_stations);
+
+    /* Every window starts and ends once, the random failures add their repairs         */
+    this->calendar.reserve(2 * outages.windows.size());
+
+    for(const OutageWindow& window : outages.windows) {
+        this->calendar.push_back({window.start, window.first_station,
+                                  window.last_station, true});
+        this->calendar.push_back({window.end, window.first_station,
+                                  window.last_station, false});
+    }
+    std::make_heap(this->calendar.begin(), this->calendar.end(), std::greater<>());
+
+    if(outages.failures_per_day > 0.0) {
+
+        std::exponential_distribution<double> gap(outages.failures_per_day *
+                                                  num_stations / ONE_DAY);
+
+        this->next_failure = gap(this->outage_gen);
+    }
+}
+
+/****************************************************************************************
+ * simulate                                                                             *
+ * @brief Runs the tick loop for `total_time` ticks.                                    *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void OutageSimulation::simulate() {
+
+    FixedHorizon horizon(this->total_time);
+
+    this->simulate(horizon);
+}
+
+/****************************************************************************************
+ * apply_outages                                                                        *
+ * @brief Starts and ends the outages due at the current tick.                          *
+ *                                                                                      *
+ * The random failures due before the end of the tick take down a station picked at     *
+ * random, and put its repair on the calendar. The stations that came up only hand out  *
+ * their bays once every outage of the tick is in, so a station repaired and struck     *
+ * again in the same tick gives none. When the trucks are rerouted and a station comes  *
+ * up after every station was down, the trucks held at the stations still down leave.   *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void OutageSimulation::apply_outages() {
+
+    auto went_down = [this](size_t station_idx) { this->go_down(station_idx); };
+    auto came_up = [this](size_t station_idx) {
+        this->repaired.push_back(static_cast<uint16_t>(station_idx));
+    };
+
+    /* The trucks that arrived with every station down are held wherever they went      */
+    bool all_down = !this->availability.get_num_up();
+
+    while(!this->calendar.empty() && (this->calendar.front().tick <= this->tick)) {
+
+        std::pop_heap(this->calendar.begin(), this->calendar.end(), std::greater<>());
+
+        OutageEvent event = this->calendar.back();
+        this->calendar.pop_back();
+
+        if(event.down) {
+            this->availability.disable(event.first_station, event.last_station,
+                                       went_down);
+        }
+        else {
+            this->availability.enable(event.first_station, event.last_station, came_up);
+        }
+    }
+
+    if(this->next_failure < this->tick + 1.0) {
+
+        std::uniform_int_distribution<uint16_t> station(0, this->stations.size() - 1);
+        std::uniform_int_distribution<uint16_t> repair(this->outages.min_repair,
+                                                       this->outages.max_repair);
+        std::exponential_distribution<double> gap(this->outages.failures_per_day *
+                                                  this->stations.size() / ONE_DAY);
+
+        while(this->next_failure < this->tick + 1.0) {
+
+            uint16_t station_idx = station(this->outage_gen);
+
+            this->availability.disable(station_idx, station_idx + 1u, went_down);
+
+            this->calendar.push_back({this->tick + repair(this->outage_gen), station_idx,
+                                      static_cast<uint16_t>(station_idx + 1u), false});
+            std::push_heap(this->calendar.begin(), this->calendar.end(),
+                           std::greater<>());
+
+            this->next_failure += gap(this->outage_gen);
+        }
+    }
+
+    for(uint16_t station_idx : this->repaired) {
+        if(this->availability.is_up(station_idx)) {
+            this->come_up(station_idx);
+        }
+    }
+    this->repaired.clear();
+
+    if(!all_down || !this->availability.get_num_up() ||
+       (OutagePolicy::Hold == this->outages.policy)) {
+        return;
+    }
+
+    for(size_t station_idx = 0; station_idx < this->stations.size(); station_idx++) {
+        if(!this->availability.is_up(station_idx)) {
+            this->reroute(station_idx);
+        }
+    }
+}
+
+/****************************************************************************************
+ * go_down                                                                              *
+ * @brief Sends the trucks queued at a station that went down elsewhere, if the policy  *
+ *        is to reroute them.                                                           *
+ *                                                                                      *
+ * @param station_idx: The index of the station.                                        *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void OutageSimulation::go_down(size_t station_idx) {
+
+    this->num_outages++;
+
+    if(OutagePolicy::Reroute == this->outages.policy) {
+        this->reroute(station_idx);
+    }
+}
+
+/****************************************************************************************
+ * reroute                                                                              *
+ * @brief Sends the trucks queued at a station that is down elsewhere.                  *
+ *                                                                                      *
+ * A rerouted truck travels for the reroute time and picks its next station when it     *
+ * gets there, as if it had just arrived from the mines.                                *
+ *                                                                                      *
+ * @param station_idx: The index of the station.                                        *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void OutageSimulation::reroute(size_t station_idx) {
+
+    uint16_t truck_idx;
+
+    while(this->stations[station_idx].evict(truck_idx)) {
+
+        this->trucks[truck_idx].depart(station_idx, this->outages.reroute_time);
+        this->num_rerouted++;
+    }
+}
+
+/****************************************************************************************
+ * come_up                                                                              *
+ * @brief Hands the free bays of a station that came back up to its queue.              *
+ *                                                                                      *
+ * @param station_idx: The index of the station.                                        *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void OutageSimulation::come_up(size_t station_idx) {
+
+    BayStation& station = this->stations[station_idx];
+    uint16_t next;
+
+    while(station.admit(next)) {
+        this->trucks[next].start_unloading(station_idx,
+                                           station.draw_unload_time(this->gen));
+    }
+}
+
+/****************************************************************************************
+ * logging                                                                              *
+ * @brief Outputs the statistics of every truck and station, and of the outages, to the *
+ *        console.                                                                      *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void OutageSimulation::logging() {
+
+    BaySimulation::logging();
+
+    std::cout << "Station outages: " << this->num_outages << std::endl;
+    std::cout << "Trucks rerouted: " << this->num_rerouted << std::endl << std::endl;
+}
+
+/****************************************************************************************
+ * get_num_outages                                                                      *
+ * @brief Retrieves the number of times a station went down.                            *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: uint32_t - The number of outages.                                           *
+ ****************************************************************************************/
+uint32_t OutageSimulation::get_num_outages() {
+    return this->num_outages;
+}
+
+/****************************************************************************************
+ * get_num_rerouted                                                                     *
+ * @brief Retrieves the number of trucks sent away from a station that went down.       *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: uint32_t - The number of trucks rerouted.                                   *
+ ****************************************************************************************/
+uint32_t OutageSimulation::get_num_rerouted() {
+    return this->num_rerouted;
+}
@@ -0,0 +1,123 @@
+#ifndef PARALLEL_HPP
+#include "../include/parallel.hpp"
+#endif
+
+#include <latch>
+
+/****************************************************************************************
+ * ArrivalQueue Constructor                                                             *
+ * @brief Allocates the buffer for a fleet of trucks.                                   *
+ *                                                                                      *
+ * @param capacity: The number of trucks that can enqueue themselves each tick.         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+ArrivalQueue::ArrivalQueue(size_t capacity) : entries(capacity), tail(0) {}
+
+/****************************************************************************************
+ * simulate_parallel                                                                    *
+ * @brief Runs the tick loop of a simulation for its fixed horizon on several threads.  *
+ *                                                                                      *
+ * This is the parallel counterpart of `Simulation::simulate`, including the warm-up,   *
+ * and produces exactly the same results for the same seed.                             *
+ *                                                                                      *
+ * @param sim: The simulation to run.                                                   *
+ * @param pool: The pool advancing the trucks, every truck on a fixed worker.           *
+ * @return: None                                                                        *
+ * @throws: std::runtime_error if a debug check fails.                                  *
+ ****************************************************************************************/
+void simulate_parallel(Simulation& sim, ThreadPool& pool) {
+
+    /* Run through the warm-up first and discard what was recorded during it            */
+    if(sim.get_warmup_time()) {
+
+        FixedHorizon warmup(sim.get_warmup_time());
+
+        simulate_parallel(sim, warmup, pool);
+        sim.reset_statistics();
+    }
+
+    /* Run for the total simulation time                                                */
+    FixedHorizon horizon(sim.total_time);
+
+    simulate_parallel(sim, horizon, pool);
+}
+
+/****************************************************************************************
+ * benchmark_arrival_queue                                                              *
+ * @brief Measures the cost of pushing to an ArrivalQueue when every thread pushes at   *
+ *        once.                                                                         *
+ *                                                                                      *
+ * Each thread pushes a distinct range of truck indices, so after the drain the entries *
+ * have to be exactly 0 .. num_threads * pushes_per_thread - 1 in order.                *
+ *                                                                                      *
+ * @param num_threads: The number of threads pushing at the same time.                  *
+ * @param pushes_per_thread: The number of entries each thread pushes.                  *
+ * @return: ContentionReport - The time taken and the resulting throughput.             *
+ * @throws: std::runtime_error if the drained entries do not match the pushed ones.     *
+ ****************************************************************************************/
+ContentionReport benchmark_arrival_queue(size_t num_threads, size_t pushes_per_thread) {
+
+    ContentionReport report = {num_threads, pushes_per_thread, 0.0, 0.0, 0.0};
+    size_t total = num_threads * pushes_per_thread;
+
+    ArrivalQueue arrivals(total);
+
+    /* Hold every thread back until all of them have been started                       */
+    std::latch ready(static_cast<std::ptrdiff_t>(num_threads) + 1);
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+
+    for(size_t t = 0; t < num_threads; t++) {
+        threads.emplace_back([&arrivals, &ready, t, pushes_per_thread]() {
+
+            ready.arrive_and_wait();
+
+            for(size_t i = 0; i < pushes_per_thread; i++) {
+                arrivals.push(t * pushes_per_thread + i, TruckEvent::Arrive);
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ready.arrive_and_wait();
+
+    for(auto& thread : threads) {
+        thread.join();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    report.elapsed_us = std::chrono::duration<double, std::micro>(end - start).count();
+    report.ns_per_push = report.elapsed_us * 1000.0 / std::max<size_t>(total, 1);
+    report.pushes_per_second = total / (report.elapsed_us / 1e6);
+
+    /* Every push has to come out of the drain exactly once                             */
+    size_t expected = 0;
+    bool lost = (arrivals.size() != total);
+
+    arrivals.drain([&expected, &lost](const ArrivalQueue::Entry& entry) {
+        lost |= (entry.truck_idx != expected++);
+    });
+
+    if(lost) {
+        throw std::runtime_error("The arrival queue lost or duplicated an entry");
+    }
+
+    return report;
+}
+
+/****************************************************************************************
+ * log_contention_report                                                                *
+ * @brief Outputs the result of `benchmark_arrival_queue` to the console.               *
+ *                                                                                      *
+ * @param report: The benchmark result to print.                                        *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void log_contention_report(const ContentionReport& report) {
+
+    std::cout << "Arrival queue: " << report.num_threads << " threads x "
+    << report.pushes_per_thread << " pushes in " << report.elapsed_us << "us"
+    << std::endl;
+
+    std::cout << "Per push: " << report.ns_per_push << "ns, Throughput: "
+    << report.pushes_per_second << " pushes/s" << std::endl << std::endl;
+}
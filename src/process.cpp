@@ -0,0 +1,555 @@
+#ifndef PROCESS_HPP
+#include "../include/process.hpp"
+#endif
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+/****************************************************************************************
+ * TruckProcess::promise_type::operator delete                                          *
+ * @brief Returns the coroutine frame to the pool it came from.                         *
+ *                                                                                      *
+ * @param frame: The frame.                                                             *
+ * @param size: The size of the frame.                                                  *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void TruckProcess::promise_type::operator delete(void* frame, size_t size) {
+
+    std::byte* block = static_cast<std::byte*>(frame) - FRAME_HEADER;
+    std::pmr::memory_resource* pool =
+        *reinterpret_cast<std::pmr::memory_resource**>(block);
+
+    pool->deallocate(block, FRAME_HEADER + size, FRAME_HEADER);
+}
+
+/****************************************************************************************
+ * TruckProcess::promise_type::get_return_object                                        *
+ * @brief Wraps the coroutine in the handle returned to the caller.                     *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: TruckProcess - The truck.                                                   *
+ ****************************************************************************************/
+TruckProcess TruckProcess::promise_type::get_return_object() {
+    return TruckProcess(std::coroutine_handle<promise_type>::from_promise(*this));
+}
+
+/****************************************************************************************
+ * TruckProcess::promise_type::initial_suspend                                          *
+ * @brief Runs the truck up to its first `co_await` as soon as it is created.           *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: std::suspend_never - Never suspends.                                        *
+ ****************************************************************************************/
+std::suspend_never TruckProcess::promise_type::initial_suspend() noexcept {
+    return {};
+}
+
+/****************************************************************************************
+ * TruckProcess::promise_type::final_suspend                                            *
+ * @brief Keeps the frame of a process that ended, the TruckProcess destroys it.        *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: std::suspend_always - Always suspends.                                      *
+ ****************************************************************************************/
+std::suspend_always TruckProcess::promise_type::final_suspend() noexcept {
+    return {};
+}
+
+/****************************************************************************************
+ * TruckProcess::promise_type::return_void                                              *
+ * @brief Called if a process returns, which a truck never does.                        *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void TruckProcess::promise_type::return_void() noexcept {}
+
+/****************************************************************************************
+ * TruckProcess::promise_type::unhandled_exception                                      *
+ * @brief Passes an exception thrown by a process on to whoever resumed it.             *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ * @throws: The exception the process threw.                                            *
+ ****************************************************************************************/
+void TruckProcess::promise_type::unhandled_exception() {
+    throw;
+}
+
+/****************************************************************************************
+ * TruckProcess Constructor                                                             *
+ * @brief Takes ownership of a truck's coroutine.                                       *
+ *                                                                                      *
+ * @param handle: The coroutine.                                                        *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+TruckProcess::TruckProcess(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+/****************************************************************************************
+ * TruckProcess Move Constructor                                                        *
+ * @brief Takes over the coroutine of another handle, which is left empty.              *
+ *                                                                                      *
+ * @param other: The handle to move from.                                               *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+TruckProcess::TruckProcess(TruckProcess&& other) noexcept
+                           : handle(std::exchange(other.handle, nullptr)) {}
+
+/****************************************************************************************
+ * TruckProcess Move Assignment                                                         *
+ * @brief Destroys the owned coroutine and takes over the one of another handle.        *
+ *                                                                                      *
+ * @param other: The handle to move from.                                               *
+ * @return: TruckProcess& - This handle.                                                *
+ ****************************************************************************************/
+TruckProcess& TruckProcess::operator=(TruckProcess&& other) noexcept {
+
+    if(this != &other) {
+
+        if(this->handle) {
+            this->handle.destroy();
+        }
+        this->handle = std::exchange(other.handle, nullptr);
+    }
+
+    return *this;
+}
+
+/****************************************************************************************
+ * ~TruckProcess                                                                        *
+ * @brief Destroys the coroutine, returning its frame to the pool.                      *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+TruckProcess::~TruckProcess() {
+
+    if(this->handle) {
+        this->handle.destroy();
+    }
+}
+
+/****************************************************************************************
+ * resume                                                                               *
+ * @brief Runs the truck from where it last suspended up to its next `co_await`.        *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ * @throws: Whatever the process throws.                                                *
+ ****************************************************************************************/
+void TruckProcess::resume() {
+    this->handle.resume();
+}
+
+/****************************************************************************************
+ * get_total_time                                                                       *
+ * @brief Retrieves the packed time the truck recorded.                                 *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: uint64_t - The total time recorded for the truck across all states.         *
+ ****************************************************************************************/
+uint64_t TruckProcess::get_total_time() const {
+    return this->handle.promise().total_time;
+}
+
+/****************************************************************************************
+ * ProcessDelay::await_ready                                                            *
+ * @brief An activity always takes time, so the truck always suspends.                  *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: bool - Always false.                                                        *
+ ****************************************************************************************/
+bool ProcessDelay::await_ready() const noexcept {
+    return false;
+}
+
+/****************************************************************************************
+ * ProcessDelay::await_suspend                                                          *
+ * @brief Records the activity and wakes the truck in its last tick.                    *
+ *                                                                                      *
+ * @param process: The suspending truck.                                                *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void ProcessDelay::await_suspend(ProcessHandle process) {
+
+    TruckProcess::promise_type& truck = process.promise();
+
+    this->sim->schedule(truck, this->increment, this->ticks,
+                        truck.cursor + this->ticks - 1);
+}
+
+/****************************************************************************************
+ * ProcessDelay::await_resume                                                           *
+ * @brief Nothing is left to do once the activity is over.                              *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void ProcessDelay::await_resume() const noexcept {}
+
+/****************************************************************************************
+ * ProcessUnload::await_ready                                                           *
+ * @brief Unloading always takes a tick, so the truck always suspends.                  *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: bool - Always false.                                                        *
+ ****************************************************************************************/
+bool ProcessUnload::await_ready() const noexcept {
+    return false;
+}
+
+/****************************************************************************************
+ * ProcessUnload::await_suspend                                                         *
+ * @brief Queues the truck at the station and wakes it in the tick it unloads.          *
+ *                                                                                      *
+ * The truck waits one tick for every truck queued ahead of it, as in `Truck::resolve`, *
+ * and then unloads for a tick.                                                         *
+ *                                                                                      *
+ * @param process: The suspending truck.                                                *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void ProcessUnload::await_suspend(ProcessHandle process) {
+
+    TruckProcess::promise_type& truck = process.promise();
+    Station& station = this->sim->stations[this->station_idx];
+
+    uint16_t queue = station.get_queue(this->sim->tick);
+
+    station.increment_queue(this->sim->tick);
+
+    /* Nothing wakes a waiting truck, it is woken in the tick it unloads                */
+    this->sim->schedule(truck, WAITING_INC, queue, UINT32_MAX);
+    this->sim->schedule(truck, UNLOADING_INC, 1, truck.cursor);
+}
+
+/****************************************************************************************
+ * ProcessUnload::await_resume                                                          *
+ * @brief Counts the truck as unloaded at the station.                                  *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void ProcessUnload::await_resume() {
+    this->sim->stations[this->station_idx].increment_trucks_unloaded();
+}
+
+/****************************************************************************************
+ * ProcessWakeup::operator>                                                             *
+ * @brief Orders the calendar as a min-heap, by tick and then by truck index.           *
+ *                                                                                      *
+ * @param other: The wake-up to compare with.                                           *
+ * @return: bool - Whether this wake-up comes after the other.                          *
+ ****************************************************************************************/
+bool ProcessWakeup::operator>(const ProcessWakeup& other) const {
+    return (this->tick != other.tick) ? (this->tick > other.tick)
+                                      : (this->truck_idx > other.truck_idx);
+}
+
+/****************************************************************************************
+ * ProcessSimulation Constructor                                                        *
+ * @brief Initializes the stations and the selection policy, the trucks are started by  *
+ *        `simulate`.                                                                   *
+ *                                                                                      *
+ * The selector is reset with the seed, as in `Simulation::reset`.                      *
+ *                                                                                      *
+ * @param num_trucks: The number of trucks to be simulated.                             *
+ * @param num_stations: The number of stations available in the simulation.             *
+ * @param mining_time: The distribution of mining times, the uniform distribution       *
+ *                     between the site's mining time bounds if empty.                  *
+ * @param seed: The seed of the simulation's random number generator.                   *
+ * @param memory: The resource the stations, the calendar and the frame pool are stored *
+ *                in.                                                                   *
+ * @param site: The site the simulation runs at.                                        *
+ * @param selection: The station selection policy.                                      *
+ * @return: None                                                                        *
+ * @throws: std::invalid_argument if the site is invalid.                               *
+ ****************************************************************************************/
+ProcessSimulation::ProcessSimulation(uint16_t num_trucks,
+                                     uint16_t num_stations,
+                                     std::optional<MiningTimeDistribution> mining_time,
+                                     uint32_t seed,
+                                     std::pmr::memory_resource* memory,
+                                     const SiteConfig& site,
+                                     SelectionPolicy selection)
+                                     : num_trucks(num_trucks),
+                                       total_time(site.max_time),
+                                       site(site),
+                                       tick(0),
+                                       stations(num_stations, Station(), memory),
+                                       selector(make_selector(selection, memory,
+                                                              site.travel_time)),
+                                       mining_time(mining_time ? std::move(*mining_time)
+                                                               : site_mining_time(site)),
+                                       gen(seed),
+                                       frames(memory),
+                                       trucks(memory),
+                                       calendar(memory) {
+
+    validate_site(site);
+
+    std::visit([seed, num_stations](auto& selector) {
+        selector.reset(num_stations, seed);
+    }, this->selector);
+
+    /* Every truck has at most one wake-up pending                                      */
+    this->trucks.reserve(num_trucks);
+    this->calendar.reserve(num_trucks);
+}
+
+/****************************************************************************************
+ * start                                                                                *
+ * @brief Creates the process of every truck in index order, each of which draws its    *
+ *        first mining time and suspends.                                               *
+ *                                                                                      *
+ * The distribution and the selection policy are resolved once, so the processes are    *
+ * specialized for them.                                                                *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void ProcessSimulation::start() {
+
+    if(!this->trucks.empty()) {
+        return;
+    }
+
+    std::visit([this](auto& dist, auto& selector) {
+        for(uint32_t i = 0; i < this->num_trucks; i++) {
+            this->trucks.push_back(truck_process(*this, i, dist, selector));
+        }
+    }, this->mining_time, this->selector);
+}
+
+/****************************************************************************************
+ * simulate                                                                             *
+ * @brief Starts the trucks if need be and resumes them from the calendar until the     *
+ *        horizon.                                                                      *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ * @throws: Whatever a process throws.                                                  *
+ ****************************************************************************************/
+void ProcessSimulation::simulate() {
+
+    this->start();
+
+    while(!this->calendar.empty()) {
+
+        std::pop_heap(this->calendar.begin(), this->calendar.end(),
+                      std::greater<ProcessWakeup>());
+
+        ProcessWakeup wakeup = this->calendar.back();
+        this->calendar.pop_back();
+
+        this->tick = wakeup.tick;
+        this->trucks[wakeup.truck_idx].resume();
+    }
+
+    /* Every wake-up before the horizon has run                                         */
+    this->tick = this->total_time;
+}
+
+/****************************************************************************************
+ * mine                                                                                 *
+ * @brief Awaitable that keeps a truck mining.                                          *
+ *                                                                                      *
+ * @param ticks: The mining time, at least one tick.                                    *
+ * @return: ProcessDelay - Resumes the truck in its last tick of mining.                *
+ ****************************************************************************************/
+ProcessDelay ProcessSimulation::mine(uint16_t ticks) {
+    return ProcessDelay{this, MINING_INC, ticks};
+}
+
+/****************************************************************************************
+ * travel                                                                               *
+ * @brief Awaitable that takes a truck between the mines and the stations.              *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: ProcessDelay - Resumes the truck in its last tick of travel.                *
+ ****************************************************************************************/
+ProcessDelay ProcessSimulation::travel() {
+    return ProcessDelay{this, TRAVELING_INC, this->site.travel_time};
+}
+
+/****************************************************************************************
+ * unload                                                                               *
+ * @brief Awaitable that queues a truck at a station and unloads it there.              *
+ *                                                                                      *
+ * @param station_idx: The station, as picked by the selection policy.                  *
+ * @return: ProcessUnload - Resumes the truck in the tick it unloads.                   *
+ ****************************************************************************************/
+ProcessUnload ProcessSimulation::unload(size_t station_idx) {
+    return ProcessUnload{this, station_idx};
+}
+
+/****************************************************************************************
+ * schedule                                                                             *
+ * @brief Records the ticks of an activity a truck starts, and books its wake-up.       *
+ *                                                                                      *
+ * Only the ticks before the horizon are recorded, as the tick loop would.              *
+ *                                                                                      *
+ * @param process: The truck.                                                           *
+ * @param increment: The packed time added every tick, one of the *_INC macros.         *
+ * @param ticks: The length of the activity.                                            *
+ * @param wakeup: The tick to resume the truck in, skipped past the horizon.            *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void ProcessSimulation::schedule(TruckProcess::promise_type& process, uint64_t increment,
+                                 uint32_t ticks, uint32_t wakeup) {
+
+    uint32_t first = std::min<uint32_t>(process.cursor, this->total_time);
+    uint32_t last = std::min<uint32_t>(process.cursor + ticks, this->total_time);
+
+    process.total_time += increment * (last - first);
+    process.cursor += ticks;
+
+    if(wakeup < this->total_time) {
+
+        this->calendar.push_back(ProcessWakeup{wakeup, process.truck_idx});
+        std::push_heap(this->calendar.begin(), this->calendar.end(),
+                       std::greater<ProcessWakeup>());
+    }
+}
+
+/****************************************************************************************
+ * get_total_time                                                                       *
+ * @brief Retrieves the packed time a truck recorded.                                   *
+ *                                                                                      *
+ * @param truck_idx: The index of the truck.                                            *
+ * @return: uint64_t - The total time recorded for the truck across all states.         *
+ ****************************************************************************************/
+uint64_t ProcessSimulation::get_total_time(size_t truck_idx) const {
+    return this->trucks[truck_idx].get_total_time();
+}
+
+/****************************************************************************************
+ * get_state_fractions                                                                  *
+ * @brief Computes the fraction of time the fleet spent in each category.               *
+ *                                                                                      *
+ * Sums the trucks in the same order as `fleet_state_fractions`.                        *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: StateFractions - The fleet-wide fraction of time spent in each category.    *
+ ****************************************************************************************/
+StateFractions ProcessSimulation::get_state_fractions() const {
+
+    StateFractions fractions = {0.0, 0.0, 0.0, 0.0};
+
+    for(const auto& truck : this->trucks) {
+
+        uint64_t time = truck.get_total_time();
+
+        fractions.waiting   += RETRIEVE_TIME(time, WAITING_MASK, 0);
+        fractions.unloading += RETRIEVE_TIME(time, UNLOADING_MASK, 16);
+        fractions.traveling += RETRIEVE_TIME(time, TRAVELING_MASK, 32);
+        fractions.mining    += RETRIEVE_TIME(time, MINING_MASK, 48);
+    }
+
+    /* Normalize by the time available to the whole fleet                               */
+    double fleet_time = static_cast<double>(this->total_time) * this->trucks.size();
+
+    fractions.waiting   /= fleet_time;
+    fractions.unloading /= fleet_time;
+    fractions.traveling /= fleet_time;
+    fractions.mining    /= fleet_time;
+
+    return fractions;
+}
+
+/****************************************************************************************
+ * get_frame_pool                                                                       *
+ * @brief Retrieves the pool the coroutine frames are allocated from.                   *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: std::pmr::memory_resource* - The pool.                                      *
+ ****************************************************************************************/
+std::pmr::memory_resource* ProcessSimulation::get_frame_pool() {
+    return &this->frames;
+}
+
+/****************************************************************************************
+ * benchmark_processes                                                                  *
+ * @brief Measures the throughput of the state machine and the process engine on the    *
+ *        same simulation.                                                              *
+ *                                                                                      *
+ * @param num_trucks: The number of trucks in the simulation.                           *
+ * @param num_stations: The number of stations in the simulation.                       *
+ * @return: ProcessReport - The metrics of both engines.                                *
+ * @throws: std::runtime_error if the engines do not agree or a suspension allocated.   *
+ ****************************************************************************************/
+ProcessReport benchmark_processes(uint16_t num_trucks, uint16_t num_stations) {
+
+    ProcessReport report = {num_trucks, num_stations, 0.0, 0.0, 0};
+    uint32_t seed = std::random_device{}();
+    double updates = std::max(static_cast<double>(num_trucks) * MAX_TIME, 1.0);
+
+    CountingResource counter;
+
+    Simulation state_machine(num_trucks, num_stations, false,
+                             UniformMiningTime(ONE_HOUR, FIVE_HOUR), seed);
+    ProcessSimulation processes(num_trucks, num_stations,
+                                UniformMiningTime(ONE_HOUR, FIVE_HOUR), seed, &counter);
+
+    /* Runs one engine over its simulation, in seconds                                  */
+    auto run = [](auto&& engine) {
+
+        auto start = std::chrono::steady_clock::now();
+        engine();
+        auto end = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double>(end - start).count();
+    };
+
+    report.state_machine_rate = updates / run([&]() {
+        state_machine.simulate();
+    });
+
+    /* The frames are allocated when the trucks start, nothing after that               */
+    counter.reset();
+    processes.start();
+    report.frame_bytes = counter.get_bytes();
+    counter.reset();
+
+    report.process_rate = updates / run([&]() {
+        processes.simulate();
+    });
+
+    compare_allocations_to_zero(counter);
+
+    /* Both engines ran the same seed, so every truck and station has to agree          */
+    bool diverged = false;
+
+    for(size_t i = 0; i < state_machine.trucks.size(); i++) {
+        diverged |= (state_machine.trucks[i].get_total_time() !=
+                     processes.get_total_time(i));
+    }
+    for(size_t i = 0; i < state_machine.stations.size(); i++) {
+        diverged |= (state_machine.stations[i].get_trucks_unloaded() !=
+                     processes.stations[i].get_trucks_unloaded());
+    }
+
+    if(diverged) {
+        throw std::runtime_error("The process engine diverged from the state machine");
+    }
+
+    return report;
+}
+
+/****************************************************************************************
+ * log_process_report                                                                   *
+ * @brief Outputs the result of `benchmark_processes` to the console.                   *
+ *                                                                                      *
+ * @param report: The benchmark result to print.                                        *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void log_process_report(const ProcessReport& report) {
+
+    std::cout << "Truck processes over " << report.num_trucks << " trucks and "
+    << report.num_stations << " stations" << std::endl;
+    std::cout << "State machine: " << report.state_machine_rate << " updates/s"
+    << std::endl;
+    std::cout << "Coroutines: " << report.process_rate << " updates/s, "
+    << report.frame_bytes << " bytes of frames" << std::endl;
+    std::cout << std::endl;
+}
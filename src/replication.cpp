@@ -0,0 +1,84 @@
+#ifndef REPLICATION_HPP
+#include "../include/replication.hpp"
+#endif
+
+/****************************************************************************************
+ * ReplicationRunner Constructor                                                        *
+ * @brief Initializes an empty arena buffer for every thread of the pool.               *
+ *                                                                                      *
+ * @param pool: The pool the replications run on.                                       *
+ * @param upstream: The resource the arena buffers, and any allocation that does not    *
+ *                  fit in them, come from.                                             *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+ReplicationRunner::ReplicationRunner(ThreadPool& pool,
+                                     std::pmr::memory_resource* upstream)
+                                     : pool(pool),
+                                       upstream(upstream) {
+
+    /* The calling thread gets the last buffer, see ThreadPool::current_worker          */
+    this->buffers.reserve(pool.size() + 1);
+
+    for(size_t i = 0; i <= pool.size(); i++) {
+        this->buffers.emplace_back(upstream);
+    }
+}
+
+/****************************************************************************************
+ * run                                                                                  *
+ * @brief Runs one replication per entry of `results` for the fixed horizon, seeded     *
+ *        `first_seed`, `first_seed + 1`, ..., and stores their state fractions.        *
+ *                                                                                      *
+ * Every replication is one task, and runs the serial tick loop. A thread only ever     *
+ * runs one replication at a time, since nothing inside a replication waits on the      *
+ * pool, so its buffer is never shared.                                                 *
+ *                                                                                      *
+ * The distribution is copied into the arena with `copy_distribution`, so a replication *
+ * of the empirical distribution does not allocate its alias table from the heap        *
+ * either.                                                                              *
+ *                                                                                      *
+ * @param num_trucks: The number of trucks in every replication.                        *
+ * @param num_stations: The number of stations in every replication.                    *
+ * @param mining_time: The mining time distribution of every replication.               *
+ * @param first_seed: The seed of the first replication.                                *
+ * @param results: Receives the state fractions of each replication, in seed order.     *
+ * @return: None                                                                        *
+ * @throws: std::runtime_error if a replication fails.                                  *
+ ****************************************************************************************/
+void ReplicationRunner::run(uint16_t num_trucks,
+                            uint16_t num_stations,
+                            const MiningTimeDistribution& mining_time,
+                            uint32_t first_seed,
+                            std::span<StateFractions> results) {
+
+    size_t needed = Simulation::storage_bytes(num_trucks, num_stations) +
+                    distribution_storage_bytes(mining_time);
+
+    /* Only grows for the first batch of a larger configuration. Every buffer grows,     *
+     * since a thread that sat that batch out may well run a replication of the next    */
+    for(std::pmr::vector<std::byte>& buffer : this->buffers) {
+        if(buffer.size() < needed) {
+            buffer.resize(needed);
+        }
+    }
+
+    this->pool.parallel_for(0, results.size(), 1, [&](size_t first, size_t last) {
+
+        std::pmr::vector<std::byte>& buffer = this->buffers[this->pool.current_worker()];
+
+        for(size_t i = first; i < last; i++) {
+
+            /* Build in the buffer, anything that does not fit goes upstream            */
+            std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(),
+                                                      this->upstream);
+
+            /* The copy of the distribution keeps its tables in the arena as well       */
+            Simulation sim(num_trucks, num_stations, false,
+                           copy_distribution(mining_time, &arena),
+                           first_seed + static_cast<uint32_t>(i), &arena);
+
+            sim.simulate();
+            results[i] = sim.get_state_fractions();
+        }
+    });
+}
@@ -0,0 +1,489 @@
+#ifndef MAIN_HPP
+#include "../include/main.hpp"
+#endif
+
+#ifndef SELECTION_HPP
+#include "../include/selection.hpp"
+#endif
+
+/****************************************************************************************
+ * RoundRobinSelector Constructor                                                       *
+ * @brief Initializes the selector, `reset` sets it up for a number of stations.        *
+ *                                                                                      *
+ * @param memory: Unused, the selector stores nothing outside of itself.                *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+RoundRobinSelector::RoundRobinSelector(std::pmr::memory_resource*) : next(0),
+                                                                     num_stations(1) {}
+
+/****************************************************************************************
+ * reset                                                                                *
+ * @brief Starts over at the first station.                                             *
+ *                                                                                      *
+ * @param num_stations: The number of stations to pick from.                            *
+ * @param seed: Unused, the policy is deterministic.                                    *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void RoundRobinSelector::reset(size_t num_stations, uint32_t) {
+
+    this->next = 0;
+    this->num_stations = num_stations;
+}
+
+/****************************************************************************************
+ * peek                                                                                 *
+ * @brief Retrieves the station the next arriving truck would be sent to.               *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: size_t - The index of the station.                                          *
+ ****************************************************************************************/
+size_t RoundRobinSelector::peek() const {
+    return this->next;
+}
+
+/****************************************************************************************
+ * resume_after                                                                         *
+ * @brief Sends the next arriving truck to the station after the given one.             *
+ *                                                                                      *
+ * @param station: The index of the station the last truck was sent to.                 *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void RoundRobinSelector::resume_after(size_t station) {
+    this->next = (station + 1) % this->num_stations;
+}
+
+/****************************************************************************************
+ * ShortestQueueSelector Constructor                                                    *
+ * @brief Initializes the selector, `reset` sets it up for a number of stations.        *
+ *                                                                                      *
+ * @param memory: The resource the segment tree is stored in.                           *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+ShortestQueueSelector::ShortestQueueSelector(std::pmr::memory_resource* memory)
+                                             : empty_ticks(memory),
+                                               num_leaves(1) {}
+
+/****************************************************************************************
+ * reset                                                                                *
+ * @brief Empties every queue, reusing the tree's storage.                              *
+ *                                                                                      *
+ * Every station starts out empty at tick 0, so the tree is built bottom up in O(S).    *
+ *                                                                                      *
+ * @param num_stations: The number of stations to pick from.                            *
+ * @param seed: Unused, the policy is deterministic.                                    *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void ShortestQueueSelector::reset(size_t num_stations, uint32_t) {
+
+    this->num_leaves = std::bit_ceil(std::max<size_t>(num_stations, 1));
+
+    /* Only grows the storage, and then to the exact size, see storage_bytes            */
+    this->empty_ticks.assign(2 * this->num_leaves, UINT32_MAX);
+
+    std::fill_n(this->empty_ticks.begin() + this->num_leaves, num_stations, 0);
+
+    for(size_t node = this->num_leaves - 1; node > 0; node--) {
+        this->empty_ticks[node] = std::min(this->empty_ticks[2 * node],
+                                           this->empty_ticks[2 * node + 1]);
+    }
+}
+
+/****************************************************************************************
+ * peek                                                                                 *
+ * @brief Retrieves the station the next arriving truck would be sent to.               *
+ *                                                                                      *
+ * Walks down from the root towards the smaller child, preferring the left one, so the  *
+ * lowest index wins among stations that ran empty at the same tick.                    *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: size_t - The index of the station.                                          *
+ ****************************************************************************************/
+size_t ShortestQueueSelector::peek() const {
+
+    size_t node = 1;
+
+    while(node < this->num_leaves) {
+        node = 2 * node + (this->empty_ticks[2 * node] > this->empty_ticks[2 * node + 1]);
+    }
+
+    return node - this->num_leaves;
+}
+
+/****************************************************************************************
+ * storage_bytes                                                                        *
+ * @brief Computes the memory the selector allocates from its memory resource.          *
+ *                                                                                      *
+ * @param num_stations: The number of stations to pick from.                            *
+ * @return: size_t - The bytes needed, including the worst case alignment padding.      *
+ ****************************************************************************************/
+size_t ShortestQueueSelector::storage_bytes(size_t num_stations) {
+    return 2 * std::bit_ceil(std::max<size_t>(num_stations, 1)) * sizeof(uint32_t) +
+           alignof(uint32_t);
+}
+
+/****************************************************************************************
+ * PowerOfTwoSelector Constructor                                                       *
+ * @brief Initializes the selector, `reset` sets it up for a number of stations.        *
+ *                                                                                      *
+ * @param memory: Unused, the selector stores nothing outside of itself.                *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+PowerOfTwoSelector::PowerOfTwoSelector(std::pmr::memory_resource*) : num_stations(1) {}
+
+/****************************************************************************************
+ * reset                                                                                *
+ * @brief Reseeds the selector's random number generator.                               *
+ *                                                                                      *
+ * @param num_stations: The number of stations to pick from.                            *
+ * @param seed: The seed of the generator.                                              *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void PowerOfTwoSelector::reset(size_t num_stations, uint32_t seed) {
+
+    this->gen.seed(seed);
+    this->num_stations = num_stations;
+}
+
+/****************************************************************************************
+ * ExpectedWaitTree Constructor                                                         *
+ * @brief Initializes the tree, `reset` sets it up for a row of trips.                  *
+ *                                                                                      *
+ * @param memory: The resource the tree is stored in.                                   *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+ExpectedWaitTree::ExpectedWaitTree(std::pmr::memory_resource* memory) : nodes(memory),
+                                                                        trip_keys(memory),
+                                                                        num_leaves(1) {}
+
+/****************************************************************************************
+ * reset                                                                                *
+ * @brief Sets up one leaf per station with an empty queue and nothing inbound.         *
+ *                                                                                      *
+ * Every station starts out trip bound, so the tree is built bottom up in O(S).         *
+ *                                                                                      *
+ * @param trips: The trip to each station in ticks, at most 65534.                      *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void ExpectedWaitTree::reset(std::span<const uint16_t> trips) {
+
+    this->num_leaves = std::bit_ceil(std::max<size_t>(trips.size(), 1));
+
+    /* Only grows the storage, and then to the exact size, see storage_bytes            */
+    this->nodes.assign(2 * this->num_leaves, Node{UINT64_MAX, UINT64_MAX, UINT32_MAX});
+    this->trip_keys.assign(this->num_leaves, UINT64_MAX);
+
+    for(size_t leaf = 0; leaf < trips.size(); leaf++) {
+
+        this->trip_keys[leaf] = (static_cast<uint64_t>(trips[leaf]) << 16) | trips[leaf];
+        this->nodes[this->num_leaves + leaf].trip = this->trip_keys[leaf];
+    }
+
+    for(size_t node = this->num_leaves - 1; node > 0; node--) {
+        this->pull(node);
+    }
+}
+
+/****************************************************************************************
+ * update                                                                               *
+ * @brief Records the queue and the inbound trucks of a station.                        *
+ *                                                                                      *
+ * @param leaf: The index of the station in the row of trips.                           *
+ * @param queue: The station's queue at `tick`, see `Station::get_queue`.               *
+ * @param inbound: The trucks on their way to the station.                              *
+ * @param tick: The number of ticks the simulation has run.                             *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void ExpectedWaitTree::update(size_t leaf, uint32_t queue, uint32_t inbound,
+                              uint32_t tick) {
+
+    size_t node = this->num_leaves + leaf;
+    uint64_t trip = this->trip_keys[leaf] & UINT16_MAX;
+
+    this->trip_keys[leaf] = ((trip + inbound) << 16) | trip;
+
+    /* The queue outlasts the trip until the tick it runs empty, minus the trip         */
+    if(queue > trip) {
+
+        uint64_t empty = static_cast<uint64_t>(tick) + queue;
+
+        this->nodes[node] = Node{UINT64_MAX, ((empty + inbound) << 16) | trip,
+                                 static_cast<uint32_t>(empty - trip)};
+    }
+    else {
+        this->nodes[node] = Node{this->trip_keys[leaf], UINT64_MAX, UINT32_MAX};
+    }
+
+    for(node /= 2; node > 0; node /= 2) {
+        this->pull(node);
+    }
+}
+
+/****************************************************************************************
+ * select                                                                               *
+ * @brief Picks the station a truck setting off now would be unloaded at soonest.       *
+ *                                                                                      *
+ * Walks down from the root towards the child with the smaller key, preferring the      *
+ * left one, once every station whose queue has shrunk below its trip is trip bound.    *
+ *                                                                                      *
+ * @param tick: The number of ticks the simulation has run, never less than at the      *
+ *              previous call.                                                          *
+ * @return: size_t - The index of the station in the row of trips.                      *
+ ****************************************************************************************/
+size_t ExpectedWaitTree::select(uint32_t tick) {
+
+    if(this->nodes[1].flip <= tick) {
+        this->flip_due(1, tick);
+    }
+
+    size_t node = 1;
+
+    while(node < this->num_leaves) {
+        node = 2 * node + (this->key(2 * node, tick) > this->key(2 * node + 1, tick));
+    }
+
+    return node - this->num_leaves;
+}
+
+/****************************************************************************************
+ * storage_bytes                                                                        *
+ * @brief Computes the memory the tree allocates from its memory resource.              *
+ *                                                                                      *
+ * @param num_leaves: The number of stations in the row of trips.                       *
+ * @return: size_t - The bytes needed, including the worst case alignment padding.      *
+ ****************************************************************************************/
+size_t ExpectedWaitTree::storage_bytes(size_t num_leaves) {
+
+    size_t leaves = std::bit_ceil(std::max<size_t>(num_leaves, 1));
+
+    return 2 * leaves * sizeof(Node) + alignof(Node) +
+           leaves * sizeof(uint64_t) + alignof(uint64_t);
+}
+
+/****************************************************************************************
+ * key                                                                                  *
+ * @brief Computes the key of a node at a tick.                                         *
+ *                                                                                      *
+ * Trip bound keys are stored without the tick, which every one of them moves on by.    *
+ *                                                                                      *
+ * @param node: The index of the node.                                                  *
+ * @param tick: The number of ticks the simulation has run.                             *
+ * @return: uint64_t - The smaller key of the two kinds, UINT64_MAX for no station.     *
+ ****************************************************************************************/
+uint64_t ExpectedWaitTree::key(size_t node, uint32_t tick) const {
+
+    const Node& entry = this->nodes[node];
+    uint64_t shift = static_cast<uint64_t>(tick) << 16;
+    uint64_t trip = (entry.trip == UINT64_MAX) ? UINT64_MAX : entry.trip + shift;
+
+    return std::min(trip, entry.queue);
+}
+
+/****************************************************************************************
+ * pull                                                                                 *
+ * @brief Recomputes a node from its children.                                          *
+ *                                                                                      *
+ * @param node: The index of the node.                                                  *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void ExpectedWaitTree::pull(size_t node) {
+
+    const Node& left = this->nodes[2 * node];
+    const Node& right = this->nodes[2 * node + 1];
+
+    this->nodes[node] = Node{std::min(left.trip, right.trip),
+                             std::min(left.queue, right.queue),
+                             std::min(left.flip, right.flip)};
+}
+
+/****************************************************************************************
+ * flip_due                                                                             *
+ * @brief Turns the queue bound stations below a node into trip bound ones once their   *
+ *        queue no longer outlasts the trip.                                            *
+ *                                                                                      *
+ * Only subtrees holding a station whose tick has come are visited.                     *
+ *                                                                                      *
+ * @param node: The index of the node.                                                  *
+ * @param tick: The number of ticks the simulation has run.                             *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void ExpectedWaitTree::flip_due(size_t node, uint32_t tick) {
+
+    if(node >= this->num_leaves) {
+        this->nodes[node] = Node{this->trip_keys[node - this->num_leaves], UINT64_MAX,
+                                 UINT32_MAX};
+        return;
+    }
+
+    for(size_t child = 2 * node; child <= 2 * node + 1; child++) {
+        if(this->nodes[child].flip <= tick) {
+            this->flip_due(child, tick);
+        }
+    }
+
+    this->pull(node);
+}
+
+/****************************************************************************************
+ * ShortestWaitSelector Constructor                                                     *
+ * @brief Initializes the selector, `reset` sets it up for a number of stations.        *
+ *                                                                                      *
+ * @param travel_time: The trip to every station in ticks, the site's travel time.      *
+ * @param memory: The resource the trips, empty ticks and tree are stored in.           *
+ * @param trips: Optional trip to each station in ticks. Empty for the same             *
+ *               `travel_time` to every station.                                        *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+ShortestWaitSelector::ShortestWaitSelector(uint16_t travel_time,
+                                           std::pmr::memory_resource* memory,
+                                           std::span<const uint16_t> trips)
+                                           : trips(trips.begin(), trips.end(), memory),
+                                             given(!trips.empty()),
+                                             travel_time(travel_time),
+                                             empty_ticks(memory),
+                                             tree(memory) {}
+
+/****************************************************************************************
+ * reset                                                                                *
+ * @brief Empties every queue, reusing the storage.                                     *
+ *                                                                                      *
+ * Every station starts out empty at tick 0, so each one is only its trip away.         *
+ *                                                                                      *
+ * @param num_stations: The number of stations to pick from.                            *
+ * @param seed: Unused, the policy is deterministic.                                    *
+ * @return: None                                                                        *
+ * @throws: std::invalid_argument if a row of trips was given for a different number    *
+ *          of stations.                                                                *
+ ****************************************************************************************/
+void ShortestWaitSelector::reset(size_t num_stations, uint32_t) {
+
+    if(!this->given) {
+        this->trips.assign(num_stations, this->travel_time);
+    }
+    else if(this->trips.size() != num_stations) {
+        throw std::invalid_argument("The row of trips does not match the number of "
+                                    "stations");
+    }
+
+    this->empty_ticks.assign(num_stations, 0);
+    this->tree.reset(this->trips);
+}
+
+/****************************************************************************************
+ * storage_bytes                                                                        *
+ * @brief Computes the memory the selector allocates from its memory resource.          *
+ *                                                                                      *
+ * @param num_stations: The number of stations to pick from.                            *
+ * @return: size_t - The bytes needed, including the worst case alignment padding.      *
+ ****************************************************************************************/
+size_t ShortestWaitSelector::storage_bytes(size_t num_stations) {
+    return num_stations * sizeof(uint16_t) + alignof(uint16_t) +
+           num_stations * sizeof(uint32_t) + alignof(uint32_t) +
+           ExpectedWaitTree::storage_bytes(num_stations);
+}
+
+/****************************************************************************************
+ * make_selector                                                                        *
+ * @brief Creates the selector of a policy.                                             *
+ *                                                                                      *
+ * @param policy: The selection policy.                                                 *
+ * @param memory: The resource the selector stores its state in.                        *
+ * @param travel_time: The site's travel time, the trip to every station.               *
+ * @return: StationSelector - The selector, `reset` has to be called before it is used. *
+ ****************************************************************************************/
+StationSelector make_selector(SelectionPolicy policy, std::pmr::memory_resource* memory,
+                              uint16_t travel_time) {
+
+    if(SelectionPolicy::ShortestQueue == policy) {
+        return ShortestQueueSelector(memory);
+    }
+    if(SelectionPolicy::PowerOfTwo == policy) {
+        return PowerOfTwoSelector(memory);
+    }
+    if(SelectionPolicy::ShortestWait == policy) {
+        return ShortestWaitSelector(travel_time, memory);
+    }
+    return RoundRobinSelector(memory);
+}
+
+/****************************************************************************************
+ * benchmark_selectors                                                                  *
+ * @brief Measures how long each policy takes to assign a truck, and how long the queues *
+ *        it sends trucks to are.                                                       *
+ *                                                                                      *
+ * Every tick SELECTION_LOAD trucks per station arrive and are assigned, then the tick  *
+ * moves on as in the tick loop, so the queues stay short and the cost measured is the  *
+ * cost of each policy rather than of the stations.                                     *
+ *                                                                                      *
+ * @param num_stations: The number of stations to pick from.                            *
+ * @param num_assignments: The number of trucks each policy assigns.                    *
+ * @return: SelectionReport - The metrics of every policy.                              *
+ ****************************************************************************************/
+SelectionReport benchmark_selectors(uint16_t num_stations, size_t num_assignments) {
+
+    SelectionReport report = {num_stations, {}, {}, {}, {}};
+    size_t arrivals = std::max<size_t>(num_stations * SELECTION_LOAD, 1);
+    uint32_t seed = std::random_device{}();
+
+    /* Assigns `num_assignments` trucks with one policy                                 */
+    auto run = [&](auto selector) {
+
+        std::vector<Station> stations(num_stations);
+        uint64_t queued = 0;
+        uint32_t tick = 0;
+
+        selector.reset(num_stations, seed);
+
+        auto start = std::chrono::steady_clock::now();
+
+        for(size_t assigned = 0; assigned < num_assignments; tick++) {
+
+            size_t batch = std::min(arrivals, num_assignments - assigned);
+
+            for(size_t i = 0; i < batch; i++) {
+
+                Station& station = stations[selector.select(stations, tick)];
+
+                queued += station.get_queue(tick);
+                station.increment_queue(tick);
+            }
+            assigned += batch;
+        }
+
+        std::chrono::duration<double, std::nano> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        return SelectorMetrics{elapsed.count() / num_assignments,
+                               static_cast<double>(queued) / num_assignments};
+    };
+
+    report.round_robin = run(RoundRobinSelector());
+    report.shortest_queue = run(ShortestQueueSelector());
+    report.power_of_two = run(PowerOfTwoSelector());
+    report.shortest_wait = run(ShortestWaitSelector(TRAVEL_TIME));
+
+    return report;
+}
+
+/****************************************************************************************
+ * log_selection_report                                                                 *
+ * @brief Outputs the result of `benchmark_selectors` to the console.                   *
+ *                                                                                      *
+ * @param report: The benchmark result to print.                                        *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void log_selection_report(const SelectionReport& report) {
+
+    /* Prints one policy's line                                                         */
+    auto log = [](const char* name, const SelectorMetrics& metrics) {
+        std::cout << name << ": " << metrics.assign_ns << " ns/assignment, "
+        << metrics.mean_queue << " trucks queued ahead on average" << std::endl;
+    };
+
+    std::cout << "Station selection over " << report.num_stations << " stations"
+    << std::endl;
+    log("Round robin", report.round_robin);
+    log("Shortest queue", report.shortest_queue);
+    log("Power of two choices", report.power_of_two);
+    log("Shortest expected wait", report.shortest_wait);
+    std::cout << std::endl;
+}
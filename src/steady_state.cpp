@@ -0,0 +1,286 @@
+#ifndef STEADY_STATE_HPP
+#include "../include/steady_state.hpp"
+#endif
+
+/****************************************************************************************
+ * SteadyStateDetector Constructor                                                      *
+ * @brief Initializes the detector for a fleet and a tolerance.                         *
+ *                                                                                      *
+ * @param num_trucks: The number of trucks in the simulation.                           *
+ * @param epsilon: The largest accepted half width of the 95% confidence interval,      *
+ *                 as a fraction (0.005 is +/- 0.5%).                                   *
+ * @param max_ticks: The tick limit, the simulation stops here even if it has not       *
+ *                   converged.                                                         *
+ * @param truncate: Optional simulation whose statistics are reset once the warm-up     *
+ *                  has been detected, nullptr to leave the statistics untouched.       *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+SteadyStateDetector::SteadyStateDetector(size_t num_trucks,
+                                         double epsilon,
+                                         size_t max_ticks,
+                                         Simulation* truncate) : counts{0, 0, 0, 0},
+                                                                 num_trucks(num_trucks),
+                                                                 epsilon(epsilon),
+                                                                 max_ticks(max_ticks),
+                                                                 ticks(0),
+                                                                 truncate(truncate),
+                                                                 truncated(0) {
+    for(auto& category : this->series) {
+        category.reserve(max_ticks);
+    }
+}
+
+/****************************************************************************************
+ * next_tick                                                                            *
+ * @brief Records the tick that just finished and decides whether to run another one.   *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: bool - False once the simulation has converged or hit the tick limit.       *
+ ****************************************************************************************/
+bool SteadyStateDetector::next_tick() {
+
+    /* Record the fraction of the fleet in each category during the tick that finished  */
+    if(this->ticks > 0) {
+        for(size_t i = 0; i < this->counts.size(); i++) {
+            this->series[i].push_back(this->counts[i] / this->num_trucks);
+            this->counts[i] = 0;
+        }
+    }
+
+    if(this->ticks >= this->max_ticks) {
+        return false;
+    }
+
+    /* Periodically check whether the confidence intervals are narrow enough            */
+    if((this->ticks > 0) && (this->ticks % STEADY_STATE_INTERVAL == 0)) {
+
+        SteadyStateReport report = this->get_report();
+
+        /* The warm-up is over once MSER-5 finds a minimum before the edge of the        *
+         * searched half, discard everything recorded so far                            */
+        size_t searched = (this->ticks / MSER_BATCH_SIZE / 2) * MSER_BATCH_SIZE;
+
+        if(this->truncate && !this->truncated && report.warmup_ticks &&
+           (report.warmup_ticks < searched)) {
+
+            this->truncate->reset_statistics();
+            this->truncated = this->ticks;
+        }
+        else if(report.converged) {
+            return false;
+        }
+    }
+
+    this->ticks++;
+
+    return true;
+}
+
+/****************************************************************************************
+ * get_report                                                                           *
+ * @brief Evaluates the recorded time series and reports the steady state estimate.     *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: SteadyStateReport - The warm-up, the steady state fractions and their       *
+ *          confidence intervals.                                                       *
+ ****************************************************************************************/
+SteadyStateReport SteadyStateDetector::get_report() {
+
+    SteadyStateReport report = {false, 0, this->truncated, this->series[0].size(), {}, {}};
+
+    /* The warm-up of the simulation is the longest warm-up of any category             */
+    for(auto& category : this->series) {
+        report.warmup_ticks = std::max(report.warmup_ticks, mser_warmup(category));
+    }
+
+    /* Only the ticks after both the warm-up and the reset count towards the estimate   */
+    size_t start = std::max(report.warmup_ticks, report.truncated_ticks);
+
+    /* Not enough ticks left to form the batches yet                                    */
+    size_t batch_size = (report.ticks_run - start) / STEADY_STATE_BATCHES;
+
+    if(batch_size < MSER_BATCH_SIZE) {
+        return report;
+    }
+
+    std::array<double, 4> mean;
+    std::array<double, 4> half_width;
+
+    for(size_t i = 0; i < this->series.size(); i++) {
+
+        const std::vector<double>& category = this->series[i];
+
+        /* Mean over everything after the warm-up                                       */
+        double sum = 0.0;
+
+        for(size_t t = start; t < category.size(); t++) {
+            sum += category[t];
+        }
+        mean[i] = sum / (category.size() - start);
+
+        /* Batch means over the most recent STEADY_STATE_BATCHES * batch_size ticks     */
+        size_t first = category.size() - STEADY_STATE_BATCHES * batch_size;
+        double batch_sum = 0.0;
+        double batch_sq_sum = 0.0;
+
+        for(size_t b = 0; b < STEADY_STATE_BATCHES; b++) {
+
+            double batch_mean = 0.0;
+
+            for(size_t t = 0; t < batch_size; t++) {
+                batch_mean += category[first + b * batch_size + t];
+            }
+            batch_mean /= batch_size;
+
+            batch_sum += batch_mean;
+            batch_sq_sum += batch_mean * batch_mean;
+        }
+
+        double grand_mean = batch_sum / STEADY_STATE_BATCHES;
+        double variance = (batch_sq_sum - STEADY_STATE_BATCHES * grand_mean * grand_mean) /
+                          (STEADY_STATE_BATCHES - 1);
+
+        half_width[i] = STEADY_STATE_T_VALUE *
+                        std::sqrt(std::max(variance, 0.0) / STEADY_STATE_BATCHES);
+    }
+
+    report.mean = StateFractions{mean[0], mean[1], mean[2], mean[3]};
+    report.half_width = StateFractions{half_width[0], half_width[1], half_width[2],
+                                       half_width[3]};
+    report.converged = std::all_of(half_width.begin(), half_width.end(), [this](double h) {
+        return h <= this->epsilon;
+    });
+
+    return report;
+}
+
+/****************************************************************************************
+ * mser_warmup                                                                          *
+ * @brief Estimates the warm-up of one category's time series using MSER-5.             *
+ *                                                                                      *
+ * The series is averaged into batches of MSER_BATCH_SIZE ticks, z_0 .. z_k-1. For      *
+ * every truncation point d the MSER statistic is                                       *
+ *                                                                                      *
+ *     MSER(d) = sum_{j >= d} (z_j - mean_d)^2 / (k - d)^2                              *
+ *                                                                                      *
+ * where mean_d is the mean of the batches from d onwards. Suffix sums of z and z^2     *
+ * give each MSER(d) in O(1), so the whole search is O(ticks). Only the first half of   *
+ * the series is searched, since a minimum past that point means the run is still too   *
+ * short to tell the transient apart from the steady state.                             *
+ *                                                                                      *
+ * @param series: The fraction of the fleet in the category at every tick.              *
+ * @return: size_t - The number of ticks to discard from the start of the series.       *
+ ****************************************************************************************/
+size_t SteadyStateDetector::mser_warmup(const std::vector<double>& series) {
+
+    size_t k = series.size() / MSER_BATCH_SIZE;
+
+    if(k < 2) {
+        return 0;
+    }
+
+    /* Average the series into batches                                                  */
+    std::vector<double> batches(k, 0.0);
+
+    for(size_t j = 0; j < k; j++) {
+        for(size_t t = 0; t < MSER_BATCH_SIZE; t++) {
+            batches[j] += series[j * MSER_BATCH_SIZE + t];
+        }
+        batches[j] /= MSER_BATCH_SIZE;
+    }
+
+    /* Walk the truncation point from the end, accumulating the suffix sums             */
+    double sum = 0.0;
+    double sq_sum = 0.0;
+    double best = std::numeric_limits<double>::max();
+    size_t best_d = 0;
+
+    for(size_t d = k; d-- > 0;) {
+
+        sum += batches[d];
+        sq_sum += batches[d] * batches[d];
+
+        if(d > k / 2) {
+            continue;
+        }
+
+        double n = static_cast<double>(k - d);
+        double mser = (sq_sum - sum * sum / n) / (n * n);
+
+        if(mser <= best) {
+            best = mser;
+            best_d = d;
+        }
+    }
+
+    return best_d * MSER_BATCH_SIZE;
+}
+
+/****************************************************************************************
+ * run_until_steady                                                                     *
+ * @brief Runs a simulation until its state fractions are at steady state +/- epsilon.  *
+ *                                                                                      *
+ * Afterwards the simulation's `total_time` is the number of ticks recorded after the   *
+ * warm-up, so its results can be logged as usual.                                      *
+ *                                                                                      *
+ * @param sim: The simulation to run.                                                   *
+ * @param epsilon: The largest accepted half width of the 95% confidence interval.      *
+ * @param max_ticks: The tick limit. Each category is recorded in 16 bits, so this is   *
+ *                   capped at 65535.                                                   *
+ * @return: SteadyStateReport - The warm-up, the steady state fractions and their       *
+ *          confidence intervals.                                                       *
+ ****************************************************************************************/
+SteadyStateReport run_until_steady(Simulation& sim, double epsilon, size_t max_ticks) {
+
+    /* Run through a specified warm-up first and discard what was recorded during it    */
+    if(sim.get_warmup_time()) {
+
+        FixedHorizon warmup(sim.get_warmup_time());
+
+        sim.simulate(warmup);
+        sim.reset_statistics();
+    }
+
+    /* Otherwise let the detector find the warm-up and reset the statistics after it    */
+    SteadyStateDetector detector(sim.trucks.size(),
+                                 epsilon,
+                                 std::min<size_t>(max_ticks, UINT16_MAX),
+                                 sim.get_warmup_time() ? nullptr : &sim);
+    sim.simulate(detector);
+
+    SteadyStateReport report = detector.get_report();
+    sim.total_time = static_cast<uint16_t>(report.ticks_run - report.truncated_ticks);
+
+    /* A specified warm-up was run and discarded before the detector started            */
+    report.warmup_ticks += sim.get_warmup_time();
+    report.truncated_ticks += sim.get_warmup_time();
+    report.ticks_run += sim.get_warmup_time();
+
+    return report;
+}
+
+/****************************************************************************************
+ * log_steady_state_report                                                              *
+ * @brief Outputs a steady state report to the console.                                 *
+ *                                                                                      *
+ * @param report: The report to print.                                                  *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void log_steady_state_report(const SteadyStateReport& report) {
+
+    std::cout << (report.converged ? "Reached steady state" : "Did not reach steady state")
+    << " after " << report.ticks_run << " ticks, warm-up: " << report.warmup_ticks
+    << " ticks, discarded: " << report.truncated_ticks << " ticks" << std::endl;
+
+    std::cout << "Waiting: " << report.mean.waiting * 100 << "% +/- "
+    << report.half_width.waiting * 100 << "%" << std::endl;
+
+    std::cout << "Unloading: " << report.mean.unloading * 100 << "% +/- "
+    << report.half_width.unloading * 100 << "%" << std::endl;
+
+    std::cout << "Traveling: " << report.mean.traveling * 100 << "% +/- "
+    << report.half_width.traveling * 100 << "%" << std::endl;
+
+    std::cout << "Mining: " << report.mean.mining * 100 << "% +/- "
+    << report.half_width.mining * 100 << "%" << std::endl << std::endl;
+}
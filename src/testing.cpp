@@ -1,7 +1,15 @@
+#ifndef MAIN_HPP
+#include "../include/main.hpp"
+#endif
+
 #ifndef TESTING_HPP
 #include "../include/testing.hpp"
 #endif
 
+#ifndef OUTAGES_HPP
+#include "../include/outages.hpp"
+#endif
+
 /********************************************************************************************
  * compare_idx_val_to_actual_min                                                            *
  * @brief Verifies that the station with the current index has the shortest queue           *
@@ -17,23 +25,25 @@
  *                  stations in the simulation.                                             *
  * @param curr_idx: A reference to the current index in the stations vector, which          *
  *                  is expected to point to the station with the shortest wait time.        *
+ * @param tick: The number of ticks the simulation has run, the queues are computed at it.  *
  * @return: None                                                                            *
  * @throws: std::runtime_error if the station at `curr_idx` does not have the               *
  *          shortest queue in the vector.                                                   *
  ********************************************************************************************/
-void compare_idx_val_to_actual_min(std::vector<Station>& stations, size_t& curr_idx) {
+void compare_idx_val_to_actual_min(std::pmr::vector<Station>& stations, size_t& curr_idx,
+                                   uint32_t tick) {
 
     /* Find the station with the shortest wait time                                         */
-    std::vector<Station>::iterator min = std::min_element(stations.begin(), stations.end(), 
-    [](Station& a, Station& b) {
-            return a.get_queue() < b.get_queue();
+    auto min = std::min_element(stations.begin(), stations.end(), 
+    [tick](Station& a, Station& b) {
+            return a.get_queue(tick) < b.get_queue(tick);
     });
 
     /* Compare the two values, if they are not equal log error info and throw an exception  */
-    if(min->get_queue() != stations[curr_idx].get_queue()) {
+    if(min->get_queue(tick) != stations[curr_idx].get_queue(tick)) {
         std::cerr << "The minimum queue is not selected. The selected station wait time is: " 
-        << stations[curr_idx].get_queue() << " while the shortest wait time is: " 
-        << min->get_queue() << std::endl;
+        << stations[curr_idx].get_queue(tick) << " while the shortest wait time is: " 
+        << min->get_queue(tick) << std::endl;
         
         throw std::runtime_error("The station with the shortest wait time was not found");
     }
@@ -77,4 +87,332 @@ void compare_total_time_to_max_time(Truck& truck, size_t max_time) {
 
         throw std::runtime_error("Truck time does not match simulation time");
     }
-}
\ No newline at end of file
+}
+/********************************************************************************************
+ * compare_allocations_to_zero                                                              *
+ * @brief Verifies that nothing was allocated through a counting resource.                  *
+ *                                                                                          *
+ * This function checks the counters of a `CountingResource` that sits below a set of       *
+ * arenas. If anything was allocated since the counters were last reset, it logs an error   *
+ * message and throws a `std::runtime_error` exception. This is done to verify that the     *
+ * arenas serve every allocation of a batch of simulations once they have warmed up.        *
+ *                                                                                          *
+ * @param counter: The resource whose counters are checked.                                 *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if any allocation reached the counting resource.             *
+ ********************************************************************************************/
+void compare_allocations_to_zero(const CountingResource& counter) {
+
+    /* Compare the count to zero, if it is not log error info and throw an exception        */
+    if(counter.get_allocations() != 0) {
+
+        std::cerr << "Memory was allocated after the arenas warmed up" << std::endl
+        << "Allocations: " << counter.get_allocations() << " Bytes: "
+        << counter.get_bytes() << std::endl;
+
+        throw std::runtime_error("Steady state allocation is not zero");
+    }
+}
+
+/********************************************************************************************
+ * compare_fleet_size_to_num_trucks                                                         *
+ * @brief Verifies that a cohort simulation accounts for every truck of its fleet.          *
+ *                                                                                          *
+ * This function compares the number of trucks in every cohort and station queue of a       *
+ * `CohortSimulation` to the size of its fleet. Cohorts only ever move trucks on, split     *
+ * or merge, so if the two differ, it logs an error message and throws a                    *
+ * `std::runtime_error` exception. This is done to verify that no split loses or makes      *
+ * up trucks.                                                                               *
+ *                                                                                          *
+ * @param counted: The number of trucks in every cohort and queue.                          *
+ * @param num_trucks: The number of trucks in the fleet.                                    *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if the counts differ.                                        *
+ ********************************************************************************************/
+void compare_fleet_size_to_num_trucks(uint64_t counted, uint64_t num_trucks) {
+
+    /* Compare the two values, if they are not equal log error info and throw an exception  */
+    if(counted != num_trucks) {
+
+        std::cerr << "The cohorts do not add up to the fleet" << std::endl
+        << "Counted: " << counted << " Fleet: " << num_trucks << std::endl;
+
+        throw std::runtime_error("Cohort trucks do not match the fleet size");
+    }
+}
+
+/********************************************************************************************
+ * compare_station_to_scan                                                                  *
+ * @brief Verifies that a topology simulation's trees pick the station a full scan of the   *
+ *        site's routes picks.                                                              *
+ *                                                                                          *
+ * This function compares the station a site's ExpectedWaitTree picked for a departing      *
+ * truck with the one found by scanning every route of the site. If the two differ, it      *
+ * logs an error message and throws a `std::runtime_error` exception. This is done to       *
+ * verify that the trees are kept up to date with the queues and inbound trucks.            *
+ *                                                                                          *
+ * @param chosen: The index of the station the tree picked.                                 *
+ * @param scanned: The index of the station the scan picked.                                *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if the stations differ.                                      *
+ ********************************************************************************************/
+void compare_station_to_scan(size_t chosen, size_t scanned) {
+
+    /* Compare the two values, if they are not equal log error info and throw an exception  */
+    if(chosen != scanned) {
+
+        std::cerr << "The tree did not pick the station a scan of the routes picks"
+        << std::endl << "Tree: " << chosen << " Scan: " << scanned << std::endl;
+
+        throw std::runtime_error("The tree and the scan picked different stations");
+    }
+}
+
+/********************************************************************************************
+ * compare_reset_run_to_fresh_run                                                           *
+ * @brief Verifies that a simulation reset to a seed reproduces a fresh simulation with     *
+ *        that seed.                                                                        *
+ *                                                                                          *
+ * This function runs a fresh `Simulation`, then runs a second one with another seed,       *
+ * resets it to the first seed and runs it again. If any truck of the two runs recorded     *
+ * a different time, it logs an error message and throws a `std::runtime_error`             *
+ * exception. This is done to verify that nothing the generator, the selector or the        *
+ * distribution keeps between draws survives a reset.                                       *
+ *                                                                                          *
+ * @param num_trucks: The number of trucks to be simulated.                                 *
+ * @param num_stations: The number of stations available in the simulation.                 *
+ * @param mining_time: The distribution of mining times of both simulations.                *
+ * @param seed: The seed of the fresh simulation and of the reset.                          *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if the two runs differ.                                      *
+ ********************************************************************************************/
+void compare_reset_run_to_fresh_run(uint16_t num_trucks, uint16_t num_stations,
+                                    const MiningTimeDistribution& mining_time,
+                                    uint32_t seed) {
+
+    Simulation fresh(num_trucks, num_stations, false, mining_time, seed);
+    fresh.simulate();
+
+    /* Leave the generator and the distribution mid-stream before resetting                 */
+    Simulation rerun(num_trucks, num_stations, false, mining_time, seed + 1);
+    rerun.simulate();
+    rerun.reset(seed, num_trucks, num_stations);
+    rerun.simulate();
+
+    /* Compare every truck, if any differs log error info and throw an exception            */
+    for(size_t i = 0; i < num_trucks; i++) {
+
+        if(fresh.trucks[i].get_total_time() != rerun.trucks[i].get_total_time()) {
+
+            std::cerr << "A reset simulation does not reproduce a fresh one" << std::endl
+            << "Truck: " << i << " Seed: " << seed << std::endl;
+
+            throw std::runtime_error("Reset run does not match fresh run");
+        }
+    }
+}
+
+/********************************************************************************************
+ * compare_outages_to_schedule                                                              *
+ * @brief Verifies that the maintenance windows take the stations down and bring them back  *
+ *        up on time, and that no truck loses or gains time to an outage.                   *
+ *                                                                                          *
+ * The first run has only the windows: the first half of the stations goes down for two     *
+ * hours, and every station for one hour in the middle of it, so the arriving trucks also   *
+ * have to wait at a station that is down. The second run adds random failures. Both are    *
+ * stepped one tick at a time. After each tick of the first run every station is compared   *
+ * to the windows, and after each tick of either run no truck may have started unloading    *
+ * at a station that is down. With the trucks rerouted, no truck may wait at a station      *
+ * that is down either while another station is up. If any of these fails, or a truck's     *
+ * time does not add up to the horizon, it logs an error message and throws a               *
+ * `std::runtime_error` exception.                                                          *
+ *                                                                                          *
+ * @param num_trucks: The number of trucks to be simulated.                                 *
+ * @param num_stations: The number of stations, the windows need at least two.              *
+ * @param policy: What the trucks queued at a station that goes down do.                    *
+ * @param seed: The seed of the simulations.                                                *
+ * @return: None                                                                            *
+ * @throws: std::runtime_error if a station is up or down outside of its windows, a truck   *
+ *          is at a station that is down, or a truck's recorded time does not match the     *
+ *          horizon.                                                                        *
+ ********************************************************************************************/
+void compare_outages_to_schedule(uint16_t num_trucks, uint16_t num_stations,
+                                 OutagePolicy policy, uint32_t seed) {
+
+    num_stations = std::max<uint16_t>(num_stations, 2);
+
+    std::vector<BayConfig> configs(num_stations, BayConfig{2, 1, 3});
+    OutageConfig outages = {{{0, static_cast<uint16_t>(num_stations / 2),
+                              ONE_HOUR, 3 * ONE_HOUR},
+                             {0, num_stations, 2 * ONE_HOUR, 3 * ONE_HOUR}},
+                            0.0, ONE_HOUR, FIVE_HOUR, policy, TRAVEL_TIME};
+
+    /* Steps a simulation to its horizon, checking the trucks and calling `check` with the  *
+     * tick that just ran after every tick                                                  */
+    auto step_through = [num_trucks, policy](OutageSimulation& sim, auto&& check) {
+
+        /* Whether each truck held a bay in the tick before                                 */
+        std::vector<bool> unloading(num_trucks, false);
+
+        while(sim.tick < sim.total_time) {
+
+            FixedHorizon step(1);
+            sim.simulate(step);
+
+            /* The outages of the tick that just ran were applied before its trucks ran     */
+            uint32_t tick = sim.tick - 1;
+
+            check(tick);
+
+            for(size_t i = 0; i < num_trucks; i++) {
+
+                TruckState state = sim.trucks[i].get_state();
+                size_t station_idx = sim.trucks[i].get_station_idx();
+
+                /* A truck keeps the bay it had when its station went down, but none gets   *
+                 * one at a station that is down, and none waits at one that is down when   *
+                 * it could have been rerouted to one that is up                            */
+                bool started = (TruckState::Unloading == state) && !unloading[i];
+                bool stranded = (TruckState::Waiting == state) &&
+                                (OutagePolicy::Reroute == policy) &&
+                                sim.availability.get_num_up();
+
+                /* Compare the truck to its station, if it is down log error info and throw *
+                 * an exception                                                             */
+                if((started || stranded) && !sim.is_up(station_idx)) {
+
+                    std::cerr << "A truck is at a station that is down" << std::endl
+                    << "Truck: " << i << " Station: " << station_idx << " Tick: " << tick
+                    << " Unloading: " << started << std::endl;
+
+                    throw std::runtime_error("Truck is at a station that is down");
+                }
+
+                unloading[i] = (TruckState::Unloading == state);
+            }
+        }
+
+        for(Truck& truck : sim.trucks) {
+            compare_total_time_to_max_time(truck, sim.total_time);
+        }
+    };
+
+    OutageSimulation scheduled(num_trucks, configs, outages, false, std::nullopt, seed);
+
+    step_through(scheduled, [&](uint32_t tick) {
+
+        for(uint16_t station_idx = 0; station_idx < num_stations; station_idx++) {
+
+            bool down = false;
+
+            for(const OutageWindow& window : outages.windows) {
+                down |= (station_idx >= window.first_station) &&
+                        (station_idx < window.last_station) &&
+                        (tick >= window.start) && (tick < window.end);
+            }
+
+            /* Compare the station to its windows, if they differ log error info and throw  *
+             * an exception                                                                 */
+            if(scheduled.is_up(station_idx) == down) {
+
+                std::cerr << "A station's availability does not match its windows"
+                << std::endl << "Station: " << station_idx << " Tick: " << tick
+                << " Up: " << scheduled.is_up(station_idx) << std::endl;
+
+                throw std::runtime_error("Station availability does not match windows");
+            }
+        }
+    });
+
+    /* Random failures on top of the windows, taken down wherever they strike               */
+    outages.failures_per_day = 4.0;
+
+    OutageSimulation failing(num_trucks, configs, outages, false, std::nullopt, seed);
+
+    step_through(failing, [](uint32_t) {});
+}
+
+/********************************************************************************************
+ * CountingResource Constructor                                                             *
+ * @brief Initializes the counters to zero.                                                 *
+ *                                                                                          *
+ * @param upstream: The resource the allocations are passed to.                             *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+CountingResource::CountingResource(std::pmr::memory_resource* upstream) : upstream(upstream),
+                                                                         allocations(0),
+                                                                         bytes(0) {}
+
+/********************************************************************************************
+ * get_allocations                                                                          *
+ * @brief Retrieves the number of allocations since construction or the last reset.         *
+ *                                                                                          *
+ * @param: None                                                                             *
+ * @return: size_t - The number of allocations.                                             *
+ ********************************************************************************************/
+size_t CountingResource::get_allocations() const {
+    return this->allocations.load(std::memory_order_relaxed);
+}
+
+/********************************************************************************************
+ * get_bytes                                                                                *
+ * @brief Retrieves the bytes allocated since construction or the last reset.               *
+ *                                                                                          *
+ * @param: None                                                                             *
+ * @return: size_t - The number of bytes.                                                   *
+ ********************************************************************************************/
+size_t CountingResource::get_bytes() const {
+    return this->bytes.load(std::memory_order_relaxed);
+}
+
+/********************************************************************************************
+ * reset                                                                                    *
+ * @brief Sets the counters back to zero, e.g. once the arenas have warmed up.              *
+ *                                                                                          *
+ * @param: None                                                                             *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+void CountingResource::reset() {
+    this->allocations.store(0, std::memory_order_relaxed);
+    this->bytes.store(0, std::memory_order_relaxed);
+}
+
+/********************************************************************************************
+ * do_allocate                                                                              *
+ * @brief Counts the allocation and passes it upstream.                                     *
+ *                                                                                          *
+ * @param bytes: The size of the allocation.                                                *
+ * @param alignment: The alignment of the allocation.                                       *
+ * @return: void* - The allocated memory.                                                   *
+ ********************************************************************************************/
+void* CountingResource::do_allocate(size_t bytes, size_t alignment) {
+
+    this->allocations.fetch_add(1, std::memory_order_relaxed);
+    this->bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+    return this->upstream->allocate(bytes, alignment);
+}
+
+/********************************************************************************************
+ * do_deallocate                                                                            *
+ * @brief Returns memory upstream.                                                          *
+ *                                                                                          *
+ * @param p: The memory to return.                                                          *
+ * @param bytes: The size of the allocation.                                                *
+ * @param alignment: The alignment of the allocation.                                       *
+ * @return: None                                                                            *
+ ********************************************************************************************/
+void CountingResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    this->upstream->deallocate(p, bytes, alignment);
+}
+
+/********************************************************************************************
+ * do_is_equal                                                                              *
+ * @brief Checks whether memory from one resource can be returned to the other.             *
+ *                                                                                          *
+ * @param other: The resource to compare against.                                           *
+ * @return: bool - True only for the same resource.                                         *
+ ********************************************************************************************/
+bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
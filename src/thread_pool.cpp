@@ -0,0 +1,450 @@
+#ifndef THREAD_POOL_HPP
+#include "../include/thread_pool.hpp"
+#endif
+
+#ifndef NUMA_HPP
+#include "../include/numa.hpp"
+#endif
+
+#include <chrono>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+thread_local const ThreadPool* ThreadPool::worker_owner = nullptr;
+thread_local size_t ThreadPool::worker_idx = 0;
+
+/****************************************************************************************
+ * steady_now_ns                                                                        *
+ * @brief Retrieves the steady clock time in nanoseconds, never 0 so that 0 can mark a  *
+ *        worker that is not idle.                                                      *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: int64_t - The current time in nanoseconds.                                  *
+ ****************************************************************************************/
+static int64_t steady_now_ns() {
+
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+
+    return std::max<int64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now).count(), 1);
+}
+
+/****************************************************************************************
+ * pin_to_cpu                                                                           *
+ * @brief Restricts the calling thread to a single CPU, if the platform supports it.    *
+ *                                                                                      *
+ * @param cpu: The index of the CPU, wrapped around the number of CPUs.                 *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+static void pin_to_cpu(size_t cpu) {
+
+    size_t num_cpus = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    cpu %= num_cpus;
+
+#if defined(__linux__)
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+#elif defined(_WIN32)
+    SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << (cpu % 64));
+#endif
+}
+
+/****************************************************************************************
+ * ThreadPool Constructor                                                               *
+ * @brief Starts the worker threads.                                                    *
+ *                                                                                      *
+ * @param num_workers: The number of worker threads, at least 1.                        *
+ * @param pin_workers: Whether to pin each worker to its own CPU.                       *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+ThreadPool::ThreadPool(size_t num_workers, bool pin_workers) : queued(0),
+                                                               stopping(false) {
+    num_workers = std::max<size_t>(num_workers, 1);
+
+    /* Create every deque before any worker starts stealing from them                   */
+    for(size_t i = 0; i < num_workers; i++) {
+        this->workers.push_back(std::make_unique<Worker>());
+    }
+
+    for(size_t i = 0; i < num_workers; i++) {
+        this->workers[i]->thread = std::thread(&ThreadPool::worker_loop, this, i,
+                                               pin_workers);
+    }
+}
+
+/****************************************************************************************
+ * ThreadPool Destructor                                                                *
+ * @brief Waits for the queued tasks to finish and stops the worker threads.            *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+ThreadPool::~ThreadPool() {
+
+    {
+        std::lock_guard<std::mutex> guard(this->sleep_lock);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+
+    for(auto& worker : this->workers) {
+        worker->thread.join();
+    }
+}
+
+/****************************************************************************************
+ * grain_size                                                                           *
+ * @brief Picks the task size for a loop over `num_items` trucks.                       *
+ *                                                                                      *
+ * Each worker gets TASKS_PER_WORKER tasks, so a worker that falls behind has spare     *
+ * tasks for the others to steal. Tasks are never smaller than MIN_TASK_SIZE trucks,    *
+ * below which queueing a task costs more than advancing the trucks in it, so small     *
+ * simulations end up as a single task on the calling thread.                           *
+ *                                                                                      *
+ * @param num_items: The number of indices in the loop.                                 *
+ * @return: size_t - The number of indices per task.                                    *
+ ****************************************************************************************/
+size_t ThreadPool::grain_size(size_t num_items) const {
+
+    size_t num_tasks = this->workers.size() * TASKS_PER_WORKER;
+
+    return std::max<size_t>((num_items + num_tasks - 1) / num_tasks, MIN_TASK_SIZE);
+}
+
+/****************************************************************************************
+ * size                                                                                 *
+ * @brief Retrieves the number of worker threads.                                       *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: size_t - The number of workers.                                             *
+ ****************************************************************************************/
+size_t ThreadPool::size() const {
+    return this->workers.size();
+}
+
+/****************************************************************************************
+ * get_metrics                                                                          *
+ * @brief Retrieves the counters of every worker.                                       *
+ *                                                                                      *
+ * The idle time includes the part of an idle period that is still ongoing, so a        *
+ * worker that has been asleep since the last loop does not report zero.                *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: std::vector<WorkerMetrics> - One entry per worker.                          *
+ ****************************************************************************************/
+std::vector<WorkerMetrics> ThreadPool::get_metrics() const {
+
+    std::vector<WorkerMetrics> metrics;
+    metrics.reserve(this->workers.size());
+
+    int64_t now = steady_now_ns();
+
+    for(auto& worker : this->workers) {
+        WorkerMetrics counters;
+
+        counters.tasks_run = worker->tasks_run.load(std::memory_order_relaxed);
+        counters.steals = worker->steals.load(std::memory_order_relaxed);
+        counters.failed_steals = worker->failed_steals.load(std::memory_order_relaxed);
+        counters.idle_us = worker->idle_ns.load(std::memory_order_relaxed) / 1000.0;
+
+        /* Add the idle period the worker is in right now, if any                       */
+        int64_t since = worker->idle_since.load(std::memory_order_relaxed);
+
+        if(since) {
+            counters.idle_us += std::max<int64_t>(now - since, 0) / 1000.0;
+        }
+
+        counters.node = worker->node.load(std::memory_order_relaxed);
+
+        metrics.push_back(counters);
+    }
+
+    return metrics;
+}
+
+/****************************************************************************************
+ * reset_metrics                                                                        *
+ * @brief Sets the counters of every worker back to zero.                               *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void ThreadPool::reset_metrics() {
+
+    int64_t now = steady_now_ns();
+
+    for(auto& worker : this->workers) {
+        worker->tasks_run.store(0, std::memory_order_relaxed);
+        worker->steals.store(0, std::memory_order_relaxed);
+        worker->failed_steals.store(0, std::memory_order_relaxed);
+        worker->idle_ns.store(0, std::memory_order_relaxed);
+
+        /* An ongoing idle period only counts from the reset onwards                    */
+        int64_t since = worker->idle_since.load(std::memory_order_relaxed);
+
+        while(since && !worker->idle_since.compare_exchange_weak(
+                            since, now, std::memory_order_relaxed)) {}
+    }
+}
+
+/****************************************************************************************
+ * submit                                                                               *
+ * @brief Queues a task on the calling worker's deque, or on the given worker's deque   *
+ *        when called from another thread, and wakes a sleeping worker.                 *
+ *                                                                                      *
+ * @param task: The task to queue.                                                      *
+ * @param target: The worker to queue the task on when called from another thread.      *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void ThreadPool::submit(const Task& task, size_t target) {
+
+    size_t self = this->current_worker();
+
+    if(self == this->workers.size()) {
+        self = target % this->workers.size();
+    }
+
+    /* Count the task first, so a worker that takes it never sees the count at zero.     *
+     * Taking the sleep lock orders the count against a worker about to go to sleep     */
+    {
+        std::lock_guard<std::mutex> guard(this->sleep_lock);
+        this->queued.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(this->workers[self]->lock);
+        this->workers[self]->tasks.push_back(task);
+    }
+    this->wake.notify_one();
+}
+
+/****************************************************************************************
+ * submit_pinned                                                                        *
+ * @brief Queues a task that only the given worker may run, and wakes it.               *
+ *                                                                                      *
+ * The sleeping workers all wait on the same condition variable, so every one of them   *
+ * is woken to make sure the target is among them. The others find nothing to run and   *
+ * go back to sleep.                                                                    *
+ *                                                                                      *
+ * @param task: The task to queue.                                                      *
+ * @param target: The worker that has to run the task.                                  *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void ThreadPool::submit_pinned(const Task& task, size_t target) {
+
+    Worker& worker = *this->workers[target % this->workers.size()];
+
+    /* Count the task under the sleep lock, like `submit`, so the target cannot miss it  */
+    {
+        std::lock_guard<std::mutex> guard(this->sleep_lock);
+        worker.num_pinned.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(worker.lock);
+        worker.pinned.push_back(task);
+    }
+    this->wake.notify_all();
+}
+
+/****************************************************************************************
+ * try_run                                                                              *
+ * @brief Runs one task, taken from the own deque if possible and stolen otherwise.     *
+ *                                                                                      *
+ * Workers first take the oldest of the tasks pinned to them, then the newest task from *
+ * the back of their own deque. Everyone else, and workers whose deques are empty, take *
+ * the oldest task from the front of the other deques, starting with the next worker    *
+ * along so thieves spread out. Pinned tasks are never stolen.                          *
+ *                                                                                      *
+ * @param self: The index of the calling worker, or `size()` for other threads.         *
+ * @return: bool - False if there was no task to run.                                   *
+ ****************************************************************************************/
+bool ThreadPool::try_run(size_t self) {
+
+    size_t num_workers = this->workers.size();
+    bool stolen = false;
+    Task task;
+
+    /* Tasks pinned to a worker run in the order they were queued, and only there       */
+    if(self < num_workers) {
+
+        Worker& worker = *this->workers[self];
+        bool pinned = false;
+
+        {
+            std::lock_guard<std::mutex> guard(worker.lock);
+
+            if(!worker.pinned.empty()) {
+                task = worker.pinned.front();
+                worker.pinned.pop_front();
+                pinned = true;
+            }
+        }
+
+        if(pinned) {
+            worker.num_pinned.fetch_sub(1, std::memory_order_relaxed);
+            task.run(task.context, task.first, task.last);
+            worker.tasks_run.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    auto take = [&task](Worker& worker, bool back) {
+
+        std::lock_guard<std::mutex> guard(worker.lock);
+
+        if(worker.tasks.empty()) {
+            return false;
+        }
+        if(back) {
+            task = worker.tasks.back();
+            worker.tasks.pop_back();
+        }
+        else {
+            task = worker.tasks.front();
+            worker.tasks.pop_front();
+        }
+        return true;
+    };
+
+    bool found = (self < num_workers) && take(*this->workers[self], true);
+
+    for(size_t i = 1; !found && (i <= num_workers); i++) {
+        size_t victim = (self + i) % num_workers;
+        found = (victim != self) && take(*this->workers[victim], false);
+        stolen = found;
+    }
+
+    if(!found) {
+        if(self < num_workers) {
+            this->workers[self]->failed_steals.fetch_add(1, std::memory_order_relaxed);
+        }
+        return false;
+    }
+
+    this->queued.fetch_sub(1, std::memory_order_relaxed);
+    task.run(task.context, task.first, task.last);
+
+    if(self < num_workers) {
+        this->workers[self]->tasks_run.fetch_add(1, std::memory_order_relaxed);
+        this->workers[self]->steals.fetch_add(stolen, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+/****************************************************************************************
+ * current_worker                                                                       *
+ * @brief Retrieves the index of the calling thread in this pool.                       *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: size_t - The index of the calling worker, or `size()` for other threads.    *
+ ****************************************************************************************/
+size_t ThreadPool::current_worker() const {
+    return (worker_owner == this) ? worker_idx : this->workers.size();
+}
+
+/****************************************************************************************
+ * worker_loop                                                                          *
+ * @brief Runs tasks on a worker thread until the pool is destroyed.                    *
+ *                                                                                      *
+ * A worker without a task keeps trying to steal for POOL_SPIN_COUNT rounds, which      *
+ * covers the short gaps between the ticks of a parallel simulation, before sleeping    *
+ * until a task is queued. The whole time without a task counts as idle time, and its   *
+ * start is published so `get_metrics` can count a period that has not ended yet.       *
+ *                                                                                      *
+ * @param self: The index of the worker.                                                *
+ * @param pin: Whether to pin the worker to the CPU of the same index.                  *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void ThreadPool::worker_loop(size_t self, bool pin) {
+
+    worker_owner = this;
+    worker_idx = self;
+
+    Worker& worker = *this->workers[self];
+
+    /* Pin before looking up the node, a pinned worker stays on it                      */
+    if(pin) {
+        pin_to_cpu(self);
+    }
+    worker.node.store(current_numa_node(), std::memory_order_relaxed);
+
+    while(true) {
+
+        if(this->try_run(self)) {
+            continue;
+        }
+
+        worker.idle_since.store(steady_now_ns(), std::memory_order_relaxed);
+        bool found = false;
+
+        for(size_t spin = 0; !found && (spin < POOL_SPIN_COUNT); spin++) {
+            std::this_thread::yield();
+            found = this->try_run(self);
+        }
+
+        bool stop = false;
+
+        if(!found) {
+
+            std::unique_lock<std::mutex> guard(this->sleep_lock);
+
+            auto pending = [this, &worker]() {
+                return this->queued.load(std::memory_order_relaxed) ||
+                       worker.num_pinned.load(std::memory_order_relaxed);
+            };
+
+            this->wake.wait(guard, [this, &pending]() {
+                return this->stopping || pending();
+            });
+
+            stop = this->stopping && !pending();
+        }
+
+        /* Close the idle period, a reset may have moved its start in the meantime      */
+        int64_t start = worker.idle_since.exchange(0, std::memory_order_relaxed);
+        worker.idle_ns.fetch_add(std::max<int64_t>(steady_now_ns() - start, 0),
+                                 std::memory_order_relaxed);
+
+        if(stop) {
+            return;
+        }
+    }
+}
+
+/****************************************************************************************
+ * log_pool_metrics                                                                     *
+ * @brief Outputs the counters of every worker of a pool to the console.                *
+ *                                                                                      *
+ * @param pool: The pool to report on.                                                  *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void log_pool_metrics(const ThreadPool& pool) {
+
+    WorkerMetrics total = {0, 0, 0, 0.0, 0};
+    std::vector<WorkerMetrics> metrics = pool.get_metrics();
+
+    for(size_t i = 0; i < metrics.size(); i++) {
+
+        std::cout << "Worker " << i << " (node " << metrics[i].node << "): "
+        << metrics[i].tasks_run << " tasks, "
+        << metrics[i].steals << " steals, " << metrics[i].failed_steals
+        << " failed steals, " << metrics[i].idle_us << "us idle" << std::endl;
+
+        total.tasks_run += metrics[i].tasks_run;
+        total.steals += metrics[i].steals;
+        total.failed_steals += metrics[i].failed_steals;
+        total.idle_us += metrics[i].idle_us;
+    }
+
+    std::cout << "Pool: " << total.tasks_run << " tasks, " << total.steals << " steals, "
+    << total.failed_steals << " failed steals, " << total.idle_us << "us idle"
+    << std::endl << std::endl;
+}
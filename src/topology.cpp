@@ -0,0 +1,435 @@
+#ifndef TOPOLOGY_HPP
+#include "../include/topology.hpp"
+#endif
+
+#include <sstream>
+
+/****************************************************************************************
+ * TravelTimes Constructor                                                              *
+ * @brief Builds the matrix from a list of routes, picking the dense or sparse layout.  *
+ *                                                                                      *
+ * The dense layout costs 2 bytes per pair and the sparse one 4 bytes per route, so     *
+ * matrices up to DENSE_TRAVEL_ENTRIES pairs, or with at least half of their pairs      *
+ * connected, are stored dense.                                                         *
+ *                                                                                      *
+ * @param num_mines: The number of mine sites.                                          *
+ * @param num_stations: The number of stations.                                         *
+ * @param routes: The travel time of every pair with a road between them.               *
+ * @return: None                                                                        *
+ * @throws: std::invalid_argument if a route is out of range, listed twice or takes 0   *
+ *          or NO_ROUTE ticks, or if a site cannot reach any station.                   *
+ ****************************************************************************************/
+TravelTimes::TravelTimes(uint16_t num_mines, uint16_t num_stations,
+                         const std::vector<TravelRoute>& routes)
+                         : num_mines(num_mines),
+                           num_stations(num_stations),
+                           dense(false) {
+
+    size_t num_pairs = static_cast<size_t>(num_mines) * num_stations;
+
+    if(num_pairs == 0) {
+        throw std::invalid_argument("A topology needs at least one site and one station");
+    }
+
+    /* Count the routes of each site, rejecting the invalid ones                        */
+    this->row_offsets.assign(num_mines + 1, 0);
+
+    for(const TravelRoute& route : routes) {
+
+        if((route.mine >= num_mines) || (route.station >= num_stations)) {
+            throw std::invalid_argument("A route refers to a missing site or station");
+        }
+        if((route.time == 0) || (route.time == NO_ROUTE)) {
+            throw std::invalid_argument("Travel times must be between 1 and 65534 ticks");
+        }
+        this->row_offsets[route.mine + 1]++;
+    }
+
+    for(uint16_t mine = 0; mine < num_mines; mine++) {
+
+        if(this->row_offsets[mine + 1] == 0) {
+            throw std::invalid_argument("A site cannot reach any station");
+        }
+        this->row_offsets[mine + 1] += this->row_offsets[mine];
+    }
+
+    this->dense = (num_pairs <= DENSE_TRAVEL_ENTRIES) || (2 * routes.size() >= num_pairs);
+
+    if(this->dense) {
+
+        this->times.assign(num_pairs, NO_ROUTE);
+
+        for(const TravelRoute& route : routes) {
+
+            uint16_t& time = this->times[static_cast<size_t>(route.mine) * num_stations +
+                                         route.station];
+            if(time != NO_ROUTE) {
+                throw std::invalid_argument("A route is listed twice");
+            }
+            time = route.time;
+        }
+
+        this->row_offsets.clear();
+        return;
+    }
+
+    /* Scatter the routes into their rows, then sort each row by station                */
+    std::vector<uint32_t> next(this->row_offsets.begin(), this->row_offsets.end() - 1);
+    std::vector<TravelRoute> sorted(routes.size());
+
+    for(const TravelRoute& route : routes) {
+        sorted[next[route.mine]++] = route;
+    }
+
+    this->columns.resize(routes.size());
+    this->times.resize(routes.size());
+
+    for(uint16_t mine = 0; mine < num_mines; mine++) {
+
+        auto first = sorted.begin() + this->row_offsets[mine];
+        auto last = sorted.begin() + this->row_offsets[mine + 1];
+
+        std::sort(first, last, [](const TravelRoute& lhs, const TravelRoute& rhs) {
+            return lhs.station < rhs.station;
+        });
+
+        for(auto route = first; route != last; route++) {
+
+            size_t i = route - sorted.begin();
+
+            if((route != first) && ((route - 1)->station == route->station)) {
+                throw std::invalid_argument("A route is listed twice");
+            }
+            this->columns[i] = route->station;
+            this->times[i] = route->time;
+        }
+    }
+}
+
+/****************************************************************************************
+ * get                                                                                  *
+ * @brief Retrieves the travel time between a mine site and a station.                  *
+ *                                                                                      *
+ * Sparse rows are sorted by station, so the lookup is a binary search of the row.      *
+ *                                                                                      *
+ * @param mine: The index of the mine site.                                             *
+ * @param station: The index of the station.                                            *
+ * @return: uint16_t - The travel time in ticks, NO_ROUTE if there is no road.          *
+ ****************************************************************************************/
+uint16_t TravelTimes::get(uint16_t mine, size_t station) const {
+
+    if(this->dense) {
+        return this->times[static_cast<size_t>(mine) * this->num_stations + station];
+    }
+
+    auto first = this->columns.begin() + this->row_offsets[mine];
+    auto last = this->columns.begin() + this->row_offsets[mine + 1];
+    auto found = std::lower_bound(first, last, station);
+
+    if((found == last) || (*found != station)) {
+        return NO_ROUTE;
+    }
+    return this->times[found - this->columns.begin()];
+}
+
+/****************************************************************************************
+ * get_num_mines                                                                        *
+ * @brief Retrieves the number of mine sites.                                           *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: uint16_t - The number of mine sites.                                        *
+ ****************************************************************************************/
+uint16_t TravelTimes::get_num_mines() const {
+    return this->num_mines;
+}
+
+/****************************************************************************************
+ * get_num_stations                                                                     *
+ * @brief Retrieves the number of stations.                                             *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: uint16_t - The number of stations.                                          *
+ ****************************************************************************************/
+uint16_t TravelTimes::get_num_stations() const {
+    return this->num_stations;
+}
+
+/****************************************************************************************
+ * is_dense                                                                             *
+ * @brief Retrieves the layout picked for the matrix.                                   *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: bool - True if stored dense, false if stored as compressed sparse rows.     *
+ ****************************************************************************************/
+bool TravelTimes::is_dense() const {
+    return this->dense;
+}
+
+/****************************************************************************************
+ * TopologySimulation Constructor                                                       *
+ * @brief Initializes a simulation of the given fleet over the sites and stations of    *
+ *        a travel time matrix.                                                         *
+ *                                                                                      *
+ * Truck i works at site i % M, so the fleet is spread evenly over the sites. Every     *
+ * truck starts out mining with a freshly drawn mining time.                            *
+ *                                                                                      *
+ * @param num_trucks: The number of trucks to be simulated.                             *
+ * @param travel_times: The travel times between the sites and the stations, moved into *
+ *                      the simulation.                                                 *
+ * @param debug: Optional parameter that enables debug mode if set to true.             *
+ * @param mining_time: Optional distribution of mining times, defaults to the uniform   *
+ *                     distribution between the site's mining time bounds.              *
+ * @param seed: Optional seed of the simulation's random number generator.              *
+ * @param memory: Optional resource the trucks and stations are stored in.              *
+ * @param site: Optional site the simulation runs at, defaults to the standard site.    *
+ *              Its travel time is replaced by the travel time matrix.                  *
+ * @return: None                                                                        *
+ * @throws: std::invalid_argument if the site is invalid.                               *
+ ****************************************************************************************/
+TopologySimulation::TopologySimulation(uint16_t num_trucks,
+                                       TravelTimes travel_times,
+                                       bool debug,
+                                       std::optional<MiningTimeDistribution> mining_time,
+                                       uint32_t seed,
+                                       std::pmr::memory_resource* memory,
+                                       const SiteConfig& site)
+                                       : total_time(site.max_time),
+                                         debug(debug),
+                                         travel_times(std::move(travel_times)),
+                                         stations(this->travel_times.get_num_stations(),
+                                                  memory),
+                                         inbound(this->travel_times.get_num_stations(), 0,
+                                                 memory),
+                                         trucks(memory),
+                                         mining_time(mining_time
+                                                     ? std::move(*mining_time)
+                                                     : site_mining_time(site)),
+                                         gen(seed),
+                                         site(site),
+                                         transitions(make_routed_transitions(site)),
+                                         tick(0),
+                                         trees(memory),
+                                         leaf_offsets(memory),
+                                         leaf_stations(memory),
+                                         station_offsets(memory),
+                                         station_leaves(memory),
+                                         station_mines(memory) {
+
+    validate_site(site);
+
+    uint16_t num_mines = this->travel_times.get_num_mines();
+    uint16_t num_stations = this->travel_times.get_num_stations();
+
+    /* Lay out the leaves of every site in route order, counting the routes per station */
+    std::vector<uint16_t> trips;
+
+    this->leaf_offsets.push_back(0);
+    this->station_offsets.assign(num_stations + 1, 0);
+    this->trees.reserve(num_mines);
+
+    for(uint16_t mine = 0; mine < num_mines; mine++) {
+
+        trips.clear();
+
+        this->travel_times.for_each_route(mine, [&](size_t station, uint16_t time) {
+            this->leaf_stations.push_back(static_cast<uint16_t>(station));
+            this->station_offsets[station + 1]++;
+            trips.push_back(time);
+        });
+
+        this->leaf_offsets.push_back(static_cast<uint32_t>(this->leaf_stations.size()));
+        this->trees.emplace_back(memory);
+        this->trees.back().reset(trips);
+    }
+
+    /* Then file every leaf under its station                                           */
+    for(uint16_t station = 0; station < num_stations; station++) {
+        this->station_offsets[station + 1] += this->station_offsets[station];
+    }
+
+    std::vector<uint32_t> next(this->station_offsets.begin(),
+                               this->station_offsets.end() - 1);
+
+    this->station_leaves.resize(this->leaf_stations.size());
+    this->station_mines.resize(this->leaf_stations.size());
+
+    for(uint16_t mine = 0; mine < num_mines; mine++) {
+        for(uint32_t leaf = this->leaf_offsets[mine]; leaf < this->leaf_offsets[mine + 1];
+            leaf++) {
+
+            uint32_t slot = next[this->leaf_stations[leaf]]++;
+
+            this->station_leaves[slot] = leaf;
+            this->station_mines[slot] = mine;
+        }
+    }
+
+    this->trucks.reserve(num_trucks);
+
+    std::visit([this, num_trucks](auto& dist) {
+        for(uint16_t i = 0; i < num_trucks; i++) {
+            this->trucks.emplace_back(dist(this->gen),
+                                      i % this->travel_times.get_num_mines());
+        }
+    }, this->mining_time);
+}
+
+/****************************************************************************************
+ * simulate                                                                             *
+ * @brief Runs the tick loop for `total_time` ticks.                                    *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void TopologySimulation::simulate() {
+
+    FixedHorizon horizon(this->total_time);
+
+    this->simulate(horizon);
+}
+
+/****************************************************************************************
+ * choose_station                                                                       *
+ * @brief Picks the station a truck leaving a mine site would be unloaded at soonest.   *
+ *                                                                                      *
+ * The trucks queued at a station are unloaded while the truck travels, so a station    *
+ * whose queue is shorter than the trip costs only the trip. Trucks already heading to  *
+ * a station are assumed to get there first, each adding a tick. The station finishing  *
+ * the truck soonest wins, ties go to the shorter trip, then to the lower index. The    *
+ * site's ExpectedWaitTree finds it in O(log S).                                        *
+ *                                                                                      *
+ * @param mine: The index of the mine site the truck leaves from.                       *
+ * @return: size_t - The index of the station.                                          *
+ ****************************************************************************************/
+size_t TopologySimulation::choose_station(uint16_t mine) {
+
+    size_t leaf = this->trees[mine].select(this->tick);
+
+    return this->leaf_stations[this->leaf_offsets[mine] + leaf];
+}
+
+/****************************************************************************************
+ * scan_station                                                                         *
+ * @brief Picks the same station as `choose_station` by scanning every route of the     *
+ *        site, used to check the trees in debug mode.                                  *
+ *                                                                                      *
+ * @param mine: The index of the mine site the truck leaves from.                       *
+ * @return: size_t - The index of the station.                                          *
+ ****************************************************************************************/
+size_t TopologySimulation::scan_station(uint16_t mine) {
+
+    size_t best = 0;
+    uint32_t best_ready = UINT32_MAX;
+    uint16_t best_time = NO_ROUTE;
+
+    this->travel_times.for_each_route(mine, [&](size_t station, uint16_t time) {
+
+        uint16_t queue = this->stations[station].get_queue(this->tick);
+        uint32_t ready = std::max<uint32_t>(time, queue) + this->inbound[station];
+
+        if((ready < best_ready) || ((ready == best_ready) && (time < best_time))) {
+            best = station;
+            best_ready = ready;
+            best_time = time;
+        }
+    });
+
+    return best;
+}
+
+/****************************************************************************************
+ * update_station                                                                       *
+ * @brief Records the queue and inbound trucks of a station in the tree of every site   *
+ *        that reaches it.                                                              *
+ *                                                                                      *
+ * @param station: The index of the station.                                            *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void TopologySimulation::update_station(size_t station) {
+
+    uint16_t queue = this->stations[station].get_queue(this->tick);
+
+    for(uint32_t i = this->station_offsets[station]; i < this->station_offsets[station + 1];
+        i++) {
+
+        uint16_t mine = this->station_mines[i];
+
+        this->trees[mine].update(this->station_leaves[i] - this->leaf_offsets[mine], queue,
+                                 this->inbound[station], this->tick);
+    }
+}
+
+/****************************************************************************************
+ * logging                                                                              *
+ * @brief Outputs the statistics of every truck and station to the console.             *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: None                                                                        *
+ ****************************************************************************************/
+void TopologySimulation::logging() {
+
+    select_checks(this->debug, [this](auto checks) {
+        for(auto& truck : this->trucks) {
+
+            truck.logging(this->total_time);
+
+            checks.check_total_time(truck, this->total_time);
+        }
+    });
+    for(auto& station : this->stations) {
+        station.logging();
+    }
+}
+
+/****************************************************************************************
+ * get_state_fractions                                                                  *
+ * @brief Computes the fraction of time the fleet spent in each category.               *
+ *                                                                                      *
+ * @param: None                                                                         *
+ * @return: StateFractions - The fleet-wide fraction of time spent in each category.    *
+ ****************************************************************************************/
+StateFractions TopologySimulation::get_state_fractions() {
+    return fleet_state_fractions(this->trucks, this->total_time);
+}
+
+/****************************************************************************************
+ * read_travel_times                                                                    *
+ * @brief Reads a travel time matrix from a stream of routes.                           *
+ *                                                                                      *
+ * @param input: The stream to read from.                                               *
+ * @param num_mines: The number of mine sites.                                          *
+ * @param num_stations: The number of stations.                                         *
+ * @return: TravelTimes - The matrix of the routes read.                                *
+ * @throws: std::runtime_error if a line is not a route.                                *
+ * @throws: std::invalid_argument if the routes do not form a valid matrix.             *
+ ****************************************************************************************/
+TravelTimes read_travel_times(std::istream& input, uint16_t num_mines,
+                              uint16_t num_stations) {
+
+    std::vector<TravelRoute> routes;
+    std::string line;
+
+    while(std::getline(input, line)) {
+
+        if(line.empty() || (line[0] == '#')) {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        uint32_t mine;
+        uint32_t station;
+        uint32_t time;
+        std::string rest;
+
+        if(!(fields >> mine >> station >> time) || (fields >> rest) ||
+           (mine > UINT16_MAX) || (station > UINT16_MAX) || (time > UINT16_MAX)) {
+            throw std::runtime_error("Invalid route: " + line);
+        }
+
+        routes.push_back(TravelRoute{static_cast<uint16_t>(mine),
+                                     static_cast<uint16_t>(station),
+                                     static_cast<uint16_t>(time)});
+    }
+
+    return TravelTimes(num_mines, num_stations, routes);
+}